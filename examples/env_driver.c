@@ -0,0 +1,89 @@
+/* Ví dụ dùng lib2048env.so từ C: chạy một lô ván với nước đi ngẫu nhiên trên bộ nhớ của người gọi. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "env2048.h"
+
+static uint64_t nextRandom(uint64_t* state) {
+    /* xorshift64 */
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? (size_t)atol(argv[1]) : 1024;
+    int steps = argc > 2 ? atoi(argv[2]) : 1000;
+    size_t i;
+    int s;
+
+    if (env2048_abi_version() != ENV2048_ABI_VERSION) {
+        fprintf(stderr, "ABI mismatch: library %d, header %d\n", env2048_abi_version(), ENV2048_ABI_VERSION);
+        return 1;
+    }
+
+    uint64_t* boards = malloc(count * sizeof(uint64_t));
+    int32_t* scores = malloc(count * sizeof(int32_t));
+    int32_t* rewards = malloc(count * sizeof(int32_t));
+    uint8_t* dones = malloc(count * sizeof(uint8_t));
+    int32_t* actions = malloc(count * sizeof(int32_t));
+    uint64_t* seeds = malloc(count * sizeof(uint64_t));
+    if (!boards || !scores || !rewards || !dones || !actions || !seeds) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    Env2048* env = env2048_create_with_buffers(count, boards, scores, rewards, dones);
+    if (!env) {
+        fprintf(stderr, "env2048_create_with_buffers failed\n");
+        return 1;
+    }
+    for (i = 0; i < count; i++) seeds[i] = 1000 + i;
+    env2048_reset(env, seeds);
+
+    uint64_t random = 0x2048;
+    long long totalReward = 0;
+    long long finished = 0;
+    long long finalScores = 0;
+    int32_t bestTile = 0;
+    clock_t begin = clock();
+    for (s = 0; s < steps; s++) {
+        for (i = 0; i < count; i++) actions[i] = (int32_t)(nextRandom(&random) & 3);
+        if (env2048_step(env, actions) != 0) {
+            fprintf(stderr, "env2048_step rejected some actions\n");
+            return 1;
+        }
+        /* Đọc thẳng từ bộ nhớ của mình, không cần sao chép */
+        for (i = 0; i < count; i++) {
+            totalReward += rewards[i];
+            if (dones[i]) {
+                int32_t values[16];
+                int c;
+                finished++;
+                finalScores += scores[i];
+                env2048_decode(boards[i], values);
+                for (c = 0; c < 16; c++) {
+                    if (values[c] > bestTile) bestTile = values[c];
+                }
+            }
+        }
+    }
+    double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+    printf("%lu lanes x %d steps in %.3f s (%.2f Msteps/s)\n", (unsigned long)count, steps, seconds,
+           seconds > 0 ? count * (double)steps / seconds / 1e6 : 0.0);
+    printf("total reward %lld, games finished %lld, mean final score %.1f, best tile %d\n", totalReward, finished,
+           finished ? (double)finalScores / finished : 0.0, bestTile);
+
+    env2048_destroy(env);
+    free(boards);
+    free(scores);
+    free(rewards);
+    free(dones);
+    free(actions);
+    free(seeds);
+    return 0;
+}
@@ -0,0 +1,88 @@
+/* Ví dụ đọc trạng thái game trực tiếp từ vùng nhớ chia sẻ (game chạy với --live-shm NAME).
+ * In bàn cờ mỗi khi có nước đi mới, kèm độ trễ từ lúc game công bố tới lúc đọc được.
+ * Dùng: live2048-reader [NAME] [--once] */
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "live2048.h"
+
+static uint64_t nowNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static void printBoard(uint64_t board) {
+    int row, col;
+    for (row = 0; row < 4; row++) {
+        for (col = 0; col < 4; col++) {
+            int exponent = (int)((board >> (4 * (row * 4 + col))) & 0xF);
+            printf("%6d", exponent ? 1 << exponent : 0);
+        }
+        printf("\n");
+    }
+}
+
+static void printSnapshot(const Live2048Snapshot* s) {
+    printf("pid %u  moves %llu  score %d%s", s->writerPid, (unsigned long long)s->moves, s->score,
+           (s->flags & LIVE2048_GAME_OVER) ? " (game over)" : "");
+    if (s->flags & LIVE2048_MULTIPLAYER) {
+        printf("  score2 %d%s", s->score2, (s->flags & LIVE2048_GAME_OVER2) ? " (game over)" : "");
+    }
+    printf("%s  age %.1f us\n", (s->flags & LIVE2048_IN_MENU) ? "  [menu]" : "", (nowNs() - s->updateNs) / 1000.0);
+    printBoard(s->board);
+    if (s->flags & LIVE2048_MULTIPLAYER) {
+        printf("--\n");
+        printBoard(s->board2);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    const char* name = LIVE2048_DEFAULT_NAME;
+    int once = 0;
+    int i;
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--once") == 0) {
+            once = 1;
+        } else {
+            name = argv[i];
+        }
+    }
+
+    /* Chỉ đọc: người đọc seqlock không bao giờ ghi vào segment */
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open shared memory %s (is the game running with --live-shm?)\n", name);
+        return 1;
+    }
+    const Live2048Segment* segment = mmap(NULL, sizeof(Live2048Segment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        fprintf(stderr, "Cannot map shared memory %s\n", name);
+        return 1;
+    }
+    if (__atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) != LIVE2048_MAGIC || segment->version != LIVE2048_VERSION) {
+        fprintf(stderr, "%s is not a version %d live 2048 segment\n", name, LIVE2048_VERSION);
+        return 1;
+    }
+
+    uint32_t seen = 0xFFFFFFFFu;
+    Live2048Snapshot snapshot;
+    struct timespec pause = {0, 1000000};
+    for (;;) {
+        uint32_t version = live2048_version(segment);
+        if (version != seen && live2048_read(segment, &snapshot, 1000)) {
+            seen = version;
+            printSnapshot(&snapshot);
+            if (once) break;
+        }
+        nanosleep(&pause, NULL);  /* bot thật có thể spin trên live2048_version thay cho ngủ */
+    }
+    munmap((void*)segment, sizeof(Live2048Segment));
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "AdversarialSpawner.h"
+#include "Expectimax.h"
+
+namespace {
+    // Người chơi hết nước: thấp hơn mọi giá trị heuristic, thua sớm hơn còn thấp hơn nữa
+    const float DEAD_VALUE = -1.0e9f;
+    const float DEAD_DEPTH_STEP = 1.0e6f;
+    const uint64_t TIME_CHECK_MASK = 255;
+    const int MAX_SPAWNS = 2 * Engine::CELL_COUNT;
+}
+
+int AdversarialSpawner::generateSpawns(Engine::Board afterstate, Spawn* spawns) {
+    int count = 0;
+    uint64_t empties = Engine::zeroNibbles(afterstate);
+    while (empties) {
+        uint64_t bit = empties & (~empties + 1);
+        empties &= empties - 1;
+        int cell = __builtin_ctzll(bit) / 4;
+        for (int exponent = 1; exponent <= 2; exponent++) {
+            Spawn spawn;
+            spawn.board = afterstate | bit * (uint64_t)exponent;
+            spawn.cell = cell;
+            spawn.exponent = exponent;
+            spawn.order = ExpectimaxAdvisor::heuristic(spawn.board);
+            // Sắp xếp chèn: tối đa 32 phần tử
+            int i = count++;
+            while (i > 0 && spawns[i - 1].order > spawn.order) {
+                spawns[i] = spawns[i - 1];
+                i--;
+            }
+            spawns[i] = spawn;
+        }
+    }
+    return count;
+}
+
+bool AdversarialSpawner::timeUp() {
+    if ((++timeChecks & TIME_CHECK_MASK) == 0 && std::chrono::steady_clock::now() >= deadline) aborted = true;
+    return aborted;
+}
+
+float AdversarialSpawner::minNode(Engine::Board afterstate, int depth, float alpha, float beta) {
+    nodes++;
+    if (depth <= 0) return ExpectimaxAdvisor::heuristic(afterstate);
+    Spawn spawns[MAX_SPAWNS];
+    int count = generateSpawns(afterstate, spawns);
+    float best = beta;
+    for (int i = 0; i < count; i++) {
+        float value = maxNode(spawns[i].board, depth, alpha, best);
+        if (aborted) return best;
+        if (value < best) best = value;
+        if (best <= alpha) break;
+    }
+    return best;
+}
+
+float AdversarialSpawner::maxNode(Engine::Board board, int depth, float alpha, float beta) {
+    nodes++;
+    if (timeUp()) return alpha;
+
+    // Sắp xếp 4 nước đi giảm dần theo heuristic của afterstate
+    Engine::Board moved[Engine::MOVE_COUNT];
+    float order[Engine::MOVE_COUNT];
+    int count = 0;
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        Engine::Board afterstate = Engine::move(board, m);
+        if (afterstate == board) continue;
+        float value = ExpectimaxAdvisor::heuristic(afterstate);
+        int i = count++;
+        while (i > 0 && order[i - 1] < value) {
+            moved[i] = moved[i - 1];
+            order[i] = order[i - 1];
+            i--;
+        }
+        moved[i] = afterstate;
+        order[i] = value;
+    }
+    if (count == 0) return DEAD_VALUE - DEAD_DEPTH_STEP * depth;
+
+    float best = alpha;
+    for (int i = 0; i < count; i++) {
+        float value = minNode(moved[i], depth - 1, best, beta);
+        if (aborted) return best;
+        if (value > best) best = value;
+        if (best >= beta) break;
+    }
+    return best;
+}
+
+bool AdversarialSpawner::choose(Engine::Board afterstate, double budgetMs, int maxDepth, int& cell, int& exponent) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Spawn spawns[MAX_SPAWNS];
+    int count = generateSpawns(afterstate, spawns);
+    if (count == 0) return false;
+
+    if (maxDepth < 1) maxDepth = 1;
+    if (maxDepth > MAX_DEPTH) maxDepth = MAX_DEPTH;
+    nodes = 0;
+    timeChecks = 0;
+    depthReached = 0;
+    aborted = false;
+    // Độ sâu 1 không bị ngắt để luôn có kết quả
+    deadline = std::chrono::steady_clock::time_point::max();
+
+    const float INFINITE_VALUE = 3.0e38f;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        float values[MAX_SPAWNS];
+        float best = INFINITE_VALUE;
+        for (int i = 0; i < count && !aborted; i++) {
+            values[i] = maxNode(spawns[i].board, depth, -INFINITE_VALUE, best);
+            if (values[i] < best) best = values[i];
+        }
+        if (aborted) break;
+
+        // Sắp lại gốc theo giá trị vừa tính: nhánh tốt nhất được tìm trước ở vòng sau
+        for (int i = 1; i < count; i++) {
+            Spawn spawn = spawns[i];
+            float value = values[i];
+            int j = i;
+            while (j > 0 && values[j - 1] > value) {
+                spawns[j] = spawns[j - 1];
+                values[j] = values[j - 1];
+                j--;
+            }
+            spawns[j] = spawn;
+            values[j] = value;
+        }
+        depthReached = depth;
+        if (values[0] <= DEAD_VALUE) break;  // đã tìm được cách ép thua, không cần sâu hơn
+
+        deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(budgetMs));
+        if (std::chrono::steady_clock::now() >= deadline) break;
+    }
+
+    cell = spawns[0].cell;
+    exponent = spawns[0].exponent;
+    elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
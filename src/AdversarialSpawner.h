@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include "Engine.h"
+
+// Chế độ khó: chọn ô mới (vị trí và 2/4) tệ nhất cho người chơi bằng minimax độ sâu
+// giới hạn, người chơi là nút max, người sinh ô là nút min, lá dùng heuristic của
+// ExpectimaxAdvisor. Alpha-beta với sắp xếp nước đi (heuristic tĩnh, nước tốt nhất của
+// vòng trước lên đầu) và đào sâu dần tới khi hết ngân sách thời gian; vòng bị ngắt giữa
+// chừng bị bỏ. Mọi trạng thái nằm trên stack nên gọi được trong vùng không cấp phát.
+class AdversarialSpawner {
+public:
+    static const int MAX_DEPTH = 12;
+
+    AdversarialSpawner() : depthReached(0), nodes(0), timeChecks(0), elapsedMs(0.0), aborted(false) {}
+
+    // afterstate: bàn cờ sau nước đi của người chơi. Trả về false nếu không còn ô trống.
+    // maxDepth: số nước đi của người chơi được nhìn trước tối đa; độ sâu 1 luôn được giải xong
+    bool choose(Engine::Board afterstate, double budgetMs, int maxDepth, int& cell, int& exponent);
+
+    int lastDepth() const { return depthReached; }
+    uint64_t lastNodes() const { return nodes; }
+    double lastMs() const { return elapsedMs; }
+
+private:
+    struct Spawn {
+        Engine::Board board;
+        int cell;
+        int exponent;
+        float order;
+    };
+
+    // Sinh mọi ô mới, sắp xếp tăng dần theo heuristic (tệ nhất cho người chơi trước)
+    static int generateSpawns(Engine::Board afterstate, Spawn* spawns);
+
+    float minNode(Engine::Board afterstate, int depth, float alpha, float beta);
+    float maxNode(Engine::Board board, int depth, float alpha, float beta);
+    bool timeUp();
+
+    std::chrono::steady_clock::time_point deadline;
+    int depthReached;
+    uint64_t nodes;
+    uint64_t timeChecks;
+    double elapsedMs;
+    bool aborted;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Engine.h"
+
+// Chiến lược chọn nước đi cho gợi ý (hint) và tự chơi (autoplay)
+class Advisor {
+public:
+    virtual ~Advisor() {}
+    virtual const char* name() const = 0;
+    // Trả về Engine::Move tốt nhất, hoặc -1 nếu không còn nước đi hợp lệ
+    virtual int chooseMove(Engine::Board board) = 0;
+    // Giá trị ước lượng của nước vừa chọn (để hiển thị), 0 nếu không có
+    virtual double lastValue() const { return 0.0; }
+};
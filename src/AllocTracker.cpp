@@ -0,0 +1,246 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace {
+    struct AtomicCounts {
+        std::atomic<uint64_t> allocs;
+        std::atomic<uint64_t> bytes;
+
+        void add(size_t size) {
+            allocs.fetch_add(1, std::memory_order_relaxed);
+            bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+
+        AllocTracker::Counts load() const {
+            AllocTracker::Counts c = {allocs.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed)};
+            return c;
+        }
+
+        void reset() {
+            allocs.store(0, std::memory_order_relaxed);
+            bytes.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    AtomicCounts totalCounts;
+    AtomicCounts frameCounts;
+    AtomicCounts moveCounts;
+    AtomicCounts scopeCounts[AllocTracker::MAX_SCOPES];
+    const char* scopeNames[AllocTracker::MAX_SCOPES];
+    std::atomic<int> scopeCount(0);
+    std::mutex scopeMutex;
+
+    AllocTracker::Counts lastFrameCounts = {0, 0};
+    AllocTracker::Counts lastMoveCounts = {0, 0};
+    std::atomic<bool> moveActive(false);
+    std::atomic<bool> assertEnabled(false);
+    std::atomic<uint64_t> violationCount(0);
+    std::atomic<uint64_t> allocFreeEntryCount(0);
+
+    thread_local int currentScope = -1;
+    thread_local const char* currentAllocFreeSection = nullptr;
+
+    int findOrRegisterScope(const char* name) {
+        int count = scopeCount.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) {
+            if (scopeNames[i] == name || std::strcmp(scopeNames[i], name) == 0) return i;
+        }
+
+        std::lock_guard<std::mutex> lock(scopeMutex);
+        count = scopeCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) {
+            if (std::strcmp(scopeNames[i], name) == 0) return i;
+        }
+        if (count >= AllocTracker::MAX_SCOPES) return -1;
+        scopeNames[count] = name;
+        scopeCounts[count].reset();
+        scopeCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+#ifdef TRACK_ALLOCS
+    void recordAllocation(size_t size) {
+        totalCounts.add(size);
+        frameCounts.add(size);
+        if (moveActive.load(std::memory_order_relaxed)) moveCounts.add(size);
+        if (currentScope >= 0) scopeCounts[currentScope].add(size);
+
+        if (currentAllocFreeSection) {
+            violationCount.fetch_add(1, std::memory_order_relaxed);
+            if (assertEnabled.load(std::memory_order_relaxed)) {
+                // Không dùng iostream ở đây vì có thể cấp phát lại
+                std::fputs("AllocTracker: allocation inside allocation-free section '", stderr);
+                std::fputs(currentAllocFreeSection, stderr);
+                std::fputs("'\n", stderr);
+                std::abort();
+            }
+        }
+    }
+
+    void* trackedAlloc(size_t size) {
+        if (size == 0) size = 1;
+        for (;;) {
+            void* p = std::malloc(size);
+            if (p) {
+                recordAllocation(size);
+                return p;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+#endif
+}
+
+#ifdef TRACK_ALLOCS
+void* operator new(size_t size) {
+    return trackedAlloc(size);
+}
+
+void* operator new[](size_t size) {
+    return trackedAlloc(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return trackedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return trackedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+#endif
+
+namespace AllocTracker {
+    bool isCompiledIn() {
+#ifdef TRACK_ALLOCS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    Counts total() {
+        return totalCounts.load();
+    }
+
+    void beginFrame() {
+        lastFrameCounts = frameCounts.load();
+        frameCounts.reset();
+    }
+
+    Counts lastFrame() {
+        return lastFrameCounts;
+    }
+
+    Counts currentFrame() {
+        return frameCounts.load();
+    }
+
+    void beginMove() {
+        moveCounts.reset();
+        moveActive.store(true, std::memory_order_relaxed);
+    }
+
+    void endMove() {
+        moveActive.store(false, std::memory_order_relaxed);
+        lastMoveCounts = moveCounts.load();
+    }
+
+    Counts lastMove() {
+        return lastMoveCounts;
+    }
+
+    int scopeStats(ScopeStats* out, int maxCount) {
+        int count = scopeCount.load(std::memory_order_acquire);
+        if (count > maxCount) count = maxCount;
+        for (int i = 0; i < count; i++) {
+            out[i].name = scopeNames[i];
+            out[i].counts = scopeCounts[i].load();
+        }
+        return count;
+    }
+
+    void resetScopes() {
+        int count = scopeCount.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) {
+            scopeCounts[i].reset();
+        }
+    }
+
+    void setAssertMode(bool enabled) {
+        assertEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool assertMode() {
+        return assertEnabled.load(std::memory_order_relaxed);
+    }
+
+    uint64_t violations() {
+        return violationCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t allocFreeEntries() {
+        return allocFreeEntryCount.load(std::memory_order_relaxed);
+    }
+
+    void printReport(std::ostream& out) {
+        Counts t = total();
+        out << "Allocation report: " << t.allocs << " allocations, " << t.bytes << " bytes" << std::endl;
+        ScopeStats stats[MAX_SCOPES];
+        int count = scopeStats(stats, MAX_SCOPES);
+        for (int i = 0; i < count; i++) {
+            out << "  " << stats[i].name << ": " << stats[i].counts.allocs << " allocations, "
+                << stats[i].counts.bytes << " bytes" << std::endl;
+        }
+        out << "  allocation-free violations: " << violations() << " in " << allocFreeEntries()
+            << " section entries" << std::endl;
+    }
+
+    Scope::Scope(const char* name) : previous(currentScope) {
+        int index = findOrRegisterScope(name);
+        if (index >= 0) currentScope = index;
+    }
+
+    Scope::~Scope() {
+        currentScope = previous;
+    }
+
+    AllocFreeSection::AllocFreeSection(const char* name) : previous(currentAllocFreeSection) {
+        currentAllocFreeSection = name;
+        allocFreeEntryCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    AllocFreeSection::~AllocFreeSection() {
+        currentAllocFreeSection = previous;
+    }
+}
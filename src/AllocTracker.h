@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Đếm cấp phát bộ nhớ (opt-in): build với `make TRACK_ALLOCS=1` để thay thế
+// operator new/delete toàn cục. Khi không bật, các macro bên dưới không sinh code
+// và mọi bộ đếm luôn bằng 0.
+namespace AllocTracker {
+    struct Counts {
+        uint64_t allocs;
+        uint64_t bytes;
+    };
+
+    struct ScopeStats {
+        const char* name;
+        Counts counts;
+    };
+
+    const int MAX_SCOPES = 32;
+
+    // true nếu hook cấp phát được biên dịch vào chương trình
+    bool isCompiledIn();
+
+    // Tổng số cấp phát từ đầu chương trình (mọi thread)
+    Counts total();
+
+    // Bộ đếm theo frame: beginFrame() chốt frame trước và bắt đầu frame mới
+    void beginFrame();
+    Counts lastFrame();
+    Counts currentFrame();
+
+    // Bộ đếm theo nước đi
+    void beginMove();
+    void endMove();
+    Counts lastMove();
+
+    // Thống kê theo scope (tên là string literal), trả về số scope đã ghi vào out
+    int scopeStats(ScopeStats* out, int maxCount);
+    void resetScopes();
+
+    // Chế độ assert: cấp phát trong vùng "allocation-free" sẽ abort() chương trình.
+    // Khi tắt, vi phạm chỉ được đếm lại.
+    void setAssertMode(bool enabled);
+    bool assertMode();
+    uint64_t violations();
+    // Số lần đã vào một vùng allocation-free: kiểm tra 0 vi phạm chỉ có nghĩa khi > 0
+    uint64_t allocFreeEntries();
+
+    void printReport(std::ostream& out);
+
+    // Gán các cấp phát trong phạm vi hiện tại cho một scope có tên
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+    private:
+        int previous;
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+    };
+
+    // Đánh dấu một đoạn code không được phép cấp phát
+    class AllocFreeSection {
+    public:
+        explicit AllocFreeSection(const char* name);
+        ~AllocFreeSection();
+    private:
+        const char* previous;
+        AllocFreeSection(const AllocFreeSection&);
+        AllocFreeSection& operator=(const AllocFreeSection&);
+    };
+}
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+#ifdef TRACK_ALLOCS
+#define ALLOC_SCOPE(name) AllocTracker::Scope ALLOC_CONCAT(allocScope_, __LINE__)(name)
+#define ALLOC_FREE_SECTION(name) AllocTracker::AllocFreeSection ALLOC_CONCAT(allocFree_, __LINE__)(name)
+#else
+#define ALLOC_SCOPE(name) ((void)0)
+#define ALLOC_FREE_SECTION(name) ((void)0)
+#endif
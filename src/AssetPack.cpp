@@ -0,0 +1,105 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    const char PACK_MAGIC[8] = {'2', '0', '4', '8', 'P', 'A', 'K', '1'};
+    const uint32_t PACK_VERSION = 1;
+    // Mỗi asset bắt đầu ở ranh giới trang: đọc một asset không kéo theo trang của asset khác
+    const uint64_t PACK_ALIGN = 4096;
+
+    bool nameBefore(const AssetPack::Entry& entry, const std::string& name) {
+        return std::strncmp(entry.name, name.c_str(), sizeof(entry.name)) < 0;
+    }
+}
+
+bool AssetPack::map(const std::string& path) {
+    entries = nullptr;
+    if (!file.map(path)) return false;
+    const FileHeader* header = static_cast<const FileHeader*>(file.data());
+    bool valid = file.size() >= sizeof(FileHeader) && std::memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0 &&
+                 header->version == PACK_VERSION && header->entrySize == sizeof(Entry) &&
+                 file.size() >= sizeof(FileHeader) + header->entryCount * sizeof(Entry);
+    const Entry* table = reinterpret_cast<const Entry*>(static_cast<const char*>(file.data()) + sizeof(FileHeader));
+    for (uint64_t i = 0; valid && i < header->entryCount; i++) {
+        valid = table[i].name[sizeof(table[i].name) - 1] == '\0' && table[i].offset <= file.size() &&
+                table[i].size <= file.size() - table[i].offset;
+    }
+    if (!valid) {
+        std::cerr << path << " is not an asset pack" << std::endl;
+        file.unmap();
+        return false;
+    }
+    entries = table;
+    entryCount = header->entryCount;
+    return true;
+}
+
+const void* AssetPack::find(const std::string& name, size_t& bytes) const {
+    if (!entries) return nullptr;
+    const Entry* end = entries + entryCount;
+    const Entry* entry = std::lower_bound(entries, end, name, nameBefore);
+    if (entry == end || name != entry->name) return nullptr;
+    bytes = (size_t)entry->size;
+    return static_cast<const char*>(file.data()) + entry->offset;
+}
+
+bool AssetPack::write(const std::string& path, std::vector<std::string> files) {
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    std::vector<Entry> table(files.size());
+    std::vector<std::string> contents(files.size());
+    uint64_t offset = sizeof(FileHeader) + files.size() * sizeof(Entry);
+    for (size_t i = 0; i < files.size(); i++) {
+        if (files[i].size() >= sizeof(table[i].name)) {
+            std::cerr << "Asset name too long for the pack: " << files[i] << std::endl;
+            return false;
+        }
+        std::ifstream in(files[i].c_str(), std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot read " << files[i] << std::endl;
+            return false;
+        }
+        contents[i].assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        offset = (offset + PACK_ALIGN - 1) / PACK_ALIGN * PACK_ALIGN;
+        std::memset(&table[i], 0, sizeof(Entry));
+        std::memcpy(table[i].name, files[i].c_str(), files[i].size());
+        table[i].offset = offset;
+        table[i].size = contents[i].size();
+        offset += contents[i].size();
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.entrySize = sizeof(Entry);
+    header.entryCount = table.size();
+
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Cannot write " << temporary << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(Entry));
+    uint64_t position = sizeof(FileHeader) + table.size() * sizeof(Entry);
+    for (size_t i = 0; i < table.size(); i++) {
+        out.write(std::string(table[i].offset - position, '\0').data(), table[i].offset - position);
+        out.write(contents[i].data(), contents[i].size());
+        position = table[i].offset + table[i].size;
+    }
+    out.close();
+    if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error while writing " << path << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
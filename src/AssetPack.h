@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// Gói asset: mọi font/âm thanh game dùng trong một file, bảng mục lục sắp theo tên ở đầu
+// file rồi tới dữ liệu. File được mmap chỉ đọc và asset được đưa thẳng cho SDL qua
+// SDL_RWFromConstMem, nên khởi động chỉ mở một file và mỗi font chỉ được đọc một lần
+// dù mở ở nhiều cỡ chữ.
+class AssetPack {
+public:
+    struct Entry {
+        char name[56];        // đường dẫn gốc, ví dụ "assets/fonts/ClearSans-Bold.ttf"
+        uint64_t offset;      // tính từ đầu file
+        uint64_t size;
+    };
+
+    AssetPack() : entries(nullptr), entryCount(0) {}
+
+    bool map(const std::string& path);
+    bool isReady() const { return entries != nullptr; }
+    size_t size() const { return entryCount; }
+    const Entry& at(size_t index) const { return entries[index]; }
+
+    // Dữ liệu của asset trong vùng mmap, nullptr nếu pack không có
+    const void* find(const std::string& name, size_t& bytes) const;
+
+    // Đọc các file (theo đường dẫn tương đối, cũng là tên trong pack) và ghi ra pack
+    static bool write(const std::string& path, std::vector<std::string> files);
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entrySize;
+        uint64_t entryCount;
+    };
+
+    MappedFile file;
+    const Entry* entries;
+    uint64_t entryCount;
+};
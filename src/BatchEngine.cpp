@@ -0,0 +1,93 @@
+#include "BatchEngine.h"
+#include "EngineSimd.h"
+
+BatchEngine::BatchEngine(size_t laneCount)
+    : ownedBoards(laneCount, 0), ownedScores(laneCount, 0), ownedRewards(laneCount, 0),
+      ownedDones(laneCount, 0), ownedRngStates(laneCount, 0), steps(0), finished(0) {
+    lanes.count = laneCount;
+    lanes.boards = ownedBoards.data();
+    lanes.scores = ownedScores.data();
+    lanes.rewards = ownedRewards.data();
+    lanes.dones = ownedDones.data();
+    lanes.rngStates = ownedRngStates.data();
+    bind();
+}
+
+BatchEngine::BatchEngine(const Lanes& external) : lanes(external), steps(0), finished(0) {
+    bind();
+}
+
+void BatchEngine::bind() {
+    moveBuffer.assign(lanes.count, Engine::MOVE_LEFT);
+    movedBuffer.assign(lanes.count, 0);
+    deltaBuffer.assign(lanes.count, 0);
+}
+
+void BatchEngine::reset(uint64_t seed) {
+    Engine::Rng seeder(seed);
+    for (size_t i = 0; i < lanes.count; i++) {
+        lanes.rngStates[i] = seeder.next();
+        resetLane(i);
+    }
+    steps = 0;
+    finished = 0;
+}
+
+void BatchEngine::reset(const uint64_t* seeds) {
+    for (size_t i = 0; i < lanes.count; i++) {
+        lanes.rngStates[i] = seeds[i];
+        resetLane(i);
+    }
+    steps = 0;
+    finished = 0;
+}
+
+void BatchEngine::resetLane(size_t lane) {
+    // Ván mới có 2 ô như initializeNewGame
+    Engine::Rng rng(lanes.rngStates[lane]);
+    Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+    lanes.rngStates[lane] = rng.state;
+    lanes.boards[lane] = board;
+    lanes.scores[lane] = 0;
+    lanes.rewards[lane] = 0;
+    lanes.dones[lane] = 0;
+}
+
+size_t BatchEngine::step(const int* moves) {
+    size_t count = lanes.count;
+    // Kernel chỉ nhận [0, 3]: nước ngoài khoảng được ép về đó rồi bỏ kết quả ở dưới
+    for (size_t i = 0; i < count; i++) {
+        moveBuffer[i] = moves[i] & 3;
+    }
+    EngineSimd::moveMany(lanes.boards, moveBuffer.data(), movedBuffer.data(), deltaBuffer.data(), count);
+
+    size_t invalid = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (lanes.dones[i]) {
+            resetLane(i);
+            continue;
+        }
+        Engine::Board board = lanes.boards[i];
+        Engine::Board moved = movedBuffer[i];
+        if (moves[i] != moveBuffer[i]) {
+            invalid++;
+            moved = board;
+        }
+        if (moved == board) {
+            lanes.rewards[i] = 0;
+            continue;
+        }
+        Engine::Rng rng(lanes.rngStates[i]);
+        board = Engine::spawnRandom(moved, rng);
+        lanes.rngStates[i] = rng.state;
+        lanes.boards[i] = board;
+        lanes.scores[i] += deltaBuffer[i];
+        lanes.rewards[i] = deltaBuffer[i];
+        if (!Engine::canMove(board)) {
+            lanes.dones[i] = 1;
+            finished++;
+        }
+    }
+    steps += count;
+    return invalid;
+}
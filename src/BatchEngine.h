@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Engine.h"
+
+// Mô phỏng N ván độc lập cùng lúc, dữ liệu dạng struct-of-arrays: mỗi trường là một
+// mảng liền theo lane. Chỉ nước đi chạy qua kernel SIMD (EngineSimd::moveMany); sinh ô
+// mới, cộng điểm và kiểm tra hết nước (Engine::canMove) chạy vô hướng từng lane. Sinh
+// ô cần RNG riêng và chọn ô trống thứ k, còn canMove thoát ngay khi có ô trống nên
+// kiểm tra SIMD cho cả lô chậm hơn (đo bằng 2048-batch).
+// Lane kết thúc (done = 1) được giữ nguyên một bước để người gọi đọc kết quả,
+// rồi tự reset ở lần step() kế tiếp (nước đi của lane đó bị bỏ qua).
+class BatchEngine {
+public:
+    // Bộ nhớ do người gọi cấp (zero-copy); mọi mảng có count phần tử
+    struct Lanes {
+        size_t count;
+        Engine::Board* boards;
+        int32_t* scores;
+        int32_t* rewards;
+        uint8_t* dones;
+        uint64_t* rngStates;
+    };
+
+    // Tự cấp phát bộ nhớ cho laneCount lane
+    explicit BatchEngine(size_t laneCount);
+    // Dùng bộ nhớ ngoài; chỉ cấp phát vùng đệm nội bộ một lần ở đây
+    explicit BatchEngine(const Lanes& external);
+
+    // Reset mọi lane; seed của lane i suy ra từ seed chung
+    void reset(uint64_t seed);
+    // Reset mọi lane với seed riêng từng lane
+    void reset(const uint64_t* seeds);
+    void resetLane(size_t lane);
+
+    // moves[i] là Engine::Move của lane i. Nước đi không làm thay đổi bàn cờ cho
+    // reward 0 và không sinh ô mới (giống Game2048); nước ngoài [0, 3] cũng vậy.
+    // Trả về số lane có nước ngoài khoảng (không tính lane đang reset)
+    size_t step(const int* moves);
+
+    size_t size() const { return lanes.count; }
+    const Engine::Board* boards() const { return lanes.boards; }
+    const int32_t* scores() const { return lanes.scores; }
+    const int32_t* rewards() const { return lanes.rewards; }
+    const uint8_t* dones() const { return lanes.dones; }
+
+    uint64_t stepCount() const { return steps; }
+    uint64_t gamesFinished() const { return finished; }
+
+private:
+    void bind();
+
+    Lanes lanes;
+    std::vector<Engine::Board> ownedBoards;
+    std::vector<int32_t> ownedScores;
+    std::vector<int32_t> ownedRewards;
+    std::vector<uint8_t> ownedDones;
+    std::vector<uint64_t> ownedRngStates;
+
+    // Vùng đệm cho moveMany, cấp phát một lần
+    std::vector<int> moveBuffer;
+    std::vector<Engine::Board> movedBuffer;
+    std::vector<int> deltaBuffer;
+
+    uint64_t steps;
+    uint64_t finished;
+};
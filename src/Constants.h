@@ -8,6 +8,8 @@ const int WINDOW_HEIGHT = 600;  // Giảm từ 800 xuống 600
 
 // Grid dimensions
 const int GRID_SIZE = 4;
+// Ô lớn nhất: hai ô 32768 không gộp, giống Engine (số mũ 4 bit, Engine::MAX_EXPONENT = 15)
+const int MAX_TILE = 32768;
 const int CELL_SIZE = 90;  // Tăng từ 70 lên 90
 const int CELL_MARGIN = 8;  // Tăng từ 6 lên 8
 const int BOARD_MARGIN = 20;  // Tăng từ 15 lên 20
@@ -33,6 +35,73 @@ const float MERGE_SCALE = 1.0f;
 const float SHAKE_AMPLITUDE = 0.0f;
 const float NEW_TILE_SCALE = 1.0f;
 
+// Headless constants
+const unsigned int HEADLESS_DEFAULT_SEED = 2048;
+const int HEADLESS_WARMUP_MOVES = 12;
+const int TITLE_FALLBACK_HEIGHT = 55;
+
+// Soak test constants
+const int SOAK_DEFAULT_INPUT_HZ = 30;
+const int SOAK_DEFAULT_INTERVAL_SECONDS = 10;
+const int SOAK_SCREEN_SWITCH_SECONDS = 60;
+const int SOAK_WARMUP_SAMPLES = 3;
+const int SOAK_GROWTH_WINDOW = 6;
+const long SOAK_RSS_GROWTH_KB = 1024;
+const double SOAK_FRAME_DRIFT_RATIO = 0.25;
+
+// Advisor constants
+const double ADVISOR_DEFAULT_MS = 20.0;
+const int ADVISOR_HUD_X = 10;
+const int ADVISOR_HUD_Y = 60;
+
+// Hard mode constants (ô mới tệ nhất, phải xong trong một frame 16 ms)
+const double HARD_SPAWN_DEFAULT_MS = 4.0;     // trần ngân sách mỗi lần sinh ô (--hard-ms)
+const int HARD_SPAWN_MAX_DEPTH = 8;
+const double FRAME_BUDGET_MS = 16.0;          // một frame ở ~60 FPS
+const double HARD_SPAWN_RENDER_RESERVE_MS = 4.0;  // phần frame chừa lại cho render sau khi sinh ô
+const double HARD_SPAWN_MIN_MS = 0.25;        // frame đã trễ: gần như chỉ giải độ sâu 1
+
+// CPU opponent constants (người chơi 2 do máy điều khiển)
+const double CPU_DEFAULT_MOVE_MS = 50.0;
+const int CPU_DEFAULT_PACE_MS = 250;
+
+// Replay viewer constants
+const int REPLAY_STEP_MS = 150;
+const int REPLAY_MIN_STEP_MS = 10;
+const int REPLAY_MAX_STEP_MS = 2000;
+const int REPLAY_JUMP_MOVES = 100;
+const int REPLAY_TEXT_Y = 30;
+const int REPLAY_BOARD_Y = 100;
+const int REPLAY_BAR_X = 40;
+const int REPLAY_BAR_Y = WINDOW_HEIGHT - 50;
+const int REPLAY_BAR_HEIGHT = 12;
+
+// Session capture constants
+const uint32_t SESSION_FRAME_MS = 16;   // bước thời gian ảo mỗi frame khi phát nhanh
+const size_t SESSION_FRAME_SLACK = 1024;
+
+// Network play constants
+const uint32_t NET_HASH_INTERVAL = 16;    // cứ 16 nước gửi một hash bàn cờ để phát hiện lệch
+
+// Replay export constants
+const int TILE_TEXT_CACHE_SIZE = 18;      // texture số trên ô được cache tới 2^17
+const uint32_t EXPORT_CHUNK_FRAMES = 64;  // mỗi luồng nhận một dải frame liên tiếp
+const int EXPORT_PALETTE_SAMPLES = 16;    // số frame mẫu để chọn bảng màu GIF
+const int EXPORT_FINAL_HOLD_MS = 2000;    // frame cuối đứng lâu hơn trước khi GIF lặp lại
+
+// Statistics screen constants
+const int STATS_X = 40;
+const int STATS_TEXT_X = 110;  // bên phải nút Back
+const int STATS_TEXT_Y = 15;
+const int STATS_CHART_Y = 110;
+const int STATS_ROW_HEIGHT = 24;
+const int STATS_MAX_ROWS = 12;
+const int STATS_LABEL_WIDTH = 90;
+const int STATS_BAR_WIDTH = 250;
+const int STATS_TILES_X = 480;
+const int STATS_TREND_Y = 430;
+const int STATS_TREND_HEIGHT = 130;
+
 // Colors
 const SDL_Color MENU_BACKGROUND = {250, 248, 239, 255};  // Màu nền sáng
 const SDL_Color BOARD_BACKGROUND = {187, 173, 160, 255}; // Màu xám cho bảng
@@ -0,0 +1,83 @@
+#include "CpuOpponent.h"
+
+CpuOpponent::CpuOpponent(const NTupleNetwork* network)
+    : search(1, network), cancel(false), stopping(false), hasRequest(false), requestBoard(0), requestMs(0.0),
+      requestId(0), hasResult(false), resultId(0), resultBoard(0), resultMove(-1), resultDepthShown(0) {
+    worker = std::thread(&CpuOpponent::workerLoop, this);
+}
+
+CpuOpponent::~CpuOpponent() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        cancel = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void CpuOpponent::request(Engine::Board board, double deadlineMs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestBoard = board;
+        requestMs = deadlineMs;
+        requestId++;
+        hasRequest = true;
+        hasResult = false;
+        cancel = true;  // ngắt tìm kiếm cho bàn cờ cũ
+    }
+    wake.notify_one();
+}
+
+bool CpuOpponent::poll(Engine::Board board, int& move) {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !hasResult || resultId != requestId || resultBoard != board) return false;
+    move = resultMove;
+    return true;
+}
+
+void CpuOpponent::workerLoop() {
+    for (;;) {
+        Engine::Board board;
+        double budgetMs;
+        uint64_t id;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || hasRequest; });
+            if (stopping) return;
+            board = requestBoard;
+            budgetMs = requestMs;
+            id = requestId;
+            hasRequest = false;
+            cancel = false;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point deadline = start +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+        int best = -1;
+        int depthDone = 0;
+        for (int depth = 1; depth <= MAX_DEPTH; depth++) {
+            search.setDepth(depth);
+            if (depth == 1) {
+                search.clearDeadline();
+            } else {
+                search.setDeadline(deadline, &cancel);
+            }
+            int move = search.chooseMove(board);
+            if (search.lastAborted()) break;
+            best = move;
+            depthDone = depth;
+            if (move < 0 || std::chrono::steady_clock::now() >= deadline || cancel) break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (id == requestId) {
+            hasResult = true;
+            resultId = id;
+            resultBoard = board;
+            resultMove = best;
+            resultDepthShown = depthDone;
+        }
+    }
+}
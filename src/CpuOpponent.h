@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Engine.h"
+#include "Expectimax.h"
+
+// Đối thủ máy cho người chơi 2: tìm nước trên một luồng riêng bằng expectimax đào sâu
+// dần với deadline cứng. Khi hết giờ, vòng đang chạy bị bỏ và nước của vòng sâu nhất
+// đã xong được dùng (độ sâu 1 luôn xong). Luồng render chỉ gửi yêu cầu và hỏi kết quả,
+// không bao giờ chờ: poll dùng try_lock nên không chặn kể cả khi worker đang giữ khoá.
+class CpuOpponent {
+public:
+    static const int MAX_DEPTH = 6;
+
+    // network = nullptr: lá dùng heuristic theo hàng
+    explicit CpuOpponent(const NTupleNetwork* network = nullptr);
+    ~CpuOpponent();
+
+    // Gửi bàn cờ cần tìm nước; yêu cầu cũ đang chạy bị huỷ
+    void request(Engine::Board board, double deadlineMs);
+    // true khi đã có nước cho đúng bàn cờ board (-1 nếu hết nước)
+    bool poll(Engine::Board board, int& move);
+    int lastDepth() const { return resultDepthShown.load(std::memory_order_relaxed); }
+
+private:
+    void workerLoop();
+
+    ExpectimaxAdvisor search;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<bool> cancel;
+    bool stopping;
+    bool hasRequest;
+    Engine::Board requestBoard;
+    double requestMs;
+    uint64_t requestId;
+    bool hasResult;
+    uint64_t resultId;
+    Engine::Board resultBoard;
+    int resultMove;
+    std::atomic<int> resultDepthShown;
+
+    CpuOpponent(const CpuOpponent&);
+    CpuOpponent& operator=(const CpuOpponent&);
+};
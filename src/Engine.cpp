@@ -0,0 +1,191 @@
+#include "Engine.h"
+
+namespace {
+    // Bảng tra cho mọi hàng 16 bit: kết quả đi trái/phải và điểm gộp được
+    uint16_t rowLeft[65536];
+    uint16_t rowRight[65536];
+    uint32_t rowScore[65536];
+
+    uint16_t reverseRow(uint16_t row) {
+        return (uint16_t)((row >> 12) | ((row >> 4) & 0x00F0) | ((row << 4) & 0x0F00) | (row << 12));
+    }
+
+    struct TableBuilder {
+        TableBuilder() {
+            for (int row = 0; row < 65536; row++) {
+                int line[4];
+                int lineSize = 0;
+                // Thu thập các ô khác 0 theo hướng trái
+                for (int i = 0; i < 4; i++) {
+                    int cell = (row >> (4 * i)) & 0xF;
+                    if (cell != 0) line[lineSize++] = cell;
+                }
+
+                // Gộp giống moveTiles: mỗi cặp chỉ gộp một lần, cặp bên trái trước
+                uint32_t score = 0;
+                int result[4] = {0, 0, 0, 0};
+                int resultSize = 0;
+                for (int i = 0; i < lineSize; i++) {
+                    if (i + 1 < lineSize && line[i] == line[i + 1] && line[i] < Engine::MAX_EXPONENT) {
+                        result[resultSize++] = line[i] + 1;
+                        score += 1u << (line[i] + 1);
+                        i++;
+                    } else {
+                        result[resultSize++] = line[i];
+                    }
+                }
+
+                uint16_t moved = 0;
+                for (int i = 0; i < 4; i++) {
+                    moved |= (uint16_t)(result[i] << (4 * i));
+                }
+                rowLeft[row] = moved;
+                rowScore[row] = score;
+            }
+            for (int row = 0; row < 65536; row++) {
+                uint16_t reversed = reverseRow((uint16_t)row);
+                rowRight[row] = reverseRow(rowLeft[reversed]);
+            }
+        }
+    };
+
+    TableBuilder tableBuilder;
+
+    Engine::Board moveRows(Engine::Board board, const uint16_t* table, bool reversed, int& scoreDelta) {
+        Engine::Board result = 0;
+        for (int r = 0; r < 4; r++) {
+            uint16_t row = (uint16_t)(board >> (16 * r));
+            result |= (Engine::Board)table[row] << (16 * r);
+            scoreDelta += (int)rowScore[reversed ? reverseRow(row) : row];
+        }
+        return result;
+    }
+}
+
+namespace Engine {
+    void moveToDelta(int move, int& dx, int& dy) {
+        dx = 0;
+        dy = 0;
+        switch (move) {
+            case MOVE_LEFT: dx = -1; break;
+            case MOVE_RIGHT: dx = 1; break;
+            case MOVE_UP: dy = -1; break;
+            case MOVE_DOWN: dy = 1; break;
+        }
+    }
+
+    int deltaToMove(int dx, int dy) {
+        if (dx < 0) return MOVE_LEFT;
+        if (dx > 0) return MOVE_RIGHT;
+        if (dy < 0) return MOVE_UP;
+        if (dy > 0) return MOVE_DOWN;
+        return -1;
+    }
+
+    const char* moveName(int move) {
+        static const char* names[] = {"left", "right", "up", "down"};
+        return move >= 0 && move < MOVE_COUNT ? names[move] : "none";
+    }
+
+    Board transpose(Board x) {
+        Board a1 = x & 0xF0F00F0FF0F00F0FULL;
+        Board a2 = x & 0x0000F0F00000F0F0ULL;
+        Board a3 = x & 0x0F0F00000F0F0000ULL;
+        Board a = a1 | (a2 << 12) | (a3 >> 12);
+        Board b1 = a & 0xFF00FF0000FF00FFULL;
+        Board b2 = a & 0x00FF00FF00000000ULL;
+        Board b3 = a & 0x00000000FF00FF00ULL;
+        return b1 | (b2 >> 24) | (b3 << 24);
+    }
+
+    Board move(Board board, int move, int& scoreDelta) {
+        switch (move) {
+            case MOVE_LEFT:
+                return moveRows(board, rowLeft, false, scoreDelta);
+            case MOVE_RIGHT:
+                return moveRows(board, rowRight, true, scoreDelta);
+            case MOVE_UP:
+                return transpose(moveRows(transpose(board), rowLeft, false, scoreDelta));
+            case MOVE_DOWN:
+                return transpose(moveRows(transpose(board), rowRight, true, scoreDelta));
+        }
+        return board;
+    }
+
+    Board move(Board board, int direction) {
+        int scoreDelta = 0;
+        return move(board, direction, scoreDelta);
+    }
+
+    bool canMove(Board board) {
+        if (zeroNibbles(board) != 0) return true;
+        // Bàn cờ đầy: đi được khi có hai ô kề nhau bằng nhau theo hàng hoặc cột,
+        // trừ cặp 32768 (MAX_EXPONENT) mà bảng hàng không gộp
+        uint64_t full = board & (board >> 1) & (board >> 2) & (board >> 3) & 0x1111111111111111ULL;
+        uint64_t horizontal = zeroNibbles(board ^ (board >> 4)) & 0x0111011101110111ULL;
+        uint64_t vertical = zeroNibbles(board ^ (board >> 16)) & 0x0000111111111111ULL;
+        return ((horizontal | vertical) & ~full) != 0;
+    }
+
+    int emptyCount(Board board) {
+        return __builtin_popcountll(zeroNibbles(board));
+    }
+
+    int maxExponent(Board board) {
+        int best = 0;
+        for (int i = 0; i < CELL_COUNT; i++) {
+            int cell = getCell(board, i);
+            if (cell > best) best = cell;
+        }
+        return best;
+    }
+
+    Board spawnAt(Board board, int emptyIndex, int exponent) {
+        uint64_t empties = zeroNibbles(board);
+        while (emptyIndex-- > 0 && empties) {
+            empties &= empties - 1;
+        }
+        // empties & -empties là 0x1 ở nibble được chọn
+        return board | (empties & (~empties + 1)) * (uint64_t)exponent;
+    }
+
+    Board spawnRandom(Board board, Rng& rng) {
+        int empty = emptyCount(board);
+        if (empty == 0) return board;
+        int index = rng.below(empty);
+        int exponent = rng.below(10) < 9 ? 1 : 2;
+        return spawnAt(board, index, exponent);
+    }
+
+    int exponentOf(int value) {
+        int exponent = 0;
+        while (value > 1 && exponent < MAX_EXPONENT) {
+            value >>= 1;
+            exponent++;
+        }
+        return exponent;
+    }
+
+    int valueOf(int exponent) {
+        return exponent == 0 ? 0 : 1 << exponent;
+    }
+
+    Board fromGrid(const std::vector<std::vector<int>>& grid) {
+        Board board = 0;
+        for (int r = 0; r < 4 && r < (int)grid.size(); r++) {
+            for (int c = 0; c < 4 && c < (int)grid[r].size(); c++) {
+                board = setCell(board, r * 4 + c, exponentOf(grid[r][c]));
+            }
+        }
+        return board;
+    }
+
+    void toGrid(Board board, std::vector<std::vector<int>>& grid) {
+        grid.assign(4, std::vector<int>(4, 0));
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) {
+                grid[r][c] = valueOf(getCell(board, r * 4 + c));
+            }
+        }
+    }
+}
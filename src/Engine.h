@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Luật 2048 không phụ thuộc SDL trên bàn cờ nén 64 bit: mỗi ô là một nibble chứa
+// số mũ (0 = trống, 1 = 2, 2 = 4, ..., 15 = 32768). Ô (row, col) nằm ở
+// nibble row * 4 + col (row 0 ở 16 bit thấp). Luật khớp với Game2048::moveTiles:
+// cặp gần hướng di chuyển nhất gộp trước, mỗi ô chỉ gộp một lần mỗi nước đi.
+// Nibble không chứa được 65536 nên hai ô 32768 không gộp (MAX_EXPONENT); canMove,
+// Game2048 và mọi kernel EngineSimd dùng cùng giới hạn này (MAX_TILE trong Constants.h).
+namespace Engine {
+    typedef uint64_t Board;
+
+    enum Move {
+        MOVE_LEFT = 0,
+        MOVE_RIGHT = 1,
+        MOVE_UP = 2,
+        MOVE_DOWN = 3
+    };
+
+    const int MOVE_COUNT = 4;
+    const int CELL_COUNT = 16;
+    const int MAX_EXPONENT = 15;
+
+    // Hướng (dx, dy) như tham số của moveTiles
+    void moveToDelta(int move, int& dx, int& dy);
+    int deltaToMove(int dx, int dy);
+    const char* moveName(int move);
+
+    inline int getCell(Board board, int index) {
+        return (int)((board >> (4 * index)) & 0xF);
+    }
+
+    inline Board setCell(Board board, int index, int exponent) {
+        return (board & ~((Board)0xF << (4 * index))) | ((Board)exponent << (4 * index));
+    }
+
+    // Bit thấp của mỗi nibble bằng 0 được bật (0x1 tại nibble đó)
+    inline uint64_t zeroNibbles(uint64_t x) {
+        x = ~x;
+        x &= x >> 2;
+        x &= x >> 1;
+        return x & 0x1111111111111111ULL;
+    }
+
+    Board transpose(Board board);
+
+    // Trả về bàn cờ sau nước đi (bằng board nếu không đi được), cộng điểm gộp vào scoreDelta
+    Board move(Board board, int move, int& scoreDelta);
+    Board move(Board board, int move);
+    bool canMove(Board board);
+
+    int emptyCount(Board board);
+    int maxExponent(Board board);
+    // Đặt số mũ exponent vào ô trống thứ emptyIndex (theo thứ tự row-major)
+    Board spawnAt(Board board, int emptyIndex, int exponent);
+
+    // splitmix64: trạng thái 8 byte, đủ nhanh cho mô phỏng hàng loạt
+    struct Rng {
+        uint64_t state;
+
+        explicit Rng(uint64_t seed = 0) : state(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // Số nguyên đều trong [0, n)
+        int below(int n) {
+            return (int)(((next() >> 32) * (uint64_t)n) >> 32);
+        }
+    };
+
+    // Sinh ô mới như addNewTile: ô trống ngẫu nhiên, 90% là 2 và 10% là 4
+    Board spawnRandom(Board board, Rng& rng);
+
+    // Chuyển đổi với bàn cờ dạng vector<vector<int>> của Game2048 (giá trị thật, không phải số mũ)
+    Board fromGrid(const std::vector<std::vector<int>>& grid);
+    void toGrid(Board board, std::vector<std::vector<int>>& grid);
+    int exponentOf(int value);
+    int valueOf(int exponent);
+}
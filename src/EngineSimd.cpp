@@ -0,0 +1,270 @@
+#include "EngineSimd.h"
+#include <cstring>
+
+#if defined(__x86_64__)
+#define ENGINE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    EngineSimd::Kernel currentKernel = EngineSimd::KERNEL_SCALAR;
+
+#ifdef ENGINE_SIMD_X86
+    // Hoán vị đưa mỗi hướng về "đi trái": canonical[i] = board[toLeft[move][i]],
+    // fromLeft là hoán vị ngược. Byte 0x80 trong control của pshufb cho ra 0.
+    const unsigned char toLeft[4][16] = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},       // trái
+        {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},       // phải
+        {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15},       // lên
+        {12, 8, 4, 0, 13, 9, 5, 1, 14, 10, 6, 2, 15, 11, 7, 3}        // xuống
+    };
+    const unsigned char fromLeft[4][16] = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+        {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15},
+        {3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12}
+    };
+    // Trong mỗi hàng: byte c lấy byte c + 1 (ô cuối hàng nhận 0)
+    const unsigned char nextInRow[16] = {1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15, 0x80};
+    // Trong mỗi hàng: byte c lấy byte c - 1 (ô đầu hàng nhận 0)
+    const unsigned char prevInRow[16] = {0x80, 0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14};
+    const unsigned char prev2InRow[16] = {0x80, 0x80, 0, 1, 0x80, 0x80, 4, 5, 0x80, 0x80, 8, 9, 0x80, 0x80, 12, 13};
+    const unsigned char prev3InRow[16] = {0x80, 0x80, 0x80, 0, 0x80, 0x80, 0x80, 4, 0x80, 0x80, 0x80, 8, 0x80, 0x80, 0x80, 12};
+    // Byte thấp / cao của 2^e để tính điểm bằng psadbw
+    const unsigned char powLow[16] = {1, 2, 4, 8, 16, 32, 64, 128, 0, 0, 0, 0, 0, 0, 0, 0};
+    const unsigned char powHigh[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, 128};
+
+    // ---------------- SSSE3: một bàn cờ ----------------
+
+    __attribute__((target("ssse3")))
+    inline __m128i load16(const unsigned char* bytes) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    }
+
+    __attribute__((target("ssse3")))
+    inline __m128i unpackBoard(Engine::Board board) {
+        __m128i packed = _mm_cvtsi64_si128((long long)board);
+        __m128i nibbleMask = _mm_set1_epi8(0x0F);
+        __m128i low = _mm_and_si128(packed, nibbleMask);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(packed, 4), nibbleMask);
+        return _mm_unpacklo_epi8(low, high);
+    }
+
+    __attribute__((target("ssse3")))
+    inline Engine::Board packBoard(__m128i cells) {
+        // cell chẵn * 1 + cell lẻ * 16 rồi thu về 8 byte
+        __m128i pairs = _mm_maddubs_epi16(cells, _mm_set1_epi16(0x1001));
+        return (Engine::Board)_mm_cvtsi128_si64(_mm_packus_epi16(pairs, pairs));
+    }
+
+    __attribute__((target("ssse3")))
+    inline __m128i select128(__m128i mask, __m128i whenSet, __m128i whenClear) {
+        return _mm_or_si128(_mm_and_si128(mask, whenSet), _mm_andnot_si128(mask, whenClear));
+    }
+
+    // Xoá ô trống đầu tiên của mỗi hàng, dồn phần còn lại sang trái
+    __attribute__((target("ssse3")))
+    inline __m128i removeFirstGap(__m128i v, __m128i zero, __m128i next, __m128i prev, __m128i prev2, __m128i prev3) {
+        __m128i empty = _mm_cmpeq_epi8(v, zero);
+        __m128i fromGap = _mm_or_si128(_mm_or_si128(empty, _mm_shuffle_epi8(empty, prev)),
+                                       _mm_or_si128(_mm_shuffle_epi8(empty, prev2), _mm_shuffle_epi8(empty, prev3)));
+        return select128(fromGap, _mm_shuffle_epi8(v, next), v);
+    }
+
+    __attribute__((target("ssse3")))
+    inline __m128i slideLeft(__m128i v, int& scoreDelta) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i next = load16(nextInRow);
+        const __m128i prev = load16(prevInRow);
+        const __m128i prev2 = load16(prev2InRow);
+        const __m128i prev3 = load16(prev3InRow);
+
+        v = removeFirstGap(v, zero, next, prev, prev2, prev3);
+        v = removeFirstGap(v, zero, next, prev, prev2, prev3);
+        v = removeFirstGap(v, zero, next, prev, prev2, prev3);
+
+        // Cặp bằng nhau (khác 0, chưa đạt số mũ tối đa); cặp bên trái được ưu tiên
+        __m128i equal = _mm_andnot_si128(_mm_cmpeq_epi8(v, zero), _mm_cmpeq_epi8(v, _mm_shuffle_epi8(v, next)));
+        equal = _mm_and_si128(equal, _mm_cmpgt_epi8(_mm_set1_epi8(Engine::MAX_EXPONENT), v));
+        __m128i merge = _mm_andnot_si128(_mm_shuffle_epi8(equal, prev), equal);
+        merge = _mm_andnot_si128(_mm_shuffle_epi8(merge, prev), equal);
+
+        v = _mm_sub_epi8(v, merge);                                   // mask = -1 nên trừ là +1
+        v = _mm_andnot_si128(_mm_shuffle_epi8(merge, prev), v);       // xoá ô bị gộp
+
+        __m128i mergedLow = _mm_and_si128(merge, _mm_shuffle_epi8(load16(powLow), v));
+        __m128i mergedHigh = _mm_and_si128(merge, _mm_shuffle_epi8(load16(powHigh), v));
+        __m128i sumLow = _mm_sad_epu8(mergedLow, zero);
+        __m128i sumHigh = _mm_sad_epu8(mergedHigh, zero);
+        scoreDelta += (_mm_cvtsi128_si32(sumLow) + _mm_extract_epi16(sumLow, 4)) +
+                      ((_mm_cvtsi128_si32(sumHigh) + _mm_extract_epi16(sumHigh, 4)) << 8);
+
+        v = removeFirstGap(v, zero, next, prev, prev2, prev3);
+        v = removeFirstGap(v, zero, next, prev, prev2, prev3);
+        return v;
+    }
+
+    __attribute__((target("ssse3")))
+    Engine::Board moveSsse3(Engine::Board board, int move, int& scoreDelta) {
+        __m128i cells = unpackBoard(board);
+        cells = _mm_shuffle_epi8(cells, load16(toLeft[move]));
+        cells = slideLeft(cells, scoreDelta);
+        cells = _mm_shuffle_epi8(cells, load16(fromLeft[move]));
+        return packBoard(cells);
+    }
+
+    // ---------------- AVX2: hai bàn cờ mỗi lượt ----------------
+
+    __attribute__((target("avx2")))
+    inline __m256i broadcast16(const unsigned char* bytes) {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i pair16(const unsigned char* lane0, const unsigned char* lane1) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane0));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane1));
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i select256(__m256i mask, __m256i whenSet, __m256i whenClear) {
+        return _mm256_blendv_epi8(whenClear, whenSet, mask);
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i removeFirstGap2(__m256i v, __m256i zero, __m256i next, __m256i prev, __m256i prev2, __m256i prev3) {
+        __m256i empty = _mm256_cmpeq_epi8(v, zero);
+        __m256i fromGap = _mm256_or_si256(_mm256_or_si256(empty, _mm256_shuffle_epi8(empty, prev)),
+                                          _mm256_or_si256(_mm256_shuffle_epi8(empty, prev2), _mm256_shuffle_epi8(empty, prev3)));
+        return select256(fromGap, _mm256_shuffle_epi8(v, next), v);
+    }
+
+    __attribute__((target("avx2")))
+    void movePairAvx2(const Engine::Board* boards, const int* moves, Engine::Board* out, int* scoreDeltas) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i next = broadcast16(nextInRow);
+        const __m256i prev = broadcast16(prevInRow);
+        const __m256i prev2 = broadcast16(prev2InRow);
+        const __m256i prev3 = broadcast16(prev3InRow);
+        const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+
+        // Giải nén: mỗi lane 128 bit chứa 16 byte số mũ của một bàn cờ
+        __m256i packed = _mm256_set_epi64x(0, (long long)boards[1], 0, (long long)boards[0]);
+        __m256i low = _mm256_and_si256(packed, nibbleMask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(packed, 4), nibbleMask);
+        __m256i v = _mm256_unpacklo_epi8(low, high);
+
+        v = _mm256_shuffle_epi8(v, pair16(toLeft[moves[0]], toLeft[moves[1]]));
+
+        v = removeFirstGap2(v, zero, next, prev, prev2, prev3);
+        v = removeFirstGap2(v, zero, next, prev, prev2, prev3);
+        v = removeFirstGap2(v, zero, next, prev, prev2, prev3);
+
+        __m256i equal = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, zero), _mm256_cmpeq_epi8(v, _mm256_shuffle_epi8(v, next)));
+        equal = _mm256_and_si256(equal, _mm256_cmpgt_epi8(_mm256_set1_epi8(Engine::MAX_EXPONENT), v));
+        __m256i merge = _mm256_andnot_si256(_mm256_shuffle_epi8(equal, prev), equal);
+        merge = _mm256_andnot_si256(_mm256_shuffle_epi8(merge, prev), equal);
+
+        v = _mm256_sub_epi8(v, merge);
+        v = _mm256_andnot_si256(_mm256_shuffle_epi8(merge, prev), v);
+
+        __m256i mergedLow = _mm256_and_si256(merge, _mm256_shuffle_epi8(broadcast16(powLow), v));
+        __m256i mergedHigh = _mm256_and_si256(merge, _mm256_shuffle_epi8(broadcast16(powHigh), v));
+        __m256i sumLow = _mm256_sad_epu8(mergedLow, zero);
+        __m256i sumHigh = _mm256_sad_epu8(mergedHigh, zero);
+        // psadbw cho 4 tổng 64 bit: [0],[1] thuộc bàn cờ 0, [2],[3] thuộc bàn cờ 1
+        __m256i sums = _mm256_add_epi64(sumLow, _mm256_slli_epi64(sumHigh, 8));
+        long long partial[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(partial), sums);
+        scoreDeltas[0] += (int)(partial[0] + partial[1]);
+        scoreDeltas[1] += (int)(partial[2] + partial[3]);
+
+        v = removeFirstGap2(v, zero, next, prev, prev2, prev3);
+        v = removeFirstGap2(v, zero, next, prev, prev2, prev3);
+
+        v = _mm256_shuffle_epi8(v, pair16(fromLeft[moves[0]], fromLeft[moves[1]]));
+
+        __m256i pairs = _mm256_maddubs_epi16(v, _mm256_set1_epi16(0x1001));
+        __m256i bytes = _mm256_packus_epi16(pairs, pairs);
+        out[0] = (Engine::Board)_mm256_extract_epi64(bytes, 0);
+        out[1] = (Engine::Board)_mm256_extract_epi64(bytes, 2);
+    }
+#endif
+
+    EngineSimd::Kernel detectKernel() {
+#ifdef ENGINE_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return EngineSimd::KERNEL_AVX2;
+        if (__builtin_cpu_supports("ssse3")) return EngineSimd::KERNEL_SSSE3;
+#endif
+        return EngineSimd::KERNEL_SCALAR;
+    }
+
+    struct KernelSelector {
+        KernelSelector() {
+            currentKernel = detectKernel();
+        }
+    };
+
+    KernelSelector kernelSelector;
+}
+
+namespace EngineSimd {
+    Kernel bestKernel() {
+        return detectKernel();
+    }
+
+    Kernel activeKernel() {
+        return currentKernel;
+    }
+
+    bool setKernel(Kernel kernel) {
+        if (kernel > bestKernel()) return false;
+        currentKernel = kernel;
+        return true;
+    }
+
+    const char* kernelName(Kernel kernel) {
+        switch (kernel) {
+            case KERNEL_SCALAR: return "scalar";
+            case KERNEL_SSSE3: return "ssse3";
+            case KERNEL_AVX2: return "avx2";
+        }
+        return "unknown";
+    }
+
+    bool parseKernel(const char* name, Kernel& kernel) {
+        for (int k = KERNEL_SCALAR; k <= KERNEL_AVX2; k++) {
+            if (std::strcmp(name, kernelName((Kernel)k)) == 0) {
+                kernel = (Kernel)k;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Engine::Board move(Engine::Board board, int direction, int& scoreDelta) {
+#ifdef ENGINE_SIMD_X86
+        if (currentKernel != KERNEL_SCALAR) return moveSsse3(board, direction, scoreDelta);
+#endif
+        return Engine::move(board, direction, scoreDelta);
+    }
+
+    void moveMany(const Engine::Board* boards, const int* moves, Engine::Board* out, int* scoreDeltas, size_t count) {
+        size_t i = 0;
+#ifdef ENGINE_SIMD_X86
+        if (currentKernel == KERNEL_AVX2) {
+            for (; i + 2 <= count; i += 2) {
+                scoreDeltas[i] = 0;
+                scoreDeltas[i + 1] = 0;
+                movePairAvx2(boards + i, moves + i, out + i, scoreDeltas + i);
+            }
+        }
+#endif
+        for (; i < count; i++) {
+            scoreDeltas[i] = 0;
+            out[i] = move(boards[i], moves[i], scoreDeltas[i]);
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include "Engine.h"
+
+// Nước đi vector hoá: bàn cờ giải nén thành 16 byte số mũ trong một thanh ghi SSE,
+// trượt/gộp/chuyển vị bằng pshufb + so sánh + mask, không dùng bảng tra.
+// Bản AVX2 xử lý hai bàn cờ (mỗi bàn một nước đi riêng) trong một thanh ghi 256 bit.
+// Kernel được chọn lúc chạy theo CPU; máy không phải x86 dùng bảng tra của Engine.
+// Kết quả và điểm cộng giống hệt Engine::move, kể cả hai ô 32768 không gộp (MAX_EXPONENT).
+namespace EngineSimd {
+    enum Kernel {
+        KERNEL_SCALAR = 0,
+        KERNEL_SSSE3 = 1,
+        KERNEL_AVX2 = 2
+    };
+
+    Kernel bestKernel();
+    Kernel activeKernel();
+    // Chọn kernel (để benchmark/so sánh), trả về false nếu CPU không hỗ trợ
+    bool setKernel(Kernel kernel);
+    const char* kernelName(Kernel kernel);
+    bool parseKernel(const char* name, Kernel& kernel);
+
+    Engine::Board move(Engine::Board board, int move, int& scoreDelta);
+
+    // Áp dụng moves[i] lên boards[i]; bản AVX2 xử lý từng cặp bàn cờ
+    void moveMany(const Engine::Board* boards, const int* moves, Engine::Board* out, int* scoreDeltas, size_t count);
+}
@@ -0,0 +1,172 @@
+#include "Expectimax.h"
+#include "PositionTable.h"
+#include <cmath>
+
+namespace {
+    // Trọng số heuristic theo hàng (chọn bằng thực nghiệm, phổ biến trong các AI 2048)
+    const float LOST_PENALTY = 200000.0f;
+    const float MONOTONICITY_POWER = 4.0f;
+    const float MONOTONICITY_WEIGHT = 47.0f;
+    const float SUM_POWER = 3.5f;
+    const float SUM_WEIGHT = 11.0f;
+    const float MERGES_WEIGHT = 700.0f;
+    const float EMPTY_WEIGHT = 270.0f;
+
+    float rowHeuristic[65536];
+
+    struct HeuristicBuilder {
+        HeuristicBuilder() {
+            for (int row = 0; row < 65536; row++) {
+                int line[4];
+                for (int i = 0; i < 4; i++) line[i] = (row >> (4 * i)) & 0xF;
+
+                float sum = 0.0f;
+                int empty = 0;
+                int merges = 0;
+                int previous = 0;
+                int counter = 0;
+                for (int i = 0; i < 4; i++) {
+                    sum += std::pow((float)line[i], SUM_POWER);
+                    if (line[i] == 0) {
+                        empty++;
+                    } else {
+                        if (previous == line[i]) {
+                            counter++;
+                        } else if (counter > 0) {
+                            merges += 1 + counter;
+                            counter = 0;
+                        }
+                        previous = line[i];
+                    }
+                }
+                if (counter > 0) merges += 1 + counter;
+
+                float monotonicLeft = 0.0f;
+                float monotonicRight = 0.0f;
+                for (int i = 1; i < 4; i++) {
+                    float a = std::pow((float)line[i - 1], MONOTONICITY_POWER);
+                    float b = std::pow((float)line[i], MONOTONICITY_POWER);
+                    if (line[i - 1] > line[i]) {
+                        monotonicLeft += a - b;
+                    } else {
+                        monotonicRight += b - a;
+                    }
+                }
+
+                rowHeuristic[row] = LOST_PENALTY + EMPTY_WEIGHT * empty + MERGES_WEIGHT * merges -
+                    MONOTONICITY_WEIGHT * std::min(monotonicLeft, monotonicRight) - SUM_WEIGHT * sum;
+            }
+        }
+    };
+
+    HeuristicBuilder heuristicBuilder;
+
+    float rowsHeuristic(Engine::Board board) {
+        return rowHeuristic[board & 0xFFFF] + rowHeuristic[(board >> 16) & 0xFFFF] +
+               rowHeuristic[(board >> 32) & 0xFFFF] + rowHeuristic[board >> 48];
+    }
+}
+
+const float ExpectimaxAdvisor::PROBABILITY_CUTOFF = 0.0001f;
+
+ExpectimaxAdvisor::ExpectimaxAdvisor(int searchDepth, const NTupleNetwork* tupleNetwork)
+    : depth(searchDepth < 1 ? 1 : searchDepth), network(tupleNetwork), generation(0), nodes(0), bestValue(0.0),
+      hasDeadline(false), aborted(false), cancelFlag(nullptr) {
+    CacheEntry empty = {0, 0, 0, 0.0f};
+    cache.assign((size_t)1 << CACHE_BITS, empty);
+}
+
+float ExpectimaxAdvisor::heuristic(Engine::Board board) {
+    return rowsHeuristic(board) + rowsHeuristic(Engine::transpose(board));
+}
+
+float ExpectimaxAdvisor::evaluate(Engine::Board afterstate) const {
+    return network ? network->evaluate(afterstate) : heuristic(afterstate);
+}
+
+void ExpectimaxAdvisor::setDeadline(std::chrono::steady_clock::time_point searchDeadline, const std::atomic<bool>* cancel) {
+    hasDeadline = true;
+    deadline = searchDeadline;
+    cancelFlag = cancel;
+}
+
+bool ExpectimaxAdvisor::checkAbort() {
+    // Đọc đồng hồ mỗi 1024 node để chi phí kiểm tra không đáng kể
+    if (!aborted && hasDeadline && (nodes & 1023) == 0) {
+        aborted = std::chrono::steady_clock::now() >= deadline ||
+                  (cancelFlag && cancelFlag->load(std::memory_order_relaxed));
+    }
+    return aborted;
+}
+
+float ExpectimaxAdvisor::maxNode(Engine::Board board, int remaining, float probability) {
+    nodes++;
+    if (checkAbort()) return 0.0f;
+    float best = 0.0f;
+    bool any = false;
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        int delta = 0;
+        Engine::Board afterstate = Engine::move(board, m, delta);
+        if (afterstate == board) continue;
+        // Với n-tuple, giá trị afterstate không gồm điểm vừa gộp nên phải cộng vào
+        float value = chanceNode(afterstate, remaining, probability) + (network ? delta : 0);
+        if (!any || value > best) {
+            best = value;
+            any = true;
+        }
+    }
+    return best;
+}
+
+float ExpectimaxAdvisor::chanceNode(Engine::Board afterstate, int remaining, float probability) {
+    if (remaining <= 0 || probability < PROBABILITY_CUTOFF) {
+        nodes++;
+        return evaluate(afterstate);
+    }
+
+    // Cache theo (bàn cờ, độ sâu còn lại), dùng lại giữa các nhánh hoán vị
+    CacheEntry& entry = cache[PositionTable::hash(afterstate) >> (64 - CACHE_BITS)];
+    if (entry.generation == generation && entry.board == afterstate && entry.depth >= remaining) {
+        return entry.value;
+    }
+
+    int empty = Engine::emptyCount(afterstate);
+    float total = 0.0f;
+    float cellProbability = probability / empty;
+    uint64_t empties = Engine::zeroNibbles(afterstate);
+    while (empties) {
+        uint64_t cell = empties & (~empties + 1);
+        empties &= empties - 1;
+        total += 0.9f * maxNode(afterstate | cell, remaining - 1, cellProbability * 0.9f);
+        total += 0.1f * maxNode(afterstate | (cell * 2), remaining - 1, cellProbability * 0.1f);
+    }
+    // Giá trị của nhánh bị ngắt không đúng, không được ghi vào cache
+    if (aborted) return 0.0f;
+    float value = total / empty;
+
+    entry.board = afterstate;
+    entry.generation = generation;
+    entry.depth = remaining;
+    entry.value = value;
+    return value;
+}
+
+int ExpectimaxAdvisor::chooseMove(Engine::Board board) {
+    // Đổi generation thay cho xoá cả bảng cache mỗi nước đi
+    generation++;
+    nodes = 0;
+    aborted = false;
+    int best = -1;
+    bestValue = 0.0;
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        int delta = 0;
+        Engine::Board afterstate = Engine::move(board, m, delta);
+        if (afterstate == board) continue;
+        double value = chanceNode(afterstate, depth - 1, 1.0f) + (network ? delta : 0);
+        if (best < 0 || value > bestValue) {
+            best = m;
+            bestValue = value;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "Advisor.h"
+#include "NTuple.h"
+
+// Expectimax độ sâu cố định: nút max chọn nước đi, nút chance lấy trung bình mọi ô
+// mới (2 với xác suất 0.9, 4 với 0.1). Nhánh có xác suất tích luỹ quá nhỏ được cắt
+// và đánh giá ngay. Lá dùng heuristic theo hàng (bảng tra 65536 hàng) hoặc mạng n-tuple.
+class ExpectimaxAdvisor : public Advisor {
+public:
+    // depth: số nước đi của người chơi được tìm trước; network = nullptr dùng heuristic
+    explicit ExpectimaxAdvisor(int depth, const NTupleNetwork* network = nullptr);
+
+    const char* name() const { return network ? "expectimax-ntuple" : "expectimax"; }
+    int chooseMove(Engine::Board board);
+    double lastValue() const { return bestValue; }
+
+    uint64_t lastNodes() const { return nodes; }
+
+    void setDepth(int searchDepth) { depth = searchDepth < 1 ? 1 : searchDepth; }
+    // Ngắt tìm kiếm khi quá deadline hoặc khi *cancel bật; chooseMove khi đó trả về kết quả
+    // không dùng được và lastAborted() = true (để đào sâu dần giữ kết quả vòng trước)
+    void setDeadline(std::chrono::steady_clock::time_point deadline, const std::atomic<bool>* cancel = nullptr);
+    void clearDeadline() { hasDeadline = false; }
+    bool lastAborted() const { return aborted; }
+
+    // Heuristic cổ điển: ô trống, cặp gộp được, tính đơn điệu, phạt tổng ô lớn
+    static float heuristic(Engine::Board board);
+
+private:
+    struct CacheEntry {
+        Engine::Board board;
+        uint32_t generation;
+        int depth;
+        float value;
+    };
+
+    static const int CACHE_BITS = 18;
+    static const float PROBABILITY_CUTOFF;
+
+    float evaluate(Engine::Board afterstate) const;
+    float maxNode(Engine::Board board, int depth, float probability);
+    float chanceNode(Engine::Board afterstate, int depth, float probability);
+    bool checkAbort();
+
+    int depth;
+    const NTupleNetwork* network;
+    std::vector<CacheEntry> cache;
+    uint32_t generation;
+    uint64_t nodes;
+    double bestValue;
+    bool hasDeadline;
+    bool aborted;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* cancelFlag;
+};
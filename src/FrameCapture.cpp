@@ -0,0 +1,59 @@
+#include "FrameCapture.h"
+#include <fstream>
+#include <iostream>
+
+namespace FrameCapture {
+    bool capture(SDL_Renderer* renderer, int width, int height, Frame& out) {
+        out.width = width;
+        out.height = height;
+        out.rgb.resize(static_cast<size_t>(width) * height * 3);
+        if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGB24, out.rgb.data(), width * 3) != 0) {
+            std::cerr << "SDL_RenderReadPixels failed! SDL_Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool writePPM(const std::string& path, const Frame& frame) {
+        std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << path << " for writing" << std::endl;
+            return false;
+        }
+        file << "P6\n" << frame.width << " " << frame.height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(frame.rgb.data()), frame.rgb.size());
+        return !file.fail();
+    }
+
+    bool readPPM(const std::string& path, Frame& out) {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << path << std::endl;
+            return false;
+        }
+        std::string magic;
+        int maxValue = 0;
+        file >> magic >> out.width >> out.height >> maxValue;
+        if (magic != "P6" || maxValue != 255 || out.width <= 0 || out.height <= 0) {
+            std::cerr << path << " is not an 8-bit binary PPM" << std::endl;
+            return false;
+        }
+        file.get();  // Bỏ ký tự xuống dòng sau header
+        out.rgb.resize(static_cast<size_t>(out.width) * out.height * 3);
+        file.read(reinterpret_cast<char*>(out.rgb.data()), out.rgb.size());
+        return !file.fail();
+    }
+
+    long countDiffPixels(const Frame& a, const Frame& b) {
+        if (a.width != b.width || a.height != b.height || a.rgb.size() != b.rgb.size()) {
+            return -1;
+        }
+        long diff = 0;
+        for (size_t i = 0; i < a.rgb.size(); i += 3) {
+            if (a.rgb[i] != b.rgb[i] || a.rgb[i + 1] != b.rgb[i + 1] || a.rgb[i + 2] != b.rgb[i + 2]) {
+                diff++;
+            }
+        }
+        return diff;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+// Đọc pixel từ renderer và lưu/so sánh ảnh PPM (P6, RGB 8 bit)
+namespace FrameCapture {
+    struct Frame {
+        int width;
+        int height;
+        std::vector<unsigned char> rgb;
+
+        Frame() : width(0), height(0) {}
+    };
+
+    bool capture(SDL_Renderer* renderer, int width, int height, Frame& out);
+    bool writePPM(const std::string& path, const Frame& frame);
+    bool readPPM(const std::string& path, Frame& out);
+
+    // Số pixel khác nhau giữa hai frame, -1 nếu kích thước không khớp
+    long countDiffPixels(const Frame& a, const Frame& b);
+}
@@ -1,45 +1,107 @@
 #include "Game2048.h"
-#include <random>
+#include "AllocTracker.h"
+#include "FrameCapture.h"
+#include "Resources.h"
+#include "NTupleAdvisor.h"
+#include "OpeningBook.h"
+#include "RolloutAdvisor.h"
+#include "Strategies.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <fstream>
 #include <algorithm>
 #include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
 
-Game2048::Game2048() : window(nullptr), renderer(nullptr), font(nullptr), menuFont(nullptr), scoreFont(nullptr),
-    player1NameTexture(nullptr), player2NameTexture(nullptr), score1Texture(nullptr), score2Texture(nullptr),
+// Bàn cờ của game đi qua Engine (advisor, replay, hash đấu mạng): luật gộp phải cùng giới hạn
+static_assert(MAX_TILE == 1 << Engine::MAX_EXPONENT, "MAX_TILE phải khớp Engine::MAX_EXPONENT");
+
+Game2048::Game2048() : window(nullptr), renderer(nullptr), offscreenSurface(nullptr), font(nullptr), menuFont(nullptr), scoreFont(nullptr),
+    ownsSdl(false), player1NameTexture(nullptr), player2NameTexture(nullptr), score1Texture(nullptr), score2Texture(nullptr),
     score(0), score2(0), previousScore(0), previousScore2(0), bestScore(0), lastScore1(0), lastScore2(0),
-    gameOver(false), gameOver2(false), inMenu(true), firstGame(true), isMultiplayer(false) {
+    gameOver(false), gameOver2(false), inMenu(true), firstGame(true), isMultiplayer(false),
+    showAllocHud(false), showLatencyHud(false), syntheticStart(0), syntheticInjected(0),
+    rng(std::random_device{}()), advisor(nullptr), autoplay(false), hintBoard(0), hintMove(-1), hintValue(0.0),
+    cpu(nullptr), cpuRequestBoard(0), cpuNextMoveTicks(0), replaySeed(0), lastMove(-1), viewingReplay(false),
+    replayPlaying(false), replayScrubbing(false), replayIndex(0), replayScore(0), replayStepMs(REPLAY_STEP_MS),
+    replayNextTicks(0), sessionStart(0), sessionClock(0), net(nullptr), netStarted(false), netDesync(false),
+    netLocalMoves(0), netRemoteMoves(0), replaySeed2(0), lastMove2(-1), liveMoves(0), gameStartTicks(0),
+    gameMoves(0), gameMoves2(0), historyRecorded(false), historyRecorded2(false), inStats(false), statsMode(-1),
+    statsQueryMs(0.0), frameStartCounter(0) {
     board = std::vector<std::vector<int>>(GRID_SIZE, std::vector<int>(GRID_SIZE, 0));
     board2 = std::vector<std::vector<int>>(GRID_SIZE, std::vector<int>(GRID_SIZE, 0));
     previousBoard = board;
     previousBoard2 = board2;
+    std::memset(&livePublished, 0, sizeof(livePublished));
+    std::memset(&historyStats, 0, sizeof(historyStats));
+    for (int i = 0; i < TILE_TEXT_CACHE_SIZE; i++) {
+        tileTextTextures[i] = nullptr;
+    }
 }
 
 Game2048::~Game2048() {
     cleanup();
 }
 
-bool Game2048::init() {
+bool Game2048::init(const GameOptions& gameOptions) {
+    options = gameOptions;
+    if (!options.playSession.empty()) {
+        if (!sessionPlayer.load(options.playSession)) {
+            return false;
+        }
+        // Cùng seed với phiên gốc để mọi ô mới giống hệt
+        options.seed = sessionPlayer.seed();
+        options.hasSeed = true;
+    } else if (!options.recordSession.empty() && !options.hasSeed) {
+        options.seed = std::random_device{}();
+        options.hasSeed = true;
+    }
+    if (options.hasSeed) {
+        rng.seed(options.seed);
+    }
+    newReplaySeed();
+    newReplaySeedPlayer2();
+    autoplay = options.autoplay;
+
+    if (options.headless) {
+        // Không có màn hình/GPU: dùng driver "dummy" và renderer phần mềm
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    }
+
     std::cout << "Initializing SDL..." << std::endl;
-    if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
+    Uint32 initFlags = options.headless ? (SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_TIMER) : SDL_INIT_EVERYTHING;
+    if (SDL_Init(initFlags) < 0) {
         std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
 
-    std::cout << "Creating window..." << std::endl;
-    window = SDL_CreateWindow("2048", 
-                            SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                            WINDOW_WIDTH, WINDOW_HEIGHT, 
-                            SDL_WINDOW_SHOWN);
-    if (!window) {
-        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
+    ownsSdl = true;
 
-    std::cout << "Creating renderer..." << std::endl;
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!renderer) {
-        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
+    if (options.headless) {
+        std::cout << "Creating offscreen software renderer..." << std::endl;
+        if (!createOffscreenRenderer()) {
+            return false;
+        }
+    } else {
+        std::cout << "Creating window..." << std::endl;
+        window = SDL_CreateWindow("2048", 
+                                SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                WINDOW_WIDTH, WINDOW_HEIGHT, 
+                                SDL_WINDOW_SHOWN);
+        if (!window) {
+            std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        std::cout << "Creating renderer..." << std::endl;
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (!renderer) {
+            std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
     }
 
     std::cout << "Initializing TTF..." << std::endl;
@@ -49,63 +111,214 @@ bool Game2048::init() {
     }
 
     std::cout << "Loading fonts..." << std::endl;
+    if (!loadFonts()) {
+        return false;
+    }
+
+    if (options.headless) {
+        // Chế độ headless không dùng âm thanh và không đụng tới savegame.dat
+        initializeNewGame();
+    } else {
+        std::cout << "Initializing SDL_mixer..." << std::endl;
+        if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+            std::cerr << "SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
+            return false;
+        }
+
+        if (options.recordSession.empty() && options.playSession.empty() && !options.netEnabled()) {
+            std::cout << "Loading game state..." << std::endl;
+            loadGame();
+        } else {
+            // Ghi/phát phiên và đấu mạng luôn bắt đầu từ trạng thái mới, không phụ thuộc savegame
+            initializeNewGame();
+        }
+    }
+
+    // Trọng số n-tuple chỉ được mmap, trang được nạp khi advisor tra tới
+    if (ntuple.map(options.weightsPath)) {
+        std::cout << "Mapped " << NTupleNetwork::presetName(ntuple.preset()) << " n-tuple weights from "
+                  << options.weightsPath << std::endl;
+    } else if (Strategies::needsNetwork(options.advisorName)) {
+        std::cerr << "N-tuple weights not found: " << options.weightsPath << std::endl;
+        return false;
+    }
+
+    if (openingBook.map(options.bookPath)) {
+        std::cout << "Mapped opening book with " << openingBook.size() << " positions from " << options.bookPath << std::endl;
+    }
+
+    if (!options.replayPath.empty()) {
+        if (!replayReader.load(options.replayPath)) {
+            return false;
+        }
+        std::cout << "Viewing replay " << options.replayPath << " (" << replayReader.moveCount() << " moves)" << std::endl;
+        viewingReplay = true;
+        replayPlaying = true;
+        seekReplay(0);
+    }
+
+    if (options.netEnabled()) {
+        net = new NetSession();
+        bool started = options.netHostPort > 0
+            ? net->host(options.netHostPort, ((uint64_t)rng() << 32) ^ rng())
+            : net->connect(options.netConnect);
+        if (!started) {
+            return false;
+        }
+        // Bàn cờ trống cho tới khi hai bên chào nhau và có seed chung
+        inMenu = false;
+        firstGame = false;
+        isMultiplayer = true;
+    }
+
+    if (!options.liveShm.empty() && !livePublisher.open(options.liveShm)) {
+        return false;
+    }
+
+    // Ván của headless, phát lại phiên hay input giả lập không phải ván thật của người chơi.
+    // Không mở được lịch sử hay bảng điểm thì vẫn chơi bình thường, chỉ không ghi
+    bool realGames = !options.headless && !sessionPlayer.isLoaded() && options.syntheticInputHz == 0 &&
+                     options.soakSeconds == 0;
+    if (realGames && !options.historyPath.empty() && history.open(options.historyPath)) {
+        std::cout << "Game history: " << history.size() << " games in " << options.historyPath << std::endl;
+    }
+    if (realGames && options.leaderboardSize > 0) {
+        leaderboard.open("leaderboard.dat", (uint32_t)options.leaderboardSize);
+        leaderboard2.open("leaderboard-2p.dat", (uint32_t)options.leaderboardSize);
+    }
+
+    std::cout << "Initialization complete!" << std::endl;
+    return true;
+}
+
+bool Game2048::createOffscreenRenderer() {
+    offscreenSurface = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!offscreenSurface) {
+        std::cerr << "Offscreen surface could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    renderer = SDL_CreateSoftwareRenderer(offscreenSurface);
+    if (!renderer) {
+        std::cerr << "Software renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Game2048::loadFonts() {
+    // Một lần mmap cho mọi cỡ chữ; không có pack thì mở file trong assets/
+    if (!assets.isReady() && !options.assetPackPath.empty() && assets.map(options.assetPackPath)) {
+        std::cout << "Asset pack: " << assets.size() << " assets in " << options.assetPackPath << std::endl;
+    }
+
     // Font cho số trên ô
-    font = TTF_OpenFont("assets/fonts/ClearSans-Bold.ttf", 40);
+    font = Resources::openFont(assets, "assets/fonts/ClearSans-Bold.ttf", 40);
     if (!font) {
         std::cerr << "Failed to load font! TTF_Error: " << TTF_GetError() << std::endl;
         return false;
     }
 
     // Font cho menu và nút
-    menuFont = TTF_OpenFont("assets/fonts/ClearSans-Bold.ttf", 20);
+    menuFont = Resources::openFont(assets, "assets/fonts/ClearSans-Bold.ttf", 20);
     if (!menuFont) {
         std::cerr << "Failed to load menu font! TTF_Error: " << TTF_GetError() << std::endl;
         return false;
     }
 
     // Font cho điểm số
-    scoreFont = TTF_OpenFont("assets/fonts/ClearSans-Bold.ttf", 24);
+    scoreFont = Resources::openFont(assets, "assets/fonts/ClearSans-Bold.ttf", 24);
     if (!scoreFont) {
         std::cerr << "Failed to load score font! TTF_Error: " << TTF_GetError() << std::endl;
         return false;
     }
+    return true;
+}
 
-    std::cout << "Initializing SDL_mixer..." << std::endl;
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-        std::cerr << "SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
+bool Game2048::initOffscreen(const GameOptions& gameOptions, const Replay::Reader& reader) {
+    options = gameOptions;
+    // Không ghi replay/savegame, không âm thanh: chỉ vẽ trình xem replay
+    options.replayDir.clear();
+    if (!createOffscreenRenderer() || !loadFonts()) {
         return false;
     }
-
-    std::cout << "Loading game state..." << std::endl;
-    loadGame();
-
-    std::cout << "Initialization complete!" << std::endl;
+    replayReader = reader;
+    viewingReplay = true;
+    replayPlaying = true;
+    replayStepMs = options.exportDelayMs;
+    inMenu = false;
     return true;
 }
 
-void Game2048::run() {
+bool Game2048::renderReplayFrame(uint32_t index, FrameCapture::Frame& frame) {
+    seekReplay(index);
+    render(-1, -1);
+    return FrameCapture::capture(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, frame);
+}
+
+bool Game2048::run() {
     std::cout << "Starting game loop..." << std::endl;
     bool quit = false;
     int mouseX = 0, mouseY = 0;
+    Uint32 loopStart = SDL_GetTicks();
+    syntheticStart = loopStart;
+    syntheticInjected = 0;
+    Uint32 nextScreenSwitch = loopStart + SOAK_SCREEN_SWITCH_SECONDS * 1000;
+    if (options.soakSeconds > 0) {
+        soakMonitor.start(loopStart, options.soakIntervalSeconds, options.soakSeconds);
+    }
+    sessionStart = loopStart;
+    sessionClock = 0;
+    if (!options.recordSession.empty() && !sessionRecorder.open(options.recordSession, options.seed)) {
+        return false;
+    }
+    if (sessionPlayer.isLoaded()) {
+        std::cout << "Playing session " << options.playSession << " (" << sessionPlayer.eventCount() << " events, "
+                  << sessionPlayer.duration() << " ms, " << (options.sessionFast ? "fast" : "realtime") << ")" << std::endl;
+        sessionFrameMs.reserve(sessionPlayer.duration() / SESSION_FRAME_MS + SESSION_FRAME_SLACK);
+    }
     
     while (!quit) {
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        frameStartCounter = frameStart;
+        AllocTracker::beginFrame();
+        if (options.soakSeconds > 0 && SDL_GetTicks() >= nextScreenSwitch) {
+            // Luân phiên màn một người / hai người chơi, khởi tạo lại như khi chọn từ menu
+            isMultiplayer = !isMultiplayer;
+            inMenu = true;
+            firstGame = true;
+            nextScreenSwitch += SOAK_SCREEN_SWITCH_SECONDS * 1000;
+        }
+        if (options.syntheticInputHz > 0) {
+            injectSyntheticInput();
+        }
         SDL_Event e;
-        while (SDL_PollEvent(&e)) {
+        while (pollEvent(e)) {
+            ALLOC_SCOPE("events");
             if (e.type == SDL_QUIT) {
                 std::cout << "Quit event received" << std::endl;
                 saveGame();  // Lưu game trước khi thoát
                 quit = true;
                 break;  // Thoát khỏi vòng lặp sự kiện
+            } else if (viewingReplay) {
+                handleReplayEvent(e);
+            } else if (inStats) {
+                handleStatsEvent(e);
             } else if (e.type == SDL_MOUSEMOTION) {
                 mouseX = e.motion.x;
                 mouseY = e.motion.y;
             } else if (e.type == SDL_MOUSEBUTTONDOWN) {
                 if (e.button.button == SDL_BUTTON_LEFT) {
-                    handleInput();  // Xử lý click chuột
+                    handleInput(e.button.x, e.button.y);  // Xử lý click chuột
                 }
             } else if (e.type == SDL_KEYDOWN && !e.key.repeat) {
-                if (!inMenu) {
+                if (e.key.keysym.sym == SDLK_F3) {
+                    showAllocHud = !showAllocHud;  // Bật/tắt HUD đếm cấp phát
+                } else if (e.key.keysym.sym == SDLK_F4) {
+                    showLatencyHud = !showLatencyHud;  // Bật/tắt overlay độ trễ
+                } else if (!inMenu) {
                     std::cout << "Key pressed: " << SDL_GetKeyName(e.key.keysym.sym) << std::endl;
+                    AllocTracker::beginMove();
+                    bool moved = false;
                     if (!isMultiplayer) {
                         // Chế độ một người chơi
                         switch (e.key.keysym.sym) {
@@ -113,34 +326,51 @@ void Game2048::run() {
                                 if (moveTiles(-1, 0)) {
                                     addNewTile();
                                     saveGame();  // Lưu sau mỗi nước đi
+                                    moved = true;
                                 }
                                 break;
                             case SDLK_RIGHT:
                                 if (moveTiles(1, 0)) {
                                     addNewTile();
                                     saveGame();  // Lưu sau mỗi nước đi
+                                    moved = true;
                                 }
                                 break;
                             case SDLK_UP:
                                 if (moveTiles(0, -1)) {
                                     addNewTile();
                                     saveGame();  // Lưu sau mỗi nước đi
+                                    moved = true;
                                 }
                                 break;
                             case SDLK_DOWN:
                                 if (moveTiles(0, 1)) {
                                     addNewTile();
                                     saveGame();  // Lưu sau mỗi nước đi
+                                    moved = true;
                                 }
                                 break;
                             case SDLK_ESCAPE:
                                 saveGame();  // Lưu game trước khi về menu
                                 inMenu = true;  // Chuyển về menu
                                 break;
+                            case SDLK_h:
+                                // Advisor chạy theo đồng hồ: tắt trong phiên ghi/phát lại
+                                if (!sessionRecorder.isOpen() && !sessionPlayer.isLoaded()) {
+                                    showHint();  // Gợi ý nước đi bằng advisor
+                                }
+                                break;
+                            case SDLK_p:
+                                if (!sessionRecorder.isOpen() && !sessionPlayer.isLoaded()) {
+                                    autoplay = !autoplay;  // Bật/tắt tự chơi
+                                }
+                                break;
                         }
+                    } else if (net) {
+                        // Đấu mạng: mũi tên hoặc WASD đều điều khiển bàn cờ của máy này
+                        moved = netLocalMove(e.key.keysym.sym);
                     } else {
                         // Chế độ hai người chơi
-                        bool moved = false;
                         switch (e.key.keysym.sym) {
                             // Người chơi 1 - WASD
                             case SDLK_a:
@@ -182,7 +412,7 @@ void Game2048::run() {
                             
                             // Người chơi 2 - Phím mũi tên
                             case SDLK_LEFT:
-                                if (!gameOver2) {
+                                if (!gameOver2 && !options.vsCpu) {
                                     if (moveTilesPlayer2(-1, 0)) {
                                         addNewTilePlayer2();
                                         if (!canMovePlayer2()) gameOver2 = true;
@@ -191,7 +421,7 @@ void Game2048::run() {
                                 }
                                 break;
                             case SDLK_RIGHT:
-                                if (!gameOver2) {
+                                if (!gameOver2 && !options.vsCpu) {
                                     if (moveTilesPlayer2(1, 0)) {
                                         addNewTilePlayer2();
                                         if (!canMovePlayer2()) gameOver2 = true;
@@ -200,7 +430,7 @@ void Game2048::run() {
                                 }
                                 break;
                             case SDLK_UP:
-                                if (!gameOver2) {
+                                if (!gameOver2 && !options.vsCpu) {
                                     if (moveTilesPlayer2(0, -1)) {
                                         addNewTilePlayer2();
                                         if (!canMovePlayer2()) gameOver2 = true;
@@ -209,7 +439,7 @@ void Game2048::run() {
                                 }
                                 break;
                             case SDLK_DOWN:
-                                if (!gameOver2) {
+                                if (!gameOver2 && !options.vsCpu) {
                                     if (moveTilesPlayer2(0, 1)) {
                                         addNewTilePlayer2();
                                         if (!canMovePlayer2()) gameOver2 = true;
@@ -226,20 +456,267 @@ void Game2048::run() {
                             saveGame();  // Lưu sau mỗi nước đi trong chế độ multiplayer
                         }
                     }
+                    AllocTracker::endMove();
+                    if (moved) {
+                        latencyTracker.onBoardChanged(e.key.timestamp);
+                    }
                 }
             }
         }
         
+        if (viewingReplay) {
+            updateReplayViewer();
+        }
+        if (autoplay && !inMenu && !isMultiplayer && !gameOver && !viewingReplay) {
+            autoplayStep();
+        }
+        if (options.vsCpu && !inMenu && isMultiplayer && !gameOver2) {
+            cpuStep();
+        }
+        if (net) {
+            netStep();
+        }
+        if (history.isOpen() || leaderboard.isOpen()) {
+            recordFinishedGames();
+        }
+        if (livePublisher.isOpen()) {
+            publishLiveState();  // trước render: người đọc thấy nước đi trước cả khi frame được vẽ
+        }
+        
         render(mouseX, mouseY);
-        SDL_Delay(16);  // Giới hạn FPS
+        double frameMs = (double)(SDL_GetPerformanceCounter() - frameStart) * 1000.0 / SDL_GetPerformanceFrequency();
+        if (options.soakSeconds > 0) {
+            soakMonitor.onFrame(SDL_GetTicks(), frameMs);
+        }
+        if (sessionPlayer.isLoaded()) {
+            sessionFrameMs.push_back((float)frameMs);
+            if (sessionPlayer.finished(sessionNow())) quit = true;
+        }
+        if (sessionPlayer.isLoaded() && options.sessionFast) {
+            sessionClock += SESSION_FRAME_MS;  // không chờ: mỗi frame tiến một khoảng ảo cố định
+        } else {
+            SDL_Delay(16);  // Giới hạn FPS
+        }
+
+        if (options.runSeconds > 0 && SDL_GetTicks() - loopStart >= (Uint32)options.runSeconds * 1000) {
+            quit = true;
+        }
     }
     
     std::cout << "Game loop ended" << std::endl;
+    if (sessionRecorder.isOpen()) {
+        sessionRecorder.close(SDL_GetTicks() - loopStart);
+    }
+    if (sessionPlayer.isLoaded()) {
+        reportSessionFrames();
+    }
+    if (latencyTracker.sampleCount() > 0) {
+        latencyTracker.printSummary(std::cout);
+    }
+    if (!options.latencyOut.empty()) {
+        if (latencyTracker.exportCsv(options.latencyOut)) {
+            std::cout << "Latency histogram written to " << options.latencyOut << std::endl;
+        } else {
+            std::cerr << "Cannot write latency histogram to " << options.latencyOut << std::endl;
+        }
+    }
+    if (AllocTracker::isCompiledIn()) {
+        AllocTracker::printReport(std::cout);
+        // Với --alloc-assert, vi phạm đã abort(); còn phải chắc các vùng đó thật sự đã chạy
+        if (options.allocAssert && AllocTracker::allocFreeEntries() == 0) {
+            std::cerr << "Allocation check: no allocation-free section ran" << std::endl;
+            return false;
+        }
+    }
+    if (options.soakSeconds > 0) {
+        soakMonitor.printReport(std::cout);
+        return !soakMonitor.leakDetected();
+    }
+    return true;
+}
+
+uint32_t Game2048::sessionNow() const {
+    return options.sessionFast ? sessionClock : SDL_GetTicks() - sessionStart;
+}
+
+bool Game2048::pollEvent(SDL_Event& e) {
+    if (sessionPlayer.isLoaded()) {
+        // Khi phát lại, event thật chỉ dùng để đóng cửa sổ
+        SDL_Event real;
+        while (SDL_PollEvent(&real)) {
+            if (real.type == SDL_QUIT) {
+                e = real;
+                return true;
+            }
+        }
+        return sessionPlayer.poll(sessionNow(), SDL_GetTicks(), e);
+    }
+    if (!SDL_PollEvent(&e)) return false;
+    if (sessionRecorder.isOpen()) {
+        sessionRecorder.record(e, SDL_GetTicks() - sessionStart);
+    }
+    return true;
+}
+
+void Game2048::reportSessionFrames() {
+    if (sessionFrameMs.empty()) return;
+    std::vector<float> sorted(sessionFrameMs);
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (size_t i = 0; i < sorted.size(); i++) total += sorted[i];
+    std::printf("Session frames: %zu, mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n", sorted.size(),
+                total / sorted.size(), sorted[sorted.size() / 2], sorted[sorted.size() * 95 / 100],
+                sorted[sorted.size() * 99 / 100], sorted.back());
+    if (options.frameTimesPath.empty()) return;
+    std::ofstream csv(options.frameTimesPath.c_str());
+    csv << "frame,ms\n";
+    for (size_t i = 0; i < sessionFrameMs.size(); i++) {
+        csv << i << ',' << sessionFrameMs[i] << '\n';
+    }
+    if (!csv) {
+        std::cerr << "Cannot write " << options.frameTimesPath << std::endl;
+    }
 }
 
-void Game2048::handleInput() {
-    int mouseX, mouseY;
-    SDL_GetMouseState(&mouseX, &mouseY);
+void Game2048::injectSyntheticInput() {
+    // Chuỗi phím cố định để benchmark lặp lại được
+    static const SDL_Keycode singleKeys[] = {SDLK_LEFT, SDLK_UP, SDLK_RIGHT, SDLK_UP};
+    static const SDL_Keycode multiKeys[] = {SDLK_a, SDLK_LEFT, SDLK_w, SDLK_UP, SDLK_d, SDLK_RIGHT, SDLK_w, SDLK_UP};
+
+    if (inMenu) {
+        inMenu = false;
+        if (firstGame) {
+            if (isMultiplayer) {
+                initializeMultiplayerBoards();
+            } else {
+                initializeBoard();
+            }
+            firstGame = false;
+        }
+    }
+    // Bắt đầu ván mới khi hết nước đi để luôn có phím làm thay đổi bàn cờ
+    if (!isMultiplayer && gameOver) {
+        initializeBoard();
+    } else if (isMultiplayer && gameOver && gameOver2) {
+        initializeMultiplayerBoards();
+    }
+
+    Uint32 elapsed = SDL_GetTicks() - syntheticStart;
+    Uint64 due = (Uint64)elapsed * options.syntheticInputHz / 1000;
+    while (syntheticInjected < due) {
+        SDL_Event event;
+        SDL_memset(&event, 0, sizeof(event));
+        event.type = SDL_KEYDOWN;
+        event.key.state = SDL_PRESSED;
+        if (isMultiplayer) {
+            event.key.keysym.sym = multiKeys[syntheticInjected % 8];
+        } else {
+            event.key.keysym.sym = singleKeys[syntheticInjected % 4];
+        }
+        SDL_PushEvent(&event);  // SDL gán timestamp lúc push
+        syntheticInjected++;
+    }
+}
+
+bool Game2048::runHeadless() {
+    struct HeadlessScreen {
+        const char* name;
+        bool menu;
+        bool multiplayer;
+    };
+    const HeadlessScreen screens[] = {
+        {"menu", true, false},
+        {"single", false, false},
+        {"multiplayer", false, true}
+    };
+    // Chuỗi nước đi cố định để bàn cờ có nhiều ô hơn trong ảnh golden
+    const int warmupMoves[][2] = {{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+    // Thiếu ảnh golden là lỗi ngay từ đầu: so sánh với thư mục rỗng không kiểm tra được gì
+    if (!options.goldenDir.empty()) {
+        int missing = 0;
+        for (const HeadlessScreen& screen : screens) {
+            struct stat info;
+            std::string path = options.goldenDir + "/" + screen.name + ".ppm";
+            if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+                std::cerr << "Missing golden image " << path << std::endl;
+                missing++;
+            }
+        }
+        if (missing > 0) {
+            std::cerr << "No complete golden set in " << options.goldenDir
+                      << "; render one with --dump-frames (make golden) on a reference build" << std::endl;
+            return false;
+        }
+    }
+
+    bool ok = true;
+    FrameCapture::Frame frame;
+    FrameCapture::Frame golden;
+    for (const HeadlessScreen& screen : screens) {
+        rng.seed(options.hasSeed ? options.seed : HEADLESS_DEFAULT_SEED);
+        if (screen.multiplayer) {
+            initializeMultiplayerBoards();
+        } else {
+            initializeBoard();
+        }
+        for (int i = 0; i < HEADLESS_WARMUP_MOVES; i++) {
+            const int* move = warmupMoves[i % 4];
+            if (moveTiles(move[0], move[1])) addNewTile();
+            if (screen.multiplayer && moveTilesPlayer2(move[1], move[0])) addNewTilePlayer2();
+        }
+        inMenu = screen.menu;
+        isMultiplayer = screen.multiplayer;
+
+        render(-1, -1);
+        if (!FrameCapture::capture(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, frame)) {
+            return false;
+        }
+
+        if (!options.dumpDir.empty()) {
+            std::string path = options.dumpDir + "/" + screen.name + ".ppm";
+            if (!FrameCapture::writePPM(path, frame)) {
+                ok = false;
+            } else {
+                std::cout << "Wrote " << path << std::endl;
+            }
+        }
+
+        if (!options.goldenDir.empty()) {
+            std::string path = options.goldenDir + "/" + screen.name + ".ppm";
+            if (!FrameCapture::readPPM(path, golden)) {
+                ok = false;
+            } else {
+                long diff = FrameCapture::countDiffPixels(frame, golden);
+                if (diff != 0) {
+                    std::cerr << "Golden mismatch for " << screen.name << ": "
+                              << (diff < 0 ? std::string("size differs") : std::to_string(diff) + " pixels differ")
+                              << std::endl;
+                    ok = false;
+                } else {
+                    std::cout << "Golden match: " << screen.name << std::endl;
+                }
+            }
+        }
+
+        if (options.benchFrames > 0) {
+            // Render liên tục không vsync, không SDL_Delay
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (int i = 0; i < options.benchFrames; i++) {
+                render(-1, -1);
+            }
+            double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+            std::cout << "Render benchmark " << screen.name << ": " << options.benchFrames << " frames in "
+                      << seconds << " s (" << (seconds > 0 ? options.benchFrames / seconds : 0.0) << " fps)" << std::endl;
+        }
+    }
+    return ok;
+}
+
+void Game2048::handleInput(int mouseX, int mouseY) {
+    if (net) {
+        return;  // Đấu mạng không có menu: đóng cửa sổ để rời trận
+    }
 
     if (inMenu) {
         // Kiểm tra click vào nút Single Player
@@ -279,6 +756,20 @@ void Game2048::handleInput() {
             saveGame();
             return;
         }
+
+        // Kiểm tra click vào nút Statistics
+        SDL_Rect statsButton = {
+            (WINDOW_WIDTH - BUTTON_WIDTH) / 2,
+            250 + 2 * (BUTTON_HEIGHT + BUTTON_MARGIN),
+            BUTTON_WIDTH,
+            BUTTON_HEIGHT
+        };
+
+        if (isMouseOverButton(mouseX, mouseY, statsButton)) {
+            inStats = true;
+            refreshStats();
+            return;
+        }
     } else {
         // Kiểm tra click vào nút Back
         SDL_Rect backButton = {
@@ -322,11 +813,16 @@ bool Game2048::isMouseOverButton(int mouseX, int mouseY, SDL_Rect buttonRect) {
 }
 
 void Game2048::render(int mouseX, int mouseY) {
+    ALLOC_SCOPE("render");
     // Xóa màn hình với màu nền
     SDL_SetRenderDrawColor(renderer, MENU_BACKGROUND.r, MENU_BACKGROUND.g, MENU_BACKGROUND.b, MENU_BACKGROUND.a);
     SDL_RenderClear(renderer);
     
-    if (inMenu) {
+    if (viewingReplay) {
+        drawReplayViewer();
+    } else if (inStats) {
+        drawStats();
+    } else if (inMenu) {
         drawMenu();
     } else if (isMultiplayer) {
         drawMultiplayerBoards();
@@ -339,19 +835,21 @@ void Game2048::render(int mouseX, int mouseY) {
         if (gameOver) {
             SDL_Color titleColor = TITLE_COLOR;
             std::string gameOverText = "Game Over!";
-            SDL_Surface* gameOverSurface = TTF_RenderText_Solid(font, gameOverText.c_str(), titleColor);
-            SDL_Texture* gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-            
-            SDL_Rect gameOverRect = {
-                (WINDOW_WIDTH - gameOverSurface->w) / 2,
-                WINDOW_HEIGHT - 150,
-                gameOverSurface->w,
-                gameOverSurface->h
-            };
-            
-            SDL_RenderCopy(renderer, gameOverTexture, NULL, &gameOverRect);
-            SDL_FreeSurface(gameOverSurface);
-            SDL_DestroyTexture(gameOverTexture);
+            SDL_Surface* gameOverSurface = Resources::renderText(font, gameOverText.c_str(), titleColor);
+            if (gameOverSurface) {
+                SDL_Texture* gameOverTexture = Resources::createTexture(renderer, gameOverSurface);
+                if (gameOverTexture) {
+                    SDL_Rect gameOverRect = {
+                        (WINDOW_WIDTH - gameOverSurface->w) / 2,
+                        WINDOW_HEIGHT - 150,
+                        gameOverSurface->w,
+                        gameOverSurface->h
+                    };
+                    SDL_RenderCopy(renderer, gameOverTexture, NULL, &gameOverRect);
+                    Resources::destroyTexture(gameOverTexture);
+                }
+                Resources::freeSurface(gameOverSurface);
+            }
             
             // Vẽ nút Back to Menu
             SDL_Rect menuButton = {
@@ -364,27 +862,61 @@ void Game2048::render(int mouseX, int mouseY) {
         }
     }
     
+    if (showAllocHud) {
+        drawAllocHud();
+    }
+    if (showLatencyHud) {
+        drawLatencyHud();
+    }
+    if (!inMenu && !viewingReplay && (!isMultiplayer || cpu)) {
+        drawAdvisorHud();
+    }
+    if (net) {
+        drawNetHud();
+    }
+    
     // Hiển thị kết quả
     SDL_RenderPresent(renderer);
+    latencyTracker.onPresent(SDL_GetTicks());
 }
 
 void Game2048::cleanup() {
+    finishReplay();
+    livePublisher.close();
+    if (advisor) {
+        delete advisor;
+        advisor = nullptr;
+    }
+    if (cpu) {
+        delete cpu;  // huỷ tìm kiếm đang chạy và join luồng
+        cpu = nullptr;
+    }
+    if (net) {
+        delete net;  // đóng socket và join luồng mạng
+        net = nullptr;
+    }
     if (score1Texture) {
-        SDL_DestroyTexture(score1Texture);
+        Resources::destroyTexture(score1Texture);
         score1Texture = nullptr;
     }
     if (score2Texture) {
-        SDL_DestroyTexture(score2Texture);
+        Resources::destroyTexture(score2Texture);
         score2Texture = nullptr;
     }
     if (player1NameTexture) {
-        SDL_DestroyTexture(player1NameTexture);
+        Resources::destroyTexture(player1NameTexture);
         player1NameTexture = nullptr;
     }
     if (player2NameTexture) {
-        SDL_DestroyTexture(player2NameTexture);
+        Resources::destroyTexture(player2NameTexture);
         player2NameTexture = nullptr;
     }
+    for (int i = 0; i < TILE_TEXT_CACHE_SIZE; i++) {
+        if (tileTextTextures[i]) {
+            Resources::destroyTexture(tileTextTextures[i]);
+            tileTextTextures[i] = nullptr;
+        }
+    }
     if (scoreFont) {
         TTF_CloseFont(scoreFont);
         scoreFont = nullptr;
@@ -401,51 +933,130 @@ void Game2048::cleanup() {
         SDL_DestroyRenderer(renderer);
         renderer = nullptr;
     }
+    if (offscreenSurface) {
+        SDL_FreeSurface(offscreenSurface);
+        offscreenSurface = nullptr;
+    }
     if (window) {
         SDL_DestroyWindow(window);
         window = nullptr;
     }
     
-    Mix_CloseAudio();
-    TTF_Quit();
-    SDL_Quit();
+    // Renderer của xuất replay dùng chung SDL/TTF do nơi khác khởi tạo
+    if (ownsSdl) {
+        Mix_CloseAudio();
+        TTF_Quit();
+        SDL_Quit();
+        ownsSdl = false;
+    }
 }
 
 void Game2048::initializeBoard() {
+    finishReplay();
+    newReplaySeed();
     board = std::vector<std::vector<int>>(GRID_SIZE, std::vector<int>(GRID_SIZE, 0));
     previousBoard = board;
     score = 0;
     previousScore = 0;
     gameOver = false;
+    resetHistoryTracking();
     addNewTile();
     addNewTile();
 }
 
 void Game2048::addNewTile() {
-    std::vector<std::pair<int, int>> emptyCells;
-    for (int i = 0; i < GRID_SIZE; i++) {
-        for (int j = 0; j < GRID_SIZE; j++) {
-            if (board[i][j] == 0) {
-                emptyCells.push_back({i, j});
-            }
+    ALLOC_SCOPE("addNewTile");
+    uint64_t rngBefore = spawnRng.state;
+    {
+        ALLOC_FREE_SECTION("addNewTile");
+        // Ô mới lấy từ RNG của Engine (seed riêng mỗi ván) để replay tái tạo được chỉ từ seed;
+        // RNG luôn được rút kể cả ở chế độ khó để dòng ngẫu nhiên không lệch
+        Engine::Board current = Engine::fromGrid(board);
+        Engine::Board spawned = Engine::spawnRandom(current, spawnRng);
+        int hardRow, hardCol, hardValue;
+        if (spawned != current && options.hardMode && pickHardSpawn(board, hardRow, hardCol, hardValue)) {
+            board[hardRow][hardCol] = hardValue;
+        } else if (spawned != current) {
+            int cell = __builtin_ctzll(spawned ^ current) / 4;
+            board[cell / GRID_SIZE][cell % GRID_SIZE] = Engine::valueOf(Engine::getCell(spawned, cell));
         }
     }
-    
-    if (!emptyCells.empty()) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> cellDist(0, emptyCells.size() - 1);
-        std::uniform_int_distribution<> valueDist(0, 9);
-        
-        int selectedCell = cellDist(gen);
-        int row = emptyCells[selectedCell].first;
-        int col = emptyCells[selectedCell].second;
-        board[row][col] = valueDist(gen) < 9 ? 2 : 4;
-    }
+    // Ghi replay ngoài vùng không cấp phát (bộ đệm replay thỉnh thoảng phải nới)
+    recordMove(rngBefore);
     
     if (!canMove()) {
         gameOver = true;
+        saveReplay(replayWriter, replaySeed, "");
+    }
+}
+
+void Game2048::newReplaySeed() {
+    lastMove = -1;
+    replaySeed = ((uint64_t)rng() << 32) ^ rng();
+    spawnRng = Engine::Rng(replaySeed);
+}
+
+void Game2048::newReplaySeedPlayer2() {
+    lastMove2 = -1;
+    replaySeed2 = ((uint64_t)rng() << 32) ^ rng();
+    spawnRng2 = Engine::Rng(replaySeed2);
+}
+
+void Game2048::recordMove(uint64_t rngBefore) {
+    int move = lastMove;
+    lastMove = -1;
+    if (move < 0 || options.headless || options.replayDir.empty()) return;
+    if (!replayWriter.isActive()) {
+        // Replay bắt đầu từ bàn cờ trước nước đi đầu tiên (cả khi ván được nạp từ savegame)
+        replayWriter.begin(replaySeed, Engine::fromGrid(previousBoard), rngBefore, previousScore);
     }
+    replayWriter.addMove(move, Engine::fromGrid(board));
+}
+
+void Game2048::recordMovePlayer2(uint64_t rngBefore) {
+    // Bàn cờ người chơi 2 có RNG riêng nên được ghi thành một replay một bàn cờ riêng
+    int move = lastMove2;
+    lastMove2 = -1;
+    if (move < 0 || options.headless || options.replayDir.empty()) return;
+    if (!replayWriter2.isActive()) {
+        replayWriter2.begin(replaySeed2, Engine::fromGrid(previousBoard2), rngBefore, previousScore2);
+    }
+    replayWriter2.addMove(move, Engine::fromGrid(board2));
+}
+
+void Game2048::finishReplay() {
+    saveReplay(replayWriter, replaySeed, "");
+    saveReplay(replayWriter2, replaySeed2, "-p2");
+}
+
+void Game2048::saveReplay(Replay::Writer& writer, uint64_t seed, const char* suffix) {
+    if (!writer.isActive()) return;
+    if (writer.moves() == 0) {
+        writer.reset();
+        return;
+    }
+    mkdir(options.replayDir.c_str(), 0755);  // thư mục đã có thì bỏ qua lỗi
+    char name[64];
+    std::snprintf(name, sizeof(name), "/%lld-%016llx%s.rpl", (long long)std::time(nullptr), (unsigned long long)seed, suffix);
+    std::string path = options.replayDir + name;
+    if (writer.save(path)) {
+        std::cout << "Saved replay " << path << std::endl;
+    }
+}
+
+bool Game2048::pickHardSpawn(const std::vector<std::vector<int>>& grid, int& row, int& col, int& value) {
+    // Chế độ khó: minimax chọn ô tệ nhất trong phần còn lại của frame (trừ phần chừa cho
+    // render), không quá --hard-ms. Hai người chơi sinh ô trong cùng frame thì lần sau ít hơn
+    double elapsedMs = (double)(SDL_GetPerformanceCounter() - frameStartCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    double budgetMs = std::max(HARD_SPAWN_MIN_MS,
+                               std::min(options.hardSpawnMs, FRAME_BUDGET_MS - HARD_SPAWN_RENDER_RESERVE_MS - elapsedMs));
+    int cell;
+    int exponent;
+    if (!spawner.choose(Engine::fromGrid(grid), budgetMs, HARD_SPAWN_MAX_DEPTH, cell, exponent)) return false;
+    row = cell / GRID_SIZE;
+    col = cell % GRID_SIZE;
+    value = Engine::valueOf(exponent);
+    return true;
 }
 
 bool Game2048::canMove() {
@@ -453,14 +1064,17 @@ bool Game2048::canMove() {
         for (int j = 0; j < GRID_SIZE; j++) {
             if (board[i][j] == 0) return true;
             
-            if (i < GRID_SIZE - 1 && board[i][j] == board[i + 1][j]) return true;
-            if (j < GRID_SIZE - 1 && board[i][j] == board[i][j + 1]) return true;
+            if (i < GRID_SIZE - 1 && board[i][j] == board[i + 1][j] && board[i][j] < MAX_TILE) return true;
+            if (j < GRID_SIZE - 1 && board[i][j] == board[i][j + 1] && board[i][j] < MAX_TILE) return true;
         }
     }
     return false;
 }
 
 bool Game2048::moveTiles(int dx, int dy) {
+    ALLOC_SCOPE("moveTiles");
+    ALLOC_FREE_SECTION("moveTiles");
+    lastMove = Engine::deltaToMove(dx, dy);
     try {
         std::cout << "Moving tiles for player 1..." << std::endl;
         if (dx == 0 && dy == 0) {
@@ -471,60 +1085,66 @@ bool Game2048::moveTiles(int dx, int dy) {
         // Tạo bản sao của bảng và điểm số
         previousBoard = board;
         previousScore = score;
-        auto tempBoard = board;
+        int tempBoard[GRID_SIZE][GRID_SIZE];
+        for (int row = 0; row < GRID_SIZE; row++) {
+            for (int col = 0; col < GRID_SIZE; col++) {
+                tempBoard[row][col] = board[row][col];
+            }
+        }
         bool moved = false;
 
         // Di chuyển ngang
         if (dx != 0) {
             for (int row = 0; row < GRID_SIZE; row++) {
-                std::vector<int> line;
+                int line[GRID_SIZE];
+                int lineSize = 0;
                 
                 // Thu thập các số khác 0
                 if (dx < 0) {
                     // Di chuyển sang trái
                     for (int col = 0; col < GRID_SIZE; col++) {
                         if (tempBoard[row][col] != 0) {
-                            line.push_back(tempBoard[row][col]);
+                            line[lineSize++] = tempBoard[row][col];
                         }
                     }
                 } else {
                     // Di chuyển sang phải
                     for (int col = GRID_SIZE - 1; col >= 0; col--) {
                         if (tempBoard[row][col] != 0) {
-                            line.push_back(tempBoard[row][col]);
+                            line[lineSize++] = tempBoard[row][col];
                         }
                     }
                 }
                 
                 // Nếu không có số nào, bỏ qua hàng này
-                if (line.empty()) {
+                if (lineSize == 0) {
                     continue;
                 }
                 
                 // Gộp các số giống nhau
-                for (size_t i = 0; i < line.size() - 1; i++) {
-                    if (line[i] == line[i + 1]) {
+                for (int i = 0; i < lineSize - 1; i++) {
+                    if (line[i] == line[i + 1] && line[i] < MAX_TILE) {
                         line[i] *= 2;
                         score += line[i];
-                        line.erase(line.begin() + i + 1);
+                        for (int k = i + 1; k < lineSize - 1; k++) {
+                            line[k] = line[k + 1];
+                        }
+                        lineSize--;
                         updateBestScore();  // Cập nhật điểm cao nhất
                     }
                 }
                 
                 // Điền số 0 vào cuối nếu cần
-                while (line.size() < GRID_SIZE) {
-                    if (dx < 0) {
-                        line.push_back(0);
-                    } else {
-                        line.insert(line.begin(), 0);
-                    }
+                while (lineSize < GRID_SIZE) {
+                    line[lineSize++] = 0;
                 }
                 
-                // Cập nhật bảng
-                for (int col = 0; col < GRID_SIZE; col++) {
-                    if (tempBoard[row][col] != line[col]) {
+                // Cập nhật bảng: line[0] là ô sát cạnh theo hướng di chuyển
+                for (int k = 0; k < GRID_SIZE; k++) {
+                    int col = (dx < 0) ? k : (GRID_SIZE - 1 - k);
+                    if (tempBoard[row][col] != line[k]) {
                         moved = true;
-                        tempBoard[row][col] = line[col];
+                        tempBoard[row][col] = line[k];
                     }
                 }
             }
@@ -532,54 +1152,55 @@ bool Game2048::moveTiles(int dx, int dy) {
         // Di chuyển dọc
         else if (dy != 0) {
             for (int col = 0; col < GRID_SIZE; col++) {
-                std::vector<int> line;
+                int line[GRID_SIZE];
+                int lineSize = 0;
                 
                 // Thu thập các số khác 0
                 if (dy < 0) {
                     // Di chuyển lên
                     for (int row = 0; row < GRID_SIZE; row++) {
                         if (tempBoard[row][col] != 0) {
-                            line.push_back(tempBoard[row][col]);
+                            line[lineSize++] = tempBoard[row][col];
                         }
                     }
                 } else {
                     // Di chuyển xuống
                     for (int row = GRID_SIZE - 1; row >= 0; row--) {
                         if (tempBoard[row][col] != 0) {
-                            line.push_back(tempBoard[row][col]);
+                            line[lineSize++] = tempBoard[row][col];
                         }
                     }
                 }
                 
                 // Nếu không có số nào, bỏ qua cột này
-                if (line.empty()) {
+                if (lineSize == 0) {
                     continue;
                 }
                 
                 // Gộp các số giống nhau
-                for (size_t i = 0; i < line.size() - 1; i++) {
-                    if (line[i] == line[i + 1]) {
+                for (int i = 0; i < lineSize - 1; i++) {
+                    if (line[i] == line[i + 1] && line[i] < MAX_TILE) {
                         line[i] *= 2;
                         score += line[i];
-                        line.erase(line.begin() + i + 1);
+                        for (int k = i + 1; k < lineSize - 1; k++) {
+                            line[k] = line[k + 1];
+                        }
+                        lineSize--;
                         updateBestScore();  // Cập nhật điểm cao nhất
                     }
                 }
                 
                 // Điền số 0 vào cuối nếu cần
-                while (line.size() < GRID_SIZE) {
-                    if (dy < 0) {
-                        line.push_back(0);
-                    } else {
-                        line.insert(line.begin(), 0);
-                    }
+                while (lineSize < GRID_SIZE) {
+                    line[lineSize++] = 0;
                 }
                 
-                // Cập nhật bảng
-                for (int row = 0; row < GRID_SIZE; row++) {
-                    if (tempBoard[row][col] != line[row]) {
+                // Cập nhật bảng: line[0] là ô sát cạnh theo hướng di chuyển
+                for (int k = 0; k < GRID_SIZE; k++) {
+                    int row = (dy < 0) ? k : (GRID_SIZE - 1 - k);
+                    if (tempBoard[row][col] != line[k]) {
                         moved = true;
-                        tempBoard[row][col] = line[row];
+                        tempBoard[row][col] = line[k];
                     }
                 }
             }
@@ -587,7 +1208,13 @@ bool Game2048::moveTiles(int dx, int dy) {
 
         // Chỉ cập nhật bảng chính nếu có di chuyển
         if (moved) {
-            board = tempBoard;
+            for (int row = 0; row < GRID_SIZE; row++) {
+                for (int col = 0; col < GRID_SIZE; col++) {
+                    board[row][col] = tempBoard[row][col];
+                }
+            }
+            liveMoves++;
+            gameMoves++;
         }
 
         std::cout << "Move complete, moved = " << moved << std::endl;
@@ -632,6 +1259,10 @@ void Game2048::updateBestScore() {
 }
 
 void Game2048::saveGame() {
+    ALLOC_SCOPE("saveGame");
+    if (options.headless || sessionPlayer.isLoaded() || net) {
+        return;  // Không ghi đè savegame của người chơi khi chạy headless, phát lại phiên hoặc đấu mạng
+    }
     std::cout << "Saving game state..." << std::endl;
     std::ofstream file("savegame.dat", std::ios::binary | std::ios::trunc);
     if (!file.is_open()) {
@@ -780,6 +1411,10 @@ void Game2048::loadGame() {
         if (file.fail()) throw std::runtime_error("Lỗi khi đọc previousScore2");
         
         file.close();
+        // Ván đã kết thúc trong savegame đã được ghi vào lịch sử lúc kết thúc
+        resetHistoryTracking();
+        historyRecorded = gameOver;
+        historyRecorded2 = gameOver2;
         std::cout << "Đã tải trạng thái game thành công!" << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "Lỗi khi tải game: " << e.what() << std::endl;
@@ -803,6 +1438,7 @@ void Game2048::initializeNewGame() {
     board2 = std::vector<std::vector<int>>(GRID_SIZE, std::vector<int>(GRID_SIZE, 0));
     previousBoard = board;
     previousBoard2 = board2;
+    resetHistoryTracking();
 }
 
 void Game2048::drawRoundedRect(SDL_Rect rect, SDL_Color color, int radius) {
@@ -860,17 +1496,39 @@ void Game2048::drawRoundedRect(SDL_Rect rect, SDL_Color color, int radius) {
 }
 
 void Game2048::drawTile(int value, SDL_Rect rect) {
+    ALLOC_SCOPE("drawTile");
     // Vẽ background của ô với góc bo tròn
     SDL_Color color = getTileColor(value);
     drawRoundedRect(rect, color, 8);  // Tăng độ bo tròn từ 6 lên 8 để làm nét hơn
 
     // Nếu giá trị khác 0, vẽ số
     if (value != 0) {
+        // Số trên ô chỉ có vài giá trị: render chữ một lần rồi dùng lại texture
+        int exponent = 0;
+        while ((1 << exponent) < value && exponent < TILE_TEXT_CACHE_SIZE) exponent++;
+        if (exponent < TILE_TEXT_CACHE_SIZE && (1 << exponent) == value) {
+            if (!tileTextTextures[exponent]) {
+                std::string text = std::to_string(value);
+                SDL_Color textColor = (value <= 4) ? TITLE_COLOR : TEXT_COLOR;
+                SDL_Surface* textSurface = Resources::renderText(font, text.c_str(), textColor);
+                if (!textSurface) return;
+                tileTextTextures[exponent] = Resources::createTexture(renderer, textSurface);
+                tileTextRects[exponent] = {0, 0, textSurface->w, textSurface->h};
+                Resources::freeSurface(textSurface);
+                if (!tileTextTextures[exponent]) return;
+            }
+            SDL_Rect textRect = tileTextRects[exponent];
+            textRect.x = rect.x + (rect.w - textRect.w) / 2;
+            textRect.y = rect.y + (rect.h - textRect.h) / 2;
+            SDL_RenderCopy(renderer, tileTextTextures[exponent], NULL, &textRect);
+            return;
+        }
+
         std::string text = std::to_string(value);
         SDL_Color textColor = (value <= 4) ? TITLE_COLOR : TEXT_COLOR;
-        SDL_Surface* textSurface = TTF_RenderText_Solid(font, text.c_str(), textColor);
+        SDL_Surface* textSurface = Resources::renderText(font, text.c_str(), textColor);
         if (textSurface) {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+            SDL_Texture* textTexture = Resources::createTexture(renderer, textSurface);
             if (textTexture) {
                 SDL_Rect textRect = {
                     rect.x + (rect.w - textSurface->w) / 2,
@@ -879,14 +1537,15 @@ void Game2048::drawTile(int value, SDL_Rect rect) {
                     textSurface->h
                 };
                 SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-                SDL_DestroyTexture(textTexture);
+                Resources::destroyTexture(textTexture);
             }
-            SDL_FreeSurface(textSurface);
+            Resources::freeSurface(textSurface);
         }
     }
 }
 
 void Game2048::drawScore(const char* label, int value, int x, int y) {
+    ALLOC_SCOPE("drawScore");
     SDL_Rect scoreBox = {x, y, 100, 60};  // Giữ nguyên kích thước
     SDL_Color boxColor = {205, 193, 180, 255};  // Màu nâu nhạt
     drawRoundedRect(scoreBox, boxColor, 8);  // Tăng độ bo tròn từ 5 lên 8
@@ -894,9 +1553,9 @@ void Game2048::drawScore(const char* label, int value, int x, int y) {
     SDL_Color textColor = {255, 255, 255, 255};  // Màu trắng cho cả nhãn và giá trị
     
     // Vẽ nhãn với font nhỏ hơn
-    SDL_Surface* labelSurface = TTF_RenderText_Solid(menuFont, label, textColor);
+    SDL_Surface* labelSurface = Resources::renderText(menuFont, label, textColor);
     if (labelSurface) {
-        SDL_Texture* labelTexture = SDL_CreateTextureFromSurface(renderer, labelSurface);
+        SDL_Texture* labelTexture = Resources::createTexture(renderer, labelSurface);
         if (labelTexture) {
             SDL_Rect labelRect = {
                 x + (scoreBox.w - labelSurface->w) / 2,
@@ -905,16 +1564,16 @@ void Game2048::drawScore(const char* label, int value, int x, int y) {
                 labelSurface->h
             };
             SDL_RenderCopy(renderer, labelTexture, NULL, &labelRect);
-            SDL_DestroyTexture(labelTexture);
+            Resources::destroyTexture(labelTexture);
         }
-        SDL_FreeSurface(labelSurface);
+        Resources::freeSurface(labelSurface);
     }
     
     // Vẽ giá trị điểm
     std::string scoreStr = std::to_string(value);
-    SDL_Surface* scoreSurface = TTF_RenderText_Solid(scoreFont, scoreStr.c_str(), textColor);
+    SDL_Surface* scoreSurface = Resources::renderText(scoreFont, scoreStr.c_str(), textColor);
     if (scoreSurface) {
-        SDL_Texture* scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
+        SDL_Texture* scoreTexture = Resources::createTexture(renderer, scoreSurface);
         if (scoreTexture) {
             SDL_Rect scoreRect = {
                 x + (scoreBox.w - scoreSurface->w) / 2,
@@ -923,21 +1582,22 @@ void Game2048::drawScore(const char* label, int value, int x, int y) {
                 scoreSurface->h
             };
             SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreRect);
-            SDL_DestroyTexture(scoreTexture);
+            Resources::destroyTexture(scoreTexture);
         }
-        SDL_FreeSurface(scoreSurface);
+        Resources::freeSurface(scoreSurface);
     }
 }
 
 void Game2048::drawButton(const std::string& text, SDL_Rect rect) {
+    ALLOC_SCOPE("drawButton");
     // Vẽ background của nút với góc bo tròn
     SDL_Color buttonColor = BUTTON_COLOR;
     drawRoundedRect(rect, buttonColor, 8);  // Tăng độ bo tròn từ 5 lên 8
 
     // Vẽ text với font menuFont và màu sáng hơn
-    SDL_Surface* textSurface = TTF_RenderText_Solid(menuFont, text.c_str(), TEXT_COLOR);
+    SDL_Surface* textSurface = Resources::renderText(menuFont, text.c_str(), TEXT_COLOR);
     if (textSurface) {
-        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+        SDL_Texture* textTexture = Resources::createTexture(renderer, textSurface);
         if (textTexture) {
             SDL_Rect textRect = {
                 rect.x + (rect.w - textSurface->w) / 2,
@@ -946,9 +1606,561 @@ void Game2048::drawButton(const std::string& text, SDL_Rect rect) {
                 textSurface->h
             };
             SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-            SDL_DestroyTexture(textTexture);
+            Resources::destroyTexture(textTexture);
+        }
+        Resources::freeSurface(textSurface);
+    }
+}
+
+void Game2048::drawAllocHud() {
+    ALLOC_SCOPE("allocHud");
+    char text[128];
+    if (!AllocTracker::isCompiledIn()) {
+        std::snprintf(text, sizeof(text), "alloc tracking off (make TRACK_ALLOCS=1)");
+    } else {
+        AllocTracker::Counts frame = AllocTracker::lastFrame();
+        AllocTracker::Counts move = AllocTracker::lastMove();
+        std::snprintf(text, sizeof(text), "frame: %llu allocs / %llu B   move: %llu allocs / %llu B   violations: %llu",
+                      (unsigned long long)frame.allocs, (unsigned long long)frame.bytes,
+                      (unsigned long long)move.allocs, (unsigned long long)move.bytes,
+                      (unsigned long long)AllocTracker::violations());
+    }
+
+    SDL_Surface* hudSurface = Resources::renderText(menuFont, text, TITLE_COLOR);
+    if (hudSurface) {
+        SDL_Texture* hudTexture = Resources::createTexture(renderer, hudSurface);
+        if (hudTexture) {
+            SDL_Rect hudRect = {
+                10,
+                WINDOW_HEIGHT - hudSurface->h - 5,
+                hudSurface->w,
+                hudSurface->h
+            };
+            SDL_RenderCopy(renderer, hudTexture, NULL, &hudRect);
+            Resources::destroyTexture(hudTexture);
+        }
+        Resources::freeSurface(hudSurface);
+    }
+}
+
+void Game2048::drawLatencyHud() {
+    char text[160];
+    latencyTracker.formatSummary(text, sizeof(text));
+
+    SDL_Surface* hudSurface = Resources::renderText(menuFont, text, TITLE_COLOR);
+    if (hudSurface) {
+        SDL_Texture* hudTexture = Resources::createTexture(renderer, hudSurface);
+        if (hudTexture) {
+            SDL_Rect hudRect = {
+                10,
+                WINDOW_HEIGHT - 2 * hudSurface->h - 10,
+                hudSurface->w,
+                hudSurface->h
+            };
+            SDL_RenderCopy(renderer, hudTexture, NULL, &hudRect);
+            Resources::destroyTexture(hudTexture);
         }
-        SDL_FreeSurface(textSurface);
+        Resources::freeSurface(hudSurface);
+    }
+}
+
+Advisor* Game2048::getAdvisor() {
+    // Chỉ tạo thread pool khi người chơi dùng tới gợi ý/tự chơi
+    if (advisor) return advisor;
+    Advisor* search = nullptr;
+    if (options.advisorName != "auto" && options.advisorName != "rollout") {
+        std::string error;
+        search = Strategies::create(options.advisorName, &ntuple, rng(), error);
+        if (!search) std::cerr << "Cannot create advisor: " << error << std::endl;
+    }
+    if (!search && ntuple.isReady() && options.advisorName == "auto") {
+        search = new NTupleAdvisor(ntuple);
+    } else if (!search) {
+        RolloutAdvisor::Config config;
+        config.threads = options.advisorThreads;
+        config.budgetMs = options.advisorMs;
+        RolloutAdvisor::parsePolicy(options.advisorPolicy.c_str(), config.policy);
+        config.seed = rng();
+        search = new RolloutAdvisor(config);
+    }
+    // Đầu ván tra opening book, không cần tìm kiếm
+    advisor = openingBook.isReady() ? new BookAdvisor(openingBook, search) : search;
+    return advisor;
+}
+
+void Game2048::showHint() {
+    if (gameOver) return;
+    hintBoard = Engine::fromGrid(board);
+    hintMove = getAdvisor()->chooseMove(hintBoard);
+    hintValue = advisor->lastValue();
+}
+
+void Game2048::autoplayStep() {
+    Engine::Board current = Engine::fromGrid(board);
+    int move = getAdvisor()->chooseMove(current);
+    if (move < 0) {
+        autoplay = false;
+        return;
+    }
+    int dx, dy;
+    Engine::moveToDelta(move, dx, dy);
+    AllocTracker::beginMove();
+    if (moveTiles(dx, dy)) {
+        addNewTile();
+        saveGame();
+    }
+    AllocTracker::endMove();
+}
+
+void Game2048::cpuStep() {
+    if (!cpu) {
+        cpu = new CpuOpponent(ntuple.isReady() ? &ntuple : nullptr);
+    }
+    // Chỉ gửi yêu cầu khi bàn cờ đổi; luồng CPU suy nghĩ trong lúc chờ nhịp đi
+    Engine::Board current = Engine::fromGrid(board2);
+    if (current != cpuRequestBoard) {
+        cpu->request(current, options.cpuMoveMs);
+        cpuRequestBoard = current;
+        return;
+    }
+    int move;
+    if (SDL_GetTicks() < cpuNextMoveTicks || !cpu->poll(current, move)) return;
+    if (move < 0) {
+        gameOver2 = true;
+        return;
+    }
+    int dx, dy;
+    Engine::moveToDelta(move, dx, dy);
+    if (moveTilesPlayer2(dx, dy)) {
+        addNewTilePlayer2();
+        if (!canMovePlayer2()) gameOver2 = true;
+        saveGame();
+    }
+    cpuNextMoveTicks = SDL_GetTicks() + (Uint32)options.cpuPaceMs;
+}
+
+void Game2048::netStep() {
+    if (!netStarted) {
+        if (net->state() != NetSession::STATE_READY) return;
+        // Cùng seed cho cả hai bàn cờ ở cả hai máy: mỗi bên tự sinh ô mới của đối thủ
+        spawnRng = Engine::Rng(net->seed());
+        spawnRng2 = Engine::Rng(net->seed());
+        initializeMultiplayerBoards();
+        netStarted = true;
+        netDesync = false;
+        netLocalMoves = 0;
+        netRemoteMoves = 0;
+    }
+
+    // Áp dụng nước của đối thủ lên bản sao bàn cờ của họ, so hash định kỳ
+    bool remoteIsPlayer1 = !net->isHost();
+    NetSession::Message message;
+    while (!netDesync && net->nextMessage(message)) {
+        if (message.type == NetSession::MESSAGE_MOVE) {
+            int dx, dy;
+            Engine::moveToDelta(message.move, dx, dy);
+            bool moved = remoteIsPlayer1 ? moveTiles(dx, dy) : moveTilesPlayer2(dx, dy);
+            if (!moved) {
+                netDesync = true;
+            } else if (remoteIsPlayer1) {
+                addNewTile();
+            } else {
+                addNewTilePlayer2();
+            }
+            netRemoteMoves++;
+        } else {
+            uint32_t expected = remoteIsPlayer1 ? NetSession::boardHash(Engine::fromGrid(board), score)
+                                                : NetSession::boardHash(Engine::fromGrid(board2), score2);
+            netDesync = expected != message.hash;
+        }
+        if (netDesync) {
+            std::cerr << "Desync detected after " << netRemoteMoves << " opponent moves" << std::endl;
+        }
+    }
+}
+
+bool Game2048::netLocalMove(SDL_Keycode key) {
+    if (!netStarted || net->state() != NetSession::STATE_READY) return false;
+    int dx = 0, dy = 0;
+    switch (key) {
+        case SDLK_LEFT: case SDLK_a: dx = -1; break;
+        case SDLK_RIGHT: case SDLK_d: dx = 1; break;
+        case SDLK_UP: case SDLK_w: dy = -1; break;
+        case SDLK_DOWN: case SDLK_s: dy = 1; break;
+        default: return false;
+    }
+
+    bool localIsPlayer1 = net->isHost();
+    if (localIsPlayer1 ? gameOver : gameOver2) return false;
+    if (localIsPlayer1 ? !moveTiles(dx, dy) : !moveTilesPlayer2(dx, dy)) return false;
+    if (localIsPlayer1) {
+        addNewTile();
+    } else {
+        addNewTilePlayer2();
+    }
+
+    // Chỉ gửi nước đi; cứ NET_HASH_INTERVAL nước gửi thêm hash để bên kia kiểm tra
+    net->sendMove(Engine::deltaToMove(dx, dy));
+    netLocalMoves++;
+    if (netLocalMoves % NET_HASH_INTERVAL == 0) {
+        net->sendHash(localIsPlayer1 ? NetSession::boardHash(Engine::fromGrid(board), score)
+                                     : NetSession::boardHash(Engine::fromGrid(board2), score2));
+    }
+    return true;
+}
+
+void Game2048::drawNetHud() {
+    char text[160];
+    if (netDesync) {
+        std::snprintf(text, sizeof(text), "DESYNC after %u opponent moves", netRemoteMoves);
+    } else if (!netStarted || net->state() == NetSession::STATE_CLOSED) {
+        std::snprintf(text, sizeof(text), "%s", net->status().c_str());
+    } else if (net->lastRttMs() < 0) {
+        std::snprintf(text, sizeof(text), "RTT: measuring...");
+    } else {
+        std::snprintf(text, sizeof(text), "RTT %.2f ms (min %.2f)   sent %llu B   received %llu B", net->lastRttMs(),
+                      net->minRttMs(), (unsigned long long)net->bytesSent(), (unsigned long long)net->bytesReceived());
+    }
+
+    SDL_Surface* hudSurface = Resources::renderText(menuFont, text, TITLE_COLOR);
+    if (hudSurface) {
+        SDL_Texture* hudTexture = Resources::createTexture(renderer, hudSurface);
+        if (hudTexture) {
+            SDL_Rect hudRect = {ADVISOR_HUD_X, ADVISOR_HUD_Y, hudSurface->w, hudSurface->h};
+            SDL_RenderCopy(renderer, hudTexture, NULL, &hudRect);
+            Resources::destroyTexture(hudTexture);
+        }
+        Resources::freeSurface(hudSurface);
+    }
+}
+
+void Game2048::publishLiveState() {
+    Live2048Snapshot snapshot;
+    std::memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.board = Engine::fromGrid(board);
+    snapshot.board2 = isMultiplayer ? Engine::fromGrid(board2) : 0;
+    snapshot.score = score;
+    snapshot.score2 = isMultiplayer ? score2 : 0;
+    snapshot.flags = (gameOver ? LIVE2048_GAME_OVER : 0) | (isMultiplayer && gameOver2 ? LIVE2048_GAME_OVER2 : 0) |
+                     (isMultiplayer ? LIVE2048_MULTIPLAYER : 0) | (inMenu ? LIVE2048_IN_MENU : 0);
+    snapshot.writerPid = (uint32_t)getpid();
+    snapshot.moves = liveMoves;
+    // Không đổi gì thì không ghi: cache line của người đọc không bị vô hiệu hoá mỗi frame
+    if (std::memcmp(&snapshot, &livePublished, sizeof(snapshot)) == 0) return;
+    livePublished = snapshot;
+    livePublisher.publish(snapshot);
+}
+
+void Game2048::resetHistoryTracking() {
+    gameStartTicks = SDL_GetTicks();
+    gameMoves = 0;
+    gameMoves2 = 0;
+    historyRecorded = false;
+    historyRecorded2 = false;
+}
+
+void Game2048::recordFinishedGames() {
+    // Đấu mạng: mỗi máy chỉ ghi ván của người chơi tại máy đó, ván của đối thủ do máy kia ghi
+    bool local1 = !net || net->isHost();
+    bool local2 = !net || !net->isHost();
+    if (gameOver && !historyRecorded) {
+        historyRecorded = true;
+        if (local1) recordResult(1);
+    }
+    if (isMultiplayer && gameOver2 && !historyRecorded2) {
+        historyRecorded2 = true;
+        if (local2) recordResult(2);
+    }
+}
+
+void Game2048::recordResult(int player) {
+    GameHistory::Record record;
+    std::memset(&record, 0, sizeof(record));
+    record.timestamp = (int64_t)std::time(nullptr);
+    record.durationMs = SDL_GetTicks() - gameStartTicks;
+    record.player = (uint8_t)player;
+    if (!isMultiplayer) {
+        record.mode = options.hardMode ? GameHistory::MODE_HARD : GameHistory::MODE_SINGLE;
+        record.seed = replaySeed;
+    } else {
+        record.mode = net ? GameHistory::MODE_NET : options.vsCpu ? GameHistory::MODE_VS_CPU : GameHistory::MODE_LOCAL;
+        // Hai người chơi cục bộ dùng tiếp dòng RNG đang chạy nên không có seed tái tạo được
+        record.seed = net ? net->seed() : 0;
+    }
+    record.score = player == 1 ? score : score2;
+    record.moves = player == 1 ? gameMoves : gameMoves2;
+    record.maxTile = (uint8_t)Engine::maxExponent(Engine::fromGrid(player == 1 ? board : board2));
+    if (history.isOpen()) {
+        history.append(record);
+    }
+
+    Leaderboard::Entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.score = record.score;
+    entry.mode = record.mode;
+    entry.player = record.player;
+    entry.maxTile = record.maxTile;
+    entry.timestamp = record.timestamp;
+    Leaderboard& scores = isMultiplayer ? leaderboard2 : leaderboard;
+    uint32_t rank = scores.insert(entry);
+    if (rank > 0) {
+        std::cout << "High score #" << rank << ": " << entry.score << std::endl;
+    }
+}
+
+void Game2048::refreshStats() {
+    uint32_t mask = statsMode < 0 ? GameHistory::ALL_MODES : 1u << statsMode;
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (!history.query(mask, historyStats)) {
+        std::memset(&historyStats, 0, sizeof(historyStats));
+    }
+    statsQueryMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void Game2048::handleStatsEvent(const SDL_Event& e) {
+    if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
+        SDL_Rect backButton = {10, 10, 80, 30};
+        if (isMouseOverButton(e.button.x, e.button.y, backButton)) {
+            inStats = false;  // về menu
+        }
+    } else if (e.type == SDL_KEYDOWN) {
+        switch (e.key.keysym.sym) {
+            case SDLK_m:
+            case SDLK_RIGHT:
+                statsMode = statsMode + 1 >= GameHistory::MODE_COUNT ? -1 : statsMode + 1;
+                refreshStats();
+                break;
+            case SDLK_LEFT:
+                statsMode = statsMode < 0 ? GameHistory::MODE_COUNT - 1 : statsMode - 1;
+                refreshStats();
+                break;
+            case SDLK_ESCAPE:
+                inStats = false;
+                break;
+        }
+    }
+}
+
+void Game2048::drawLabel(const char* text, int x, int y) {
+    SDL_Surface* textSurface = Resources::renderText(menuFont, text, TITLE_COLOR);
+    if (textSurface) {
+        SDL_Texture* textTexture = Resources::createTexture(renderer, textSurface);
+        if (textTexture) {
+            SDL_Rect textRect = {x, y, textSurface->w, textSurface->h};
+            SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
+            Resources::destroyTexture(textTexture);
+        }
+        Resources::freeSurface(textSurface);
+    }
+}
+
+void Game2048::drawStats() {
+    SDL_Rect backButton = {10, 10, 80, 30};
+    drawButton("Back", backButton);
+
+    char text[192];
+    std::snprintf(text, sizeof(text), "Statistics: %s   (M / arrows: mode, Esc: back)   %llu games, query %.2f ms",
+                  statsMode < 0 ? "all modes" : GameHistory::modeName(statsMode),
+                  (unsigned long long)historyStats.records, statsQueryMs);
+    drawLabel(text, STATS_TEXT_X, STATS_TEXT_Y);
+
+    const GameHistory::Summary& total = historyStats.total;
+    if (!history.isOpen() || total.count == 0) {
+        drawLabel(history.isOpen() ? "No finished games yet" : "Game history is off (--history FILE)", STATS_X, STATS_CHART_Y);
+        return;
+    }
+    std::snprintf(text, sizeof(text), "Games %u   Best %d   Average %.0f   Last %u: %.0f   Moves/game %.0f   Time/game %.0f s",
+                  total.count, total.bestScore, total.averageScore(), historyStats.recentCount, historyStats.recentAverage,
+                  (double)total.moveSum / total.count, total.durationSum / 1000.0 / total.count);
+    drawLabel(text, STATS_X, STATS_TEXT_Y + 40);
+
+    // Histogram điểm theo lũy thừa của 2; bucket thấp hơn số hàng hiển thị được gộp vào hàng đầu
+    int first = 0;
+    int last = GameHistory::SCORE_BUCKETS - 1;
+    while (first < last && total.scoreBuckets[first] == 0) first++;
+    while (last > first && total.scoreBuckets[last] == 0) last--;
+    uint32_t lowerCount = 0;
+    while (last - first + 1 > STATS_MAX_ROWS) lowerCount += total.scoreBuckets[first++];
+    uint32_t peak = 1;
+    for (int b = first; b <= last; b++) peak = std::max(peak, total.scoreBuckets[b] + (b == first ? lowerCount : 0));
+    drawLabel("Final score", STATS_X, STATS_CHART_Y - 28);
+    SDL_Color barColor = BUTTON_COLOR;
+    for (int b = first; b <= last; b++) {
+        uint32_t count = total.scoreBuckets[b] + (b == first ? lowerCount : 0);
+        int y = STATS_CHART_Y + (b - first) * STATS_ROW_HEIGHT;
+        std::snprintf(text, sizeof(text), "%d+", b == first && lowerCount > 0 ? 0 : (b == 0 ? 0 : 1 << b));
+        drawLabel(text, STATS_X, y);
+        SDL_Rect bar = {STATS_X + STATS_LABEL_WIDTH, y + 4, (int)((uint64_t)count * STATS_BAR_WIDTH / peak), STATS_ROW_HEIGHT - 8};
+        SDL_SetRenderDrawColor(renderer, barColor.r, barColor.g, barColor.b, barColor.a);
+        SDL_RenderFillRect(renderer, &bar);
+        std::snprintf(text, sizeof(text), "%u", count);
+        drawLabel(text, bar.x + bar.w + 6, y);
+    }
+
+    // Tỉ lệ đạt từng ô, tô bằng màu của ô đó
+    int highest = GameHistory::TILE_BUCKETS - 1;
+    while (highest > 1 && total.tileCounts[highest] == 0) highest--;
+    int lowest = std::max(1, highest - STATS_MAX_ROWS + 1);
+    while (lowest < highest && total.reachRate(lowest + 1) >= 0.999) lowest++;  // bỏ các ô ván nào cũng đạt
+    drawLabel("Max tile reached", STATS_TILES_X, STATS_CHART_Y - 28);
+    for (int e = lowest; e <= highest; e++) {
+        int y = STATS_CHART_Y + (e - lowest) * STATS_ROW_HEIGHT;
+        double rate = total.reachRate(e);
+        std::snprintf(text, sizeof(text), "%d", 1 << e);
+        drawLabel(text, STATS_TILES_X, y);
+        SDL_Color tileColor = getTileColor(1 << e);
+        SDL_Rect bar = {STATS_TILES_X + STATS_LABEL_WIDTH, y + 4, (int)(rate * STATS_BAR_WIDTH), STATS_ROW_HEIGHT - 8};
+        SDL_SetRenderDrawColor(renderer, tileColor.r, tileColor.g, tileColor.b, tileColor.a);
+        SDL_RenderFillRect(renderer, &bar);
+        std::snprintf(text, sizeof(text), "%.1f%%", rate * 100.0);
+        drawLabel(text, bar.x + bar.w + 6, y);
+    }
+
+    // Xu hướng điểm trung bình theo thời gian
+    if (historyStats.trendPoints > 0) {
+        double trendPeak = 1.0;
+        for (int p = 0; p < historyStats.trendPoints; p++) trendPeak = std::max(trendPeak, historyStats.trend[p]);
+        std::snprintf(text, sizeof(text), "Average score over time, oldest to newest (peak %.0f)", trendPeak);
+        drawLabel(text, STATS_X, STATS_TREND_Y - 28);
+        int width = (WINDOW_WIDTH - 2 * STATS_X) / historyStats.trendPoints;
+        SDL_SetRenderDrawColor(renderer, barColor.r, barColor.g, barColor.b, barColor.a);
+        for (int p = 0; p < historyStats.trendPoints; p++) {
+            int height = std::max(1, (int)(historyStats.trend[p] / trendPeak * STATS_TREND_HEIGHT));
+            SDL_Rect bar = {STATS_X + p * width, STATS_TREND_Y + STATS_TREND_HEIGHT - height, std::max(1, width - 2), height};
+            SDL_RenderFillRect(renderer, &bar);
+        }
+    }
+}
+
+void Game2048::drawAdvisorHud() {
+    char text[96];
+    if (isMultiplayer) {
+        std::snprintf(text, sizeof(text), "CPU depth: %d", cpu->lastDepth());
+    } else if (autoplay) {
+        std::snprintf(text, sizeof(text), "Autoplay: %s", advisor ? advisor->name() : "starting");
+    } else if (hintMove >= 0 && hintBoard == Engine::fromGrid(board)) {
+        // Gợi ý chỉ còn đúng khi bàn cờ chưa đổi
+        std::snprintf(text, sizeof(text), "Hint: %s (avg %.0f)", Engine::moveName(hintMove), hintValue);
+    } else {
+        return;
+    }
+
+    SDL_Surface* hudSurface = Resources::renderText(menuFont, text, TITLE_COLOR);
+    if (hudSurface) {
+        SDL_Texture* hudTexture = Resources::createTexture(renderer, hudSurface);
+        if (hudTexture) {
+            SDL_Rect hudRect = {ADVISOR_HUD_X, ADVISOR_HUD_Y, hudSurface->w, hudSurface->h};
+            SDL_RenderCopy(renderer, hudTexture, NULL, &hudRect);
+            Resources::destroyTexture(hudTexture);
+        }
+        Resources::freeSurface(hudSurface);
+    }
+}
+
+void Game2048::seekReplay(long index) {
+    if (index < 0) index = 0;
+    if (index > (long)replayReader.moveCount()) index = replayReader.moveCount();
+    Engine::Board replayBoard;
+    if (replayReader.stateAt((uint32_t)index, replayBoard, replayScore)) {
+        replayIndex = (uint32_t)index;
+        Engine::toGrid(replayBoard, replayGrid);
+    }
+}
+
+void Game2048::scrubReplay(int mouseX) {
+    // Vị trí chuột trên thanh thời gian -> số nước đi
+    int barWidth = WINDOW_WIDTH - 2 * REPLAY_BAR_X;
+    long offset = std::max(0, std::min(barWidth, mouseX - REPLAY_BAR_X));
+    seekReplay(offset * (long)replayReader.moveCount() / barWidth);
+}
+
+void Game2048::handleReplayEvent(const SDL_Event& e) {
+    if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
+        if (e.button.y >= REPLAY_BAR_Y - REPLAY_BAR_HEIGHT && e.button.y <= REPLAY_BAR_Y + 2 * REPLAY_BAR_HEIGHT) {
+            replayScrubbing = true;
+            replayPlaying = false;
+            scrubReplay(e.button.x);
+        }
+    } else if (e.type == SDL_MOUSEMOTION && replayScrubbing) {
+        scrubReplay(e.motion.x);
+    } else if (e.type == SDL_MOUSEBUTTONUP && e.button.button == SDL_BUTTON_LEFT) {
+        replayScrubbing = false;
+    } else if (e.type == SDL_KEYDOWN) {
+        switch (e.key.keysym.sym) {
+            case SDLK_SPACE:
+                if (replayIndex >= replayReader.moveCount()) seekReplay(0);  // hết replay thì phát lại từ đầu
+                replayPlaying = !replayPlaying;
+                break;
+            case SDLK_RIGHT:
+                replayPlaying = false;
+                seekReplay((long)replayIndex + 1);
+                break;
+            case SDLK_LEFT:
+                replayPlaying = false;
+                seekReplay((long)replayIndex - 1);
+                break;
+            case SDLK_UP:
+                seekReplay((long)replayIndex + REPLAY_JUMP_MOVES);
+                break;
+            case SDLK_DOWN:
+                seekReplay((long)replayIndex - REPLAY_JUMP_MOVES);
+                break;
+            case SDLK_HOME:
+                seekReplay(0);
+                break;
+            case SDLK_END:
+                seekReplay(replayReader.moveCount());
+                break;
+            case SDLK_EQUALS:
+            case SDLK_PLUS:
+                replayStepMs = std::max(REPLAY_MIN_STEP_MS, replayStepMs / 2);
+                break;
+            case SDLK_MINUS:
+                replayStepMs = std::min(REPLAY_MAX_STEP_MS, replayStepMs * 2);
+                break;
+            case SDLK_ESCAPE:
+                viewingReplay = false;  // về menu
+                inMenu = true;
+                break;
+        }
+    }
+}
+
+void Game2048::updateReplayViewer() {
+    if (!replayPlaying || SDL_GetTicks() < replayNextTicks) return;
+    if (replayIndex >= replayReader.moveCount()) {
+        replayPlaying = false;
+        return;
+    }
+    seekReplay((long)replayIndex + 1);
+    replayNextTicks = SDL_GetTicks() + (Uint32)replayStepMs;
+}
+
+void Game2048::drawReplayViewer() {
+    int boardX = (WINDOW_WIDTH - (GRID_SIZE * CELL_SIZE + (GRID_SIZE - 1) * CELL_MARGIN)) / 2;
+    drawBoardOnly(replayGrid, boardX, REPLAY_BOARD_Y);
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "Replay  move %u / %u   score %d   %s (%d ms/move)", replayIndex,
+                  replayReader.moveCount(), replayScore, replayPlaying ? "playing" : "paused", replayStepMs);
+    SDL_Surface* textSurface = Resources::renderText(menuFont, text, TITLE_COLOR);
+    if (textSurface) {
+        SDL_Texture* textTexture = Resources::createTexture(renderer, textSurface);
+        if (textTexture) {
+            SDL_Rect textRect = {REPLAY_BAR_X, REPLAY_TEXT_Y, textSurface->w, textSurface->h};
+            SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
+            Resources::destroyTexture(textTexture);
+        }
+        Resources::freeSurface(textSurface);
+    }
+
+    // Thanh thời gian: kéo chuột để tua
+    SDL_Rect bar = {REPLAY_BAR_X, REPLAY_BAR_Y, WINDOW_WIDTH - 2 * REPLAY_BAR_X, REPLAY_BAR_HEIGHT};
+    drawRoundedRect(bar, BOARD_BACKGROUND, REPLAY_BAR_HEIGHT / 2);
+    if (replayReader.moveCount() > 0 && replayIndex > 0) {
+        SDL_Rect filled = bar;
+        filled.w = (int)((long)bar.w * replayIndex / replayReader.moveCount());
+        if (filled.w >= REPLAY_BAR_HEIGHT) drawRoundedRect(filled, BUTTON_COLOR, REPLAY_BAR_HEIGHT / 2);
     }
 }
 
@@ -1000,19 +2212,20 @@ void Game2048::drawBoard(std::vector<std::vector<int>>& board, int boardX, int b
 
     // Vẽ tiêu đề game
     SDL_Color titleColor = TITLE_COLOR;
-    SDL_Surface* titleSurface = TTF_RenderText_Solid(font, "2048", titleColor);
-    SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-    
-    SDL_Rect titleRect = {
-        (WINDOW_WIDTH - titleSurface->w) / 2,
-        10,
-        titleSurface->w,
-        titleSurface->h
-    };
-    
-    SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
-    SDL_FreeSurface(titleSurface);
-    SDL_DestroyTexture(titleTexture);
+    SDL_Surface* titleSurface = Resources::renderText(font, "2048", titleColor);
+    // Nếu render chữ lỗi vẫn giữ bố cục với chiều cao mặc định
+    SDL_Rect titleRect = {WINDOW_WIDTH / 2, 10, 0, TITLE_FALLBACK_HEIGHT};
+    if (titleSurface) {
+        titleRect.x = (WINDOW_WIDTH - titleSurface->w) / 2;
+        titleRect.w = titleSurface->w;
+        titleRect.h = titleSurface->h;
+        SDL_Texture* titleTexture = Resources::createTexture(renderer, titleSurface);
+        if (titleTexture) {
+            SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
+            Resources::destroyTexture(titleTexture);
+        }
+        Resources::freeSurface(titleSurface);
+    }
 
     // Tính toán kích thước của bảng game
     int boardWidth = GRID_SIZE * CELL_SIZE + (GRID_SIZE - 1) * CELL_MARGIN;
@@ -1026,6 +2239,11 @@ void Game2048::drawBoard(std::vector<std::vector<int>>& board, int boardX, int b
     };
     drawScore("Score", score, scoreBox.x, scoreBox.y);
 
+    // Hạng trực tiếp trên bảng điểm cao: O(log n) mỗi frame kể cả khi N rất lớn
+    if (leaderboard.isOpen()) {
+        drawScore("Rank", (int)leaderboard.rankOf(score), scoreBox.x - scoreBox.w - 10, scoreBox.y);
+    }
+
     // Vẽ hộp điểm cao nhất - đặt bên cạnh hộp điểm số
     SDL_Rect bestBox = {
         scoreBox.x + scoreBox.w + 10,  // Cách hộp điểm số 10px
@@ -1063,9 +2281,9 @@ SDL_Color Game2048::getTileColor(int value) {
 void Game2048::drawMenu() {
     // Vẽ tiêu đề game với font lớn
     SDL_Color titleColor = TITLE_COLOR;
-    SDL_Surface* titleSurface = TTF_RenderText_Solid(font, "2048", titleColor);
+    SDL_Surface* titleSurface = Resources::renderText(font, "2048", titleColor);
     if (titleSurface) {
-        SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
+        SDL_Texture* titleTexture = Resources::createTexture(renderer, titleSurface);
         if (titleTexture) {
             SDL_Rect titleRect = {
                 (WINDOW_WIDTH - titleSurface->w) / 2,
@@ -1074,9 +2292,9 @@ void Game2048::drawMenu() {
                 titleSurface->h
             };
             SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
-            SDL_DestroyTexture(titleTexture);
+            Resources::destroyTexture(titleTexture);
         }
-        SDL_FreeSurface(titleSurface);
+        Resources::freeSurface(titleSurface);
     }
 
     // Vẽ nút Single Player
@@ -1096,10 +2314,30 @@ void Game2048::drawMenu() {
         BUTTON_HEIGHT
     };
     drawButton("Multiplayer", multiplayerButton);
+
+    // Vẽ nút Statistics
+    SDL_Rect statsButton = {
+        (WINDOW_WIDTH - BUTTON_WIDTH) / 2,
+        250 + 2 * (BUTTON_HEIGHT + BUTTON_MARGIN),
+        BUTTON_WIDTH,
+        BUTTON_HEIGHT
+    };
+    drawButton("Statistics", statsButton);
 }
 
 void Game2048::initializeMultiplayerBoards() {
     std::cout << "Initializing multiplayer boards..." << std::endl;
+    finishReplay();
+    if (net) {
+        // Đấu mạng: spawnRng/spawnRng2 đã lấy seed chung của phiên
+        replaySeed = net->seed();
+        replaySeed2 = net->seed();
+    } else {
+        newReplaySeed();
+        newReplaySeedPlayer2();
+    }
+    lastMove = -1;
+    lastMove2 = -1;
     
     // Khởi tạo bảng cho người chơi 1
     board = std::vector<std::vector<int>>(GRID_SIZE, std::vector<int>(GRID_SIZE, 0));
@@ -1116,6 +2354,7 @@ void Game2048::initializeMultiplayerBoards() {
     gameOver2 = false;
     
     isMultiplayer = true;
+    resetHistoryTracking();
     
     // Thêm 2 ô mới cho mỗi người chơi
     std::cout << "Adding initial tiles for player 1..." << std::endl;
@@ -1130,29 +2369,27 @@ void Game2048::initializeMultiplayerBoards() {
 }
 
 void Game2048::addNewTilePlayer2() {
-    std::vector<std::pair<int, int>> emptyCells;
-    for (int i = 0; i < GRID_SIZE; i++) {
-        for (int j = 0; j < GRID_SIZE; j++) {
-            if (board2[i][j] == 0) {
-                emptyCells.push_back({i, j});
-            }
+    ALLOC_SCOPE("addNewTilePlayer2");
+    uint64_t rngBefore = spawnRng2.state;
+    {
+        ALLOC_FREE_SECTION("addNewTilePlayer2");
+        // Như người chơi 1: ô mới lấy từ RNG của Engine để replay tái tạo được. Đấu mạng
+        // dùng cùng seed ở cả hai máy nên ô mới giống hệt nhau (và không có chế độ khó)
+        Engine::Board current = Engine::fromGrid(board2);
+        Engine::Board spawned = Engine::spawnRandom(current, spawnRng2);
+        int hardRow, hardCol, hardValue;
+        if (spawned != current && !net && options.hardMode && pickHardSpawn(board2, hardRow, hardCol, hardValue)) {
+            board2[hardRow][hardCol] = hardValue;
+        } else if (spawned != current) {
+            int cell = __builtin_ctzll(spawned ^ current) / 4;
+            board2[cell / GRID_SIZE][cell % GRID_SIZE] = Engine::valueOf(Engine::getCell(spawned, cell));
         }
     }
-    
-    if (!emptyCells.empty()) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> cellDist(0, emptyCells.size() - 1);
-        std::uniform_int_distribution<> valueDist(0, 9);
-        
-        int selectedCell = cellDist(gen);
-        int row = emptyCells[selectedCell].first;
-        int col = emptyCells[selectedCell].second;
-        board2[row][col] = valueDist(gen) < 9 ? 2 : 4;
-    }
-    
+    recordMovePlayer2(rngBefore);
+
     if (!canMovePlayer2()) {
         gameOver2 = true;
+        saveReplay(replayWriter2, replaySeed2, "-p2");
     }
 }
 
@@ -1161,14 +2398,17 @@ bool Game2048::canMovePlayer2() {
         for (int j = 0; j < GRID_SIZE; j++) {
             if (board2[i][j] == 0) return true;
             
-            if (i < GRID_SIZE - 1 && board2[i][j] == board2[i + 1][j]) return true;
-            if (j < GRID_SIZE - 1 && board2[i][j] == board2[i][j + 1]) return true;
+            if (i < GRID_SIZE - 1 && board2[i][j] == board2[i + 1][j] && board2[i][j] < MAX_TILE) return true;
+            if (j < GRID_SIZE - 1 && board2[i][j] == board2[i][j + 1] && board2[i][j] < MAX_TILE) return true;
         }
     }
     return false;
 }
 
 bool Game2048::moveTilesPlayer2(int dx, int dy) {
+    ALLOC_SCOPE("moveTilesPlayer2");
+    ALLOC_FREE_SECTION("moveTilesPlayer2");
+    lastMove2 = Engine::deltaToMove(dx, dy);
     try {
         std::cout << "Moving tiles for player 2..." << std::endl;
         if (dx == 0 && dy == 0) {
@@ -1179,52 +2419,57 @@ bool Game2048::moveTilesPlayer2(int dx, int dy) {
         // Tạo bản sao của bảng và điểm số
         previousBoard2 = board2;
         previousScore2 = score2;
-        auto tempBoard = board2;
+        int tempBoard[GRID_SIZE][GRID_SIZE];
+        for (int row = 0; row < GRID_SIZE; row++) {
+            for (int col = 0; col < GRID_SIZE; col++) {
+                tempBoard[row][col] = board2[row][col];
+            }
+        }
         bool moved = false;
 
         // Di chuyển ngang
         if (dx != 0) {
             for (int row = 0; row < GRID_SIZE; row++) {
-                std::vector<int> line;
+                int line[GRID_SIZE];
+                int lineSize = 0;
                 
                 // Thu thập các số khác 0
                 for (int col = 0; col < GRID_SIZE; col++) {
                     int currentCol = (dx < 0) ? col : (GRID_SIZE - 1 - col);
                     if (tempBoard[row][currentCol] != 0) {
-                        line.push_back(tempBoard[row][currentCol]);
+                        line[lineSize++] = tempBoard[row][currentCol];
                     }
                 }
                 
                 // Nếu không có số nào, bỏ qua hàng này
-                if (line.empty()) {
+                if (lineSize == 0) {
                     continue;
                 }
                 
                 // Gộp các số giống nhau
-                for (size_t i = 0; i < line.size() - 1; i++) {
-                    if (line[i] == line[i + 1]) {
+                for (int i = 0; i < lineSize - 1; i++) {
+                    if (line[i] == line[i + 1] && line[i] < MAX_TILE) {
                         line[i] *= 2;
                         score2 += line[i];
-                        line.erase(line.begin() + i + 1);
+                        for (int k = i + 1; k < lineSize - 1; k++) {
+                            line[k] = line[k + 1];
+                        }
+                        lineSize--;
                         updateBestScore();  // Cập nhật điểm cao nhất
-                        i--;
                     }
                 }
                 
                 // Điền số 0 vào cuối nếu cần
-                while (line.size() < GRID_SIZE) {
-                    if (dx < 0) {
-                        line.push_back(0);
-                    } else {
-                        line.insert(line.begin(), 0);
-                    }
+                while (lineSize < GRID_SIZE) {
+                    line[lineSize++] = 0;
                 }
                 
-                // Cập nhật bảng
-                for (int col = 0; col < GRID_SIZE; col++) {
-                    if (tempBoard[row][col] != line[col]) {
+                // Cập nhật bảng: line[0] là ô sát cạnh theo hướng di chuyển
+                for (int k = 0; k < GRID_SIZE; k++) {
+                    int col = (dx < 0) ? k : (GRID_SIZE - 1 - k);
+                    if (tempBoard[row][col] != line[k]) {
                         moved = true;
-                        tempBoard[row][col] = line[col];
+                        tempBoard[row][col] = line[k];
                     }
                 }
             }
@@ -1232,46 +2477,46 @@ bool Game2048::moveTilesPlayer2(int dx, int dy) {
         // Di chuyển dọc
         else if (dy != 0) {
             for (int col = 0; col < GRID_SIZE; col++) {
-                std::vector<int> line;
+                int line[GRID_SIZE];
+                int lineSize = 0;
                 
                 // Thu thập các số khác 0
                 for (int row = 0; row < GRID_SIZE; row++) {
                     int currentRow = (dy < 0) ? row : (GRID_SIZE - 1 - row);
                     if (tempBoard[currentRow][col] != 0) {
-                        line.push_back(tempBoard[currentRow][col]);
+                        line[lineSize++] = tempBoard[currentRow][col];
                     }
                 }
                 
                 // Nếu không có số nào, bỏ qua cột này
-                if (line.empty()) {
+                if (lineSize == 0) {
                     continue;
                 }
                 
                 // Gộp các số giống nhau
-                for (size_t i = 0; i < line.size() - 1; i++) {
-                    if (line[i] == line[i + 1]) {
+                for (int i = 0; i < lineSize - 1; i++) {
+                    if (line[i] == line[i + 1] && line[i] < MAX_TILE) {
                         line[i] *= 2;
                         score2 += line[i];
-                        line.erase(line.begin() + i + 1);
+                        for (int k = i + 1; k < lineSize - 1; k++) {
+                            line[k] = line[k + 1];
+                        }
+                        lineSize--;
                         updateBestScore();  // Cập nhật điểm cao nhất
-                        i--;
                     }
                 }
                 
                 // Điền số 0 vào cuối nếu cần
-                while (line.size() < GRID_SIZE) {
-                    if (dy < 0) {
-                        line.push_back(0);
-                    } else {
-                        line.insert(line.begin(), 0);
-                    }
+                while (lineSize < GRID_SIZE) {
+                    line[lineSize++] = 0;
                 }
                 
-                // Cập nhật bảng
-                for (int row = 0; row < GRID_SIZE; row++) {
-                    if (tempBoard[row][col] != line[row]) {
+                // Cập nhật bảng: line[0] là ô sát cạnh theo hướng di chuyển
+                for (int k = 0; k < GRID_SIZE; k++) {
+                    int row = (dy < 0) ? k : (GRID_SIZE - 1 - k);
+                    if (tempBoard[row][col] != line[k]) {
                         moved = true;
-                        tempBoard[row][col] = line[row];
+                        tempBoard[row][col] = line[k];
                     }
                 }
             }
@@ -1279,7 +2524,13 @@ bool Game2048::moveTilesPlayer2(int dx, int dy) {
 
         // Chỉ cập nhật bảng chính nếu có di chuyển
         if (moved) {
-            board2 = tempBoard;
+            for (int row = 0; row < GRID_SIZE; row++) {
+                for (int col = 0; col < GRID_SIZE; col++) {
+                    board2[row][col] = tempBoard[row][col];
+                }
+            }
+            liveMoves++;
+            gameMoves2++;
         }
 
         std::cout << "Move complete for player 2, moved = " << moved << std::endl;
@@ -1336,19 +2587,21 @@ void Game2048::drawMultiplayerBoards() {
 
     // Vẽ tiêu đề game
     SDL_Color titleColor = TITLE_COLOR;
-    SDL_Surface* titleSurface = TTF_RenderText_Solid(font, "2048 Multiplayer", titleColor);
-    SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-    
-    SDL_Rect titleRect = {
-        (WINDOW_WIDTH - titleSurface->w) / 2,
-        10,
-        titleSurface->w,
-        titleSurface->h
-    };
-    
-    SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
-    SDL_FreeSurface(titleSurface);
-    SDL_DestroyTexture(titleTexture);
+    SDL_Surface* titleSurface = Resources::renderText(font, "2048 Multiplayer", titleColor);
+    if (titleSurface) {
+        SDL_Texture* titleTexture = Resources::createTexture(renderer, titleSurface);
+        if (titleTexture) {
+            SDL_Rect titleRect = {
+                (WINDOW_WIDTH - titleSurface->w) / 2,
+                10,
+                titleSurface->w,
+                titleSurface->h
+            };
+            SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
+            Resources::destroyTexture(titleTexture);
+        }
+        Resources::freeSurface(titleSurface);
+    }
 
     // Tính toán vị trí mới cho các bàn cờ
     int totalBoardHeight = GRID_SIZE * CELL_SIZE + (GRID_SIZE - 1) * CELL_MARGIN + 2 * BOARD_MARGIN;
@@ -1359,32 +2612,32 @@ void Game2048::drawMultiplayerBoards() {
     
     // Tạo texture cho tên Player 1 nếu chưa có
     if (player1NameTexture == nullptr) {
-        SDL_Surface* player1Surface = TTF_RenderText_Solid(scoreFont, "P1 (WASD)", titleColor);
-        player1NameTexture = SDL_CreateTextureFromSurface(renderer, player1Surface);
-        player1NameRect = {
-            leftBoardX,
-            80,
-            player1Surface->w,
-            player1Surface->h
-        };
-        SDL_FreeSurface(player1Surface);
+        SDL_Surface* player1Surface = Resources::renderText(scoreFont,
+            net ? (net->isHost() ? "P1 (You)" : "P1 (Remote)") : "P1 (WASD)", titleColor);
+        player1NameRect = {leftBoardX, 80, 0, 0};
+        if (player1Surface) {
+            player1NameTexture = Resources::createTexture(renderer, player1Surface);
+            player1NameRect.w = player1Surface->w;
+            player1NameRect.h = player1Surface->h;
+            Resources::freeSurface(player1Surface);
+        }
     }
     
     // Cập nhật texture điểm số Player 1 nếu điểm thay đổi
     if (score != lastScore1 || score1Texture == nullptr) {
         if (score1Texture) {
-            SDL_DestroyTexture(score1Texture);
+            Resources::destroyTexture(score1Texture);
         }
         std::string score1Text = "Score: " + std::to_string(score);
-        SDL_Surface* score1Surface = TTF_RenderText_Solid(scoreFont, score1Text.c_str(), titleColor);
-        score1Texture = SDL_CreateTextureFromSurface(renderer, score1Surface);
-        score1Rect = {
-            leftBoardX + player1NameRect.w + 10,
-            80,
-            score1Surface->w,
-            score1Surface->h
-        };
-        SDL_FreeSurface(score1Surface);
+        SDL_Surface* score1Surface = Resources::renderText(scoreFont, score1Text.c_str(), titleColor);
+        score1Texture = nullptr;
+        score1Rect = {leftBoardX + player1NameRect.w + 10, 80, 0, 0};
+        if (score1Surface) {
+            score1Texture = Resources::createTexture(renderer, score1Surface);
+            score1Rect.w = score1Surface->w;
+            score1Rect.h = score1Surface->h;
+            Resources::freeSurface(score1Surface);
+        }
         lastScore1 = score;
     }
     
@@ -1410,32 +2663,32 @@ void Game2048::drawMultiplayerBoards() {
     
     // Tạo texture cho tên Player 2 nếu chưa có
     if (player2NameTexture == nullptr) {
-        SDL_Surface* player2Surface = TTF_RenderText_Solid(scoreFont, "P2 (Arrows)", titleColor);
-        player2NameTexture = SDL_CreateTextureFromSurface(renderer, player2Surface);
-        player2NameRect = {
-            rightBoardX,
-            80,
-            player2Surface->w,
-            player2Surface->h
-        };
-        SDL_FreeSurface(player2Surface);
+        SDL_Surface* player2Surface = Resources::renderText(scoreFont,
+            options.vsCpu ? "P2 (CPU)" : net ? (net->isHost() ? "P2 (Remote)" : "P2 (You)") : "P2 (Arrows)", titleColor);
+        player2NameRect = {rightBoardX, 80, 0, 0};
+        if (player2Surface) {
+            player2NameTexture = Resources::createTexture(renderer, player2Surface);
+            player2NameRect.w = player2Surface->w;
+            player2NameRect.h = player2Surface->h;
+            Resources::freeSurface(player2Surface);
+        }
     }
     
     // Cập nhật texture điểm số Player 2 nếu điểm thay đổi
     if (score2 != lastScore2 || score2Texture == nullptr) {
         if (score2Texture) {
-            SDL_DestroyTexture(score2Texture);
+            Resources::destroyTexture(score2Texture);
         }
         std::string score2Text = "Score: " + std::to_string(score2);
-        SDL_Surface* score2Surface = TTF_RenderText_Solid(scoreFont, score2Text.c_str(), titleColor);
-        score2Texture = SDL_CreateTextureFromSurface(renderer, score2Surface);
-        score2Rect = {
-            rightBoardX + player2NameRect.w + 10,
-            80,
-            score2Surface->w,
-            score2Surface->h
-        };
-        SDL_FreeSurface(score2Surface);
+        SDL_Surface* score2Surface = Resources::renderText(scoreFont, score2Text.c_str(), titleColor);
+        score2Texture = nullptr;
+        score2Rect = {rightBoardX + player2NameRect.w + 10, 80, 0, 0};
+        if (score2Surface) {
+            score2Texture = Resources::createTexture(renderer, score2Surface);
+            score2Rect.w = score2Surface->w;
+            score2Rect.h = score2Surface->h;
+            Resources::freeSurface(score2Surface);
+        }
         lastScore2 = score2;
     }
     
@@ -1467,19 +2720,21 @@ void Game2048::drawMultiplayerBoards() {
             winnerText = "It's a Tie!";
         }
         
-        SDL_Surface* winnerSurface = TTF_RenderText_Solid(font, winnerText.c_str(), titleColor);
-        SDL_Texture* winnerTexture = SDL_CreateTextureFromSurface(renderer, winnerSurface);
-        
-        SDL_Rect winnerRect = {
-            (WINDOW_WIDTH - winnerSurface->w) / 2,
-            boardY - 80,
-            winnerSurface->w,
-            winnerSurface->h
-        };
-        
-        SDL_RenderCopy(renderer, winnerTexture, NULL, &winnerRect);
-        SDL_FreeSurface(winnerSurface);
-        SDL_DestroyTexture(winnerTexture);
+        SDL_Surface* winnerSurface = Resources::renderText(font, winnerText.c_str(), titleColor);
+        if (winnerSurface) {
+            SDL_Texture* winnerTexture = Resources::createTexture(renderer, winnerSurface);
+            if (winnerTexture) {
+                SDL_Rect winnerRect = {
+                    (WINDOW_WIDTH - winnerSurface->w) / 2,
+                    boardY - 80,
+                    winnerSurface->w,
+                    winnerSurface->h
+                };
+                SDL_RenderCopy(renderer, winnerTexture, NULL, &winnerRect);
+                Resources::destroyTexture(winnerTexture);
+            }
+            Resources::freeSurface(winnerSurface);
+        }
         
         // Vẽ nút Back to Menu
         SDL_Rect menuButton = {
@@ -3,25 +3,52 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
+#include <random>
 #include <string>
 #include <vector>
 #include "Constants.h"
+#include "LatencyTracker.h"
+#include "SoakMonitor.h"
+#include "Options.h"
+#include "Advisor.h"
+#include "NTuple.h"
+#include "OpeningBook.h"
+#include "AdversarialSpawner.h"
+#include "CpuOpponent.h"
+#include "Replay.h"
+#include "SessionCapture.h"
+#include "FrameCapture.h"
+#include "NetSession.h"
+#include "LiveState.h"
+#include "GameHistory.h"
+#include "Leaderboard.h"
+#include "AssetPack.h"
 
 class Game2048 {
 public:
     Game2048();
     ~Game2048();
     
-    bool init();
-    void run();
+    bool init(const GameOptions& options = GameOptions());
+    bool run();
+    bool runHeadless();
     void cleanup();
 
+    // Renderer phần mềm riêng cho xuất replay (SDL/TTF đã được khởi tạo bên ngoài).
+    // Mỗi đối tượng chỉ được dùng bởi một luồng
+    bool initOffscreen(const GameOptions& options, const Replay::Reader& reader);
+    bool renderReplayFrame(uint32_t index, FrameCapture::Frame& frame);
+
 private:
     SDL_Window* window;
     SDL_Renderer* renderer;
+    SDL_Surface* offscreenSurface;
+    GameOptions options;
     TTF_Font* font;
     TTF_Font* menuFont;
     TTF_Font* scoreFont;
+    AssetPack assets;           // phải sống lâu hơn các font mở từ nó
+    bool ownsSdl;
     
     // Thêm các texture cho tên và điểm số
     SDL_Texture* player1NameTexture;
@@ -34,6 +61,8 @@ private:
     SDL_Rect score2Rect;
     int lastScore1;
     int lastScore2;
+    SDL_Texture* tileTextTextures[TILE_TEXT_CACHE_SIZE];
+    SDL_Rect tileTextRects[TILE_TEXT_CACHE_SIZE];
     
     // Game state
     std::vector<std::vector<int>> board;
@@ -50,13 +79,84 @@ private:
     bool inMenu;
     bool firstGame;
     bool isMultiplayer;
+    bool showAllocHud;
+    bool showLatencyHud;
+    LatencyTracker latencyTracker;
+    SoakMonitor soakMonitor;
+    Uint32 syntheticStart;
+    Uint64 syntheticInjected;
+    std::mt19937 rng;
+    Advisor* advisor;
+    NTupleNetwork ntuple;
+    OpeningBook openingBook;
+    bool autoplay;
+    uint64_t hintBoard;
+    int hintMove;
+    double hintValue;
+    AdversarialSpawner spawner;
+    Uint64 frameStartCounter;     // SDL_GetPerformanceCounter() lúc bắt đầu frame hiện tại
+    CpuOpponent* cpu;
+    uint64_t cpuRequestBoard;
+    Uint32 cpuNextMoveTicks;
+    Engine::Rng spawnRng;
+    uint64_t replaySeed;
+    int lastMove;
+    Replay::Writer replayWriter;
+    Replay::Reader replayReader;
+    bool viewingReplay;
+    bool replayPlaying;
+    bool replayScrubbing;
+    uint32_t replayIndex;
+    int replayScore;
+    int replayStepMs;
+    Uint32 replayNextTicks;
+    std::vector<std::vector<int>> replayGrid;
+    SessionCapture::Recorder sessionRecorder;
+    SessionCapture::Player sessionPlayer;
+    Uint32 sessionStart;
+    uint32_t sessionClock;
+    std::vector<float> sessionFrameMs;
+    NetSession* net;
+    bool netStarted;
+    bool netDesync;
+    uint32_t netLocalMoves;
+    uint32_t netRemoteMoves;
+    Engine::Rng spawnRng2;        // ô mới của người chơi 2 (cùng seed hai máy khi đấu mạng)
+    uint64_t replaySeed2;
+    int lastMove2;
+    Replay::Writer replayWriter2;
+    LivePublisher livePublisher;
+    Live2048Snapshot livePublished;
+    uint64_t liveMoves;
+    GameHistory::Database history;
+    Leaderboard leaderboard;      // một người chơi
+    Leaderboard leaderboard2;     // hai người chơi (cả người chơi 1 lẫn 2)
+    GameHistory::Stats historyStats;
+    Uint32 gameStartTicks;
+    uint32_t gameMoves;
+    uint32_t gameMoves2;
+    bool historyRecorded;
+    bool historyRecorded2;
+    bool inStats;
+    int statsMode;            // -1 = mọi chế độ
+    double statsQueryMs;
     
+    bool createOffscreenRenderer();
+    bool loadFonts();
+
     // Game functions
     void initializeBoard();
     void initializeMultiplayerBoards();
     void initializeNewGame();
     void addNewTile();
     void addNewTilePlayer2();
+    void newReplaySeed();
+    void newReplaySeedPlayer2();
+    void recordMove(uint64_t rngBefore);
+    void recordMovePlayer2(uint64_t rngBefore);
+    void finishReplay();
+    void saveReplay(Replay::Writer& writer, uint64_t seed, const char* suffix);
+    bool pickHardSpawn(const std::vector<std::vector<int>>& grid, int& row, int& col, int& value);
     bool canMove();
     bool canMovePlayer2();
     bool moveTiles(int dx, int dy);
@@ -74,11 +174,38 @@ private:
     void drawScore(const char* label, int value, int x, int y);
     void drawButton(const std::string& text, SDL_Rect rect);
     void drawBoardOnly(std::vector<std::vector<int>>& board, int boardX, int boardY);
+    void drawAllocHud();
+    void drawLatencyHud();
     
     // Helper functions
     SDL_Color getTileColor(int value);
     bool isMouseOverButton(int mouseX, int mouseY, SDL_Rect buttonRect);
-    void handleInput();
+    void handleInput(int mouseX, int mouseY);
+    bool pollEvent(SDL_Event& e);
+    uint32_t sessionNow() const;
+    void reportSessionFrames();
+    void injectSyntheticInput();
+    Advisor* getAdvisor();
+    void showHint();
+    void autoplayStep();
+    void cpuStep();
+    void netStep();
+    bool netLocalMove(SDL_Keycode key);
+    void drawNetHud();
+    void publishLiveState();
+    void resetHistoryTracking();
+    void recordFinishedGames();
+    void recordResult(int player);
+    void refreshStats();
+    void handleStatsEvent(const SDL_Event& e);
+    void drawStats();
+    void drawLabel(const char* text, int x, int y);
+    void seekReplay(long index);
+    void scrubReplay(int mouseX);
+    void handleReplayEvent(const SDL_Event& e);
+    void updateReplayViewer();
+    void drawReplayViewer();
+    void drawAdvisorHud();
     void saveGame();
     void loadGame();
     void drawRoundedRect(SDL_Rect rect, SDL_Color color, int radius);
@@ -0,0 +1,327 @@
+#include "GameHistory.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace GameHistory {
+    namespace {
+        const char DB_MAGIC[8] = {'2', '0', '4', '8', 'H', 'I', 'S', 'T'};
+        const char INDEX_MAGIC[8] = {'2', '0', '4', '8', 'H', 'I', 'D', 'X'};
+        const uint32_t VERSION = 1;
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t recordSize;
+        };
+
+        struct IndexHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t blockRecords;
+            uint64_t recordCount;   // số record đã được tính vào các block
+            uint32_t modeCount;
+            uint32_t summarySize;
+        };
+
+        const size_t BLOCK_BYTES = sizeof(Summary) * MODE_COUNT;
+
+        int scoreBucket(int32_t score) {
+            if (score <= 1) return 0;
+            return std::min(SCORE_BUCKETS - 1, 31 - __builtin_clz((uint32_t)score));
+        }
+
+        bool writeAt(int fd, const void* data, size_t size, uint64_t offset) {
+            return pwrite(fd, data, size, (off_t)offset) == (ssize_t)size;
+        }
+
+        bool inMask(uint32_t modeMask, uint8_t mode) {
+            return mode < MODE_COUNT && (modeMask & (1u << mode)) != 0;
+        }
+
+        // Khoá flock tới hết phạm vi. Hai game cùng thư mục (đấu mạng qua loopback) ghi
+        // chung một lịch sử: mọi lần ghi giữ khoá độc quyền, truy vấn giữ khoá chia sẻ
+        class FileLock {
+        public:
+            FileLock(int fd, int operation) : fd(fd) {
+                while (flock(fd, operation) != 0 && errno == EINTR) {}
+            }
+            ~FileLock() { flock(fd, LOCK_UN); }
+
+        private:
+            int fd;
+            FileLock(const FileLock&);
+            FileLock& operator=(const FileLock&);
+        };
+
+        const Record* records(const MappedFile& file) {
+            return reinterpret_cast<const Record*>(static_cast<const char*>(file.data()) + sizeof(FileHeader));
+        }
+    }
+
+    const char* modeName(int mode) {
+        switch (mode) {
+            case MODE_SINGLE: return "single";
+            case MODE_HARD: return "hard";
+            case MODE_LOCAL: return "local 2P";
+            case MODE_VS_CPU: return "vs CPU";
+            case MODE_NET: return "network";
+        }
+        return "all";
+    }
+
+    void Summary::clear() {
+        std::memset(this, 0, sizeof(*this));
+    }
+
+    void Summary::add(const Record& record) {
+        if (count == 0 || record.timestamp < firstTimestamp) firstTimestamp = record.timestamp;
+        if (count == 0 || record.timestamp > lastTimestamp) lastTimestamp = record.timestamp;
+        if (count == 0 || record.score > bestScore) bestScore = record.score;
+        count++;
+        scoreSum += (uint64_t)std::max(0, record.score);
+        moveSum += record.moves;
+        durationSum += record.durationMs;
+        tileCounts[std::min<int>(record.maxTile, TILE_BUCKETS - 1)]++;
+        scoreBuckets[scoreBucket(record.score)]++;
+    }
+
+    void Summary::merge(const Summary& other) {
+        if (other.count == 0) return;
+        if (count == 0 || other.firstTimestamp < firstTimestamp) firstTimestamp = other.firstTimestamp;
+        if (count == 0 || other.lastTimestamp > lastTimestamp) lastTimestamp = other.lastTimestamp;
+        if (count == 0 || other.bestScore > bestScore) bestScore = other.bestScore;
+        count += other.count;
+        scoreSum += other.scoreSum;
+        moveSum += other.moveSum;
+        durationSum += other.durationSum;
+        for (int i = 0; i < TILE_BUCKETS; i++) tileCounts[i] += other.tileCounts[i];
+        for (int i = 0; i < SCORE_BUCKETS; i++) scoreBuckets[i] += other.scoreBuckets[i];
+    }
+
+    double Summary::reachRate(int exponent) const {
+        if (count == 0) return 0.0;
+        uint64_t reached = 0;
+        for (int i = std::max(0, exponent); i < TILE_BUCKETS; i++) reached += tileCounts[i];
+        return (double)reached / count;
+    }
+
+    bool Database::open(const std::string& path) {
+        close();
+        dbPath = path;
+        indexPath = path + ".idx";
+        dbFd = ::open(dbPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (dbFd < 0) {
+            std::cerr << "Cannot open history " << dbPath << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        FileLock lock(dbFd, LOCK_EX);
+        struct stat info;
+        FileHeader header;
+        if (fstat(dbFd, &info) != 0) {
+            close();
+            return false;
+        }
+        if (info.st_size == 0) {
+            std::memcpy(header.magic, DB_MAGIC, sizeof(DB_MAGIC));
+            header.version = VERSION;
+            header.recordSize = sizeof(Record);
+            if (!writeAt(dbFd, &header, sizeof(header), 0)) {
+                std::cerr << "Cannot write history " << dbPath << std::endl;
+                close();
+                return false;
+            }
+            info.st_size = sizeof(header);
+        } else if (pread(dbFd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+                   std::memcmp(header.magic, DB_MAGIC, sizeof(DB_MAGIC)) != 0 || header.version != VERSION ||
+                   header.recordSize != sizeof(Record)) {
+            std::cerr << dbPath << " is not a version " << VERSION << " game history" << std::endl;
+            close();
+            return false;
+        }
+        // Record ghi dở ở cuối (game bị kill) bị bỏ qua và sẽ bị ghi đè
+        recordCount = ((uint64_t)info.st_size - sizeof(FileHeader)) / sizeof(Record);
+
+        indexFd = ::open(indexPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (indexFd < 0) {
+            std::cerr << "Cannot open history index " << indexPath << ": " << std::strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        IndexHeader index;
+        uint64_t indexed = 0;
+        if (pread(indexFd, &index, sizeof(index), 0) == (ssize_t)sizeof(index) &&
+            std::memcmp(index.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 && index.version == VERSION &&
+            index.blockRecords == BLOCK_RECORDS && index.modeCount == MODE_COUNT && index.summarySize == sizeof(Summary) &&
+            index.recordCount <= recordCount) {
+            indexed = index.recordCount;
+        } else if (ftruncate(indexFd, 0) != 0) {
+            close();
+            return false;
+        }
+        // Luôn tính lại block cuối (tối đa BLOCK_RECORDS record) để có currentBlock trong bộ nhớ
+        if (!rebuildIndex(indexed)) {
+            std::cerr << "Cannot update history index " << indexPath << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void Database::close() {
+        if (dbFd >= 0) ::close(dbFd);
+        if (indexFd >= 0) ::close(indexFd);
+        dbFd = -1;
+        indexFd = -1;
+        recordCount = 0;
+        currentBlock.clear();
+    }
+
+    bool Database::rebuildIndex(uint64_t fromRecord) {
+        uint64_t blockStart = fromRecord / BLOCK_RECORDS * BLOCK_RECORDS;
+        currentBlock.assign(MODE_COUNT, Summary());
+        for (size_t m = 0; m < currentBlock.size(); m++) currentBlock[m].clear();
+
+        MappedFile file;
+        if (recordCount > blockStart && !file.map(dbPath)) return false;
+        for (uint64_t i = blockStart; i < recordCount; i++) {
+            const Record& record = records(file)[i];
+            if (record.mode < MODE_COUNT) currentBlock[record.mode].add(record);
+            if ((i + 1) % BLOCK_RECORDS == 0) {
+                if (!writeBlock(i / BLOCK_RECORDS)) return false;
+                for (size_t m = 0; m < currentBlock.size(); m++) currentBlock[m].clear();
+            }
+        }
+        if (recordCount % BLOCK_RECORDS != 0 && !writeBlock(recordCount / BLOCK_RECORDS)) return false;
+        return writeIndexCount();
+    }
+
+    bool Database::writeBlock(uint64_t blockIndex) {
+        return writeAt(indexFd, currentBlock.data(), BLOCK_BYTES, sizeof(IndexHeader) + blockIndex * BLOCK_BYTES);
+    }
+
+    bool Database::writeIndexCount() {
+        IndexHeader index;
+        std::memcpy(index.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        index.version = VERSION;
+        index.blockRecords = BLOCK_RECORDS;
+        index.recordCount = recordCount;
+        index.modeCount = MODE_COUNT;
+        index.summarySize = sizeof(Summary);
+        return writeAt(indexFd, &index, sizeof(index), 0);
+    }
+
+    bool Database::refresh() {
+        struct stat info;
+        if (fstat(dbFd, &info) != 0) return false;
+        uint64_t onDisk = ((uint64_t)info.st_size - sizeof(FileHeader)) / sizeof(Record);
+        if (onDisk == recordCount) return true;
+        // Game khác đã ghi thêm: các block của nó đã đúng, chỉ tính lại block cuối trong bộ nhớ
+        uint64_t known = std::min(recordCount, onDisk);
+        recordCount = onDisk;
+        return rebuildIndex(known);
+    }
+
+    bool Database::append(const Record& record) {
+        if (dbFd < 0 || record.mode >= MODE_COUNT) return false;
+        FileLock lock(dbFd, LOCK_EX);
+        if (!refresh()) {
+            std::cerr << "Cannot update history index " << indexPath << std::endl;
+            return false;
+        }
+        // Record trước, index sau: index chỉ có thể chậm hơn record, open() sẽ bù
+        if (!writeAt(dbFd, &record, sizeof(record), sizeof(FileHeader) + recordCount * sizeof(Record))) {
+            std::cerr << "Cannot append to history " << dbPath << std::endl;
+            return false;
+        }
+        currentBlock[record.mode].add(record);
+        bool ok = writeBlock(recordCount / BLOCK_RECORDS);
+        recordCount++;
+        ok = writeIndexCount() && ok;
+        if (recordCount % BLOCK_RECORDS == 0) {
+            for (size_t m = 0; m < currentBlock.size(); m++) currentBlock[m].clear();
+        }
+        return ok;
+    }
+
+    bool Database::query(uint32_t modeMask, Stats& stats) const {
+        std::memset(&stats, 0, sizeof(stats));
+        if (dbFd < 0) return false;
+
+        // Dưới khoá chia sẻ, số record trong header index luôn khớp với các block (kể cả
+        // ván game khác vừa ghi)
+        FileLock lock(dbFd, LOCK_SH);
+        MappedFile index;
+        MappedFile file;
+        if (!index.map(indexPath) || index.size() < sizeof(IndexHeader)) return recordCount == 0;
+        uint64_t recordCount = static_cast<const IndexHeader*>(index.data())->recordCount;
+        stats.records = recordCount;
+        if (recordCount == 0) return true;
+        uint64_t blockCount = (recordCount + BLOCK_RECORDS - 1) / BLOCK_RECORDS;
+        if (index.size() < sizeof(IndexHeader) + blockCount * BLOCK_BYTES) return false;
+        if (!file.map(dbPath) || file.size() < sizeof(FileHeader) + recordCount * sizeof(Record)) return false;
+
+        // Tổng và điểm trung bình từng block chỉ từ index
+        const Summary* blocks = reinterpret_cast<const Summary*>(static_cast<const char*>(index.data()) + sizeof(IndexHeader));
+        std::vector<Summary> filtered(blockCount);
+        for (uint64_t b = 0; b < blockCount; b++) {
+            filtered[b].clear();
+            for (int m = 0; m < MODE_COUNT; m++) {
+                if (modeMask & (1u << m)) filtered[b].merge(blocks[b * MODE_COUNT + m]);
+            }
+            stats.total.merge(filtered[b]);
+        }
+        stats.blocksRead = (uint32_t)blockCount;
+
+        const Record* all = records(file);
+        if (recordCount <= (uint64_t)TREND_POINTS * BLOCK_RECORDS) {
+            // Lịch sử ngắn: chia từng ván thành các điểm có số ván bằng nhau
+            std::vector<int32_t> scores;
+            scores.reserve(stats.total.count);
+            for (uint64_t i = 0; i < recordCount; i++) {
+                if (inMask(modeMask, all[i].mode)) scores.push_back(all[i].score);
+            }
+            stats.trendPoints = (int)std::min<size_t>(TREND_POINTS, scores.size());
+            for (int p = 0; p < stats.trendPoints; p++) {
+                size_t begin = scores.size() * p / stats.trendPoints;
+                size_t end = scores.size() * (p + 1) / stats.trendPoints;
+                double sum = 0.0;
+                for (size_t i = begin; i < end; i++) sum += scores[i];
+                stats.trend[p] = sum / (end - begin);
+            }
+        } else {
+            // Lịch sử dài: gộp các block có ván thuộc bộ lọc
+            std::vector<const Summary*> used;
+            for (uint64_t b = 0; b < blockCount; b++) {
+                if (filtered[b].count > 0) used.push_back(&filtered[b]);
+            }
+            stats.trendPoints = (int)std::min<size_t>(TREND_POINTS, used.size());
+            for (int p = 0; p < stats.trendPoints; p++) {
+                Summary point;
+                point.clear();
+                for (size_t i = used.size() * p / stats.trendPoints; i < used.size() * (p + 1) / stats.trendPoints; i++) {
+                    point.merge(*used[i]);
+                }
+                stats.trend[p] = point.averageScore();
+            }
+        }
+
+        // Ván gần nhất: đọc lùi từ cuối, có giới hạn để chế độ hiếm không quét cả file
+        uint64_t scanned = 0;
+        double recentSum = 0.0;
+        for (uint64_t i = recordCount; i > 0 && scanned < RECENT_SCAN_LIMIT && stats.recentCount < RECENT_GAMES; i--, scanned++) {
+            if (inMask(modeMask, all[i - 1].mode)) {
+                recentSum += all[i - 1].score;
+                stats.recentCount++;
+            }
+        }
+        stats.recentAverage = stats.recentCount ? recentSum / stats.recentCount : 0.0;
+        return true;
+    }
+}
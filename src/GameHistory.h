@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Lịch sử mọi ván đã kết thúc, chỉ ghi nối thêm. Hai file nhị phân:
+//   history.db      Header | Record[] (32 byte mỗi ván, không bao giờ sửa)
+//   history.db.idx  IndexHeader | Block[] với Block = Summary[MODE_COUNT] cho mỗi BLOCK_RECORDS ván
+// Mỗi lần ghi ván chỉ ghi thêm một record và ghi đè block cuối của index, nên truy vấn
+// chỉ cộng các block (vài trăm byte cho 256 ván) thay vì quét record. Cả hai file được
+// mmap khi truy vấn. Index thiếu hoặc lệch (game bị kill giữa hai lần ghi) được dựng lại
+// từ record lúc mở. Nhiều process có thể cùng ghi một lịch sử (flock quanh mỗi lần ghi).
+namespace GameHistory {
+    const uint32_t BLOCK_RECORDS = 256;
+    const int SCORE_BUCKETS = 24;    // bucket b: điểm trong [2^b, 2^(b+1)), bucket 0 gồm cả 0
+    const int TILE_BUCKETS = 18;     // số mũ ô lớn nhất 0..17
+    const int TREND_POINTS = 32;
+    const uint32_t RECENT_GAMES = 100;
+    const uint32_t RECENT_SCAN_LIMIT = 16 * BLOCK_RECORDS;
+
+    enum Mode {
+        MODE_SINGLE = 0,
+        MODE_HARD = 1,       // --hard
+        MODE_LOCAL = 2,      // hai người trên một máy
+        MODE_VS_CPU = 3,     // người chơi 2 là máy
+        MODE_NET = 4,        // đấu mạng
+        MODE_COUNT = 5
+    };
+    const uint32_t ALL_MODES = (1u << MODE_COUNT) - 1;
+    const char* modeName(int mode);
+
+    struct Record {
+        int64_t timestamp;     // unix giây lúc kết thúc
+        uint64_t seed;         // seed RNG ô mới (0 nếu không có)
+        int32_t score;
+        uint32_t moves;
+        uint32_t durationMs;
+        uint8_t mode;
+        uint8_t player;        // 1 hoặc 2
+        uint8_t maxTile;       // số mũ ô lớn nhất
+        uint8_t reserved;
+    };
+
+    struct Summary {
+        uint32_t count;
+        int32_t bestScore;
+        uint64_t scoreSum;
+        uint64_t moveSum;
+        uint64_t durationSum;
+        int64_t firstTimestamp;
+        int64_t lastTimestamp;
+        uint32_t tileCounts[TILE_BUCKETS];
+        uint32_t scoreBuckets[SCORE_BUCKETS];
+
+        void clear();
+        void add(const Record& record);
+        void merge(const Summary& other);
+        double averageScore() const { return count ? (double)scoreSum / count : 0.0; }
+        // Tỉ lệ ván có ô lớn nhất >= 2^exponent
+        double reachRate(int exponent) const;
+    };
+
+    struct Stats {
+        Summary total;
+        uint64_t records;                // mọi chế độ
+        uint32_t blocksRead;
+        int trendPoints;                 // điểm trung bình theo thời gian, cũ tới mới
+        double trend[TREND_POINTS];
+        uint32_t recentCount;            // tối đa RECENT_GAMES ván gần nhất theo bộ lọc
+        double recentAverage;
+    };
+
+    class Database {
+    public:
+        Database() : dbFd(-1), indexFd(-1), recordCount(0) {}
+        ~Database() { close(); }
+
+        // Tạo file nếu chưa có và đưa index về khớp với record
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const { return dbFd >= 0; }
+        uint64_t size() const { return recordCount; }
+
+        bool append(const Record& record);
+        // modeMask: bit (1 << Mode) của các chế độ được tính
+        bool query(uint32_t modeMask, Stats& stats) const;
+
+    private:
+        // Gọi khi đang giữ khoá: bắt kịp các record do process khác ghi thêm
+        bool refresh();
+        bool rebuildIndex(uint64_t fromRecord);
+        bool writeBlock(uint64_t blockIndex);
+        bool writeIndexCount();
+
+        std::string dbPath;
+        std::string indexPath;
+        int dbFd;
+        int indexFd;
+        uint64_t recordCount;
+        std::vector<Summary> currentBlock;  // block chưa đầy cuối cùng, MODE_COUNT phần tử
+
+        Database(const Database&);
+        Database& operator=(const Database&);
+    };
+}
@@ -0,0 +1,311 @@
+#include "GifEncoder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+    const int LZW_MAX_CODE = 4095;
+    const int LZW_HASH_SIZE = 8192;  // lũy thừa 2, gấp đôi số mã để dò tuyến tính ngắn
+    const size_t EXACT_TABLE_SIZE = 1024;
+
+    inline uint32_t packColor(const unsigned char* pixel) {
+        return ((uint32_t)pixel[0] << 16) | ((uint32_t)pixel[1] << 8) | pixel[2];
+    }
+
+    inline uint32_t nearestKey(uint32_t color) {
+        return ((color >> 6) & 0x3F000) | ((color >> 4) & 0xFC0) | ((color >> 2) & 0x3F);
+    }
+
+    inline uint32_t exactSlot(uint32_t color) {
+        return (uint32_t)((color * 0x9E3779B1u) >> 22) & (EXACT_TABLE_SIZE - 1);
+    }
+
+    void putShort(std::string& out, int value) {
+        out.push_back((char)(value & 0xFF));
+        out.push_back((char)((value >> 8) & 0xFF));
+    }
+
+    // Gom mã LZW có độ dài thay đổi thành các sub-block tối đa 255 byte
+    class BitPacker {
+    public:
+        explicit BitPacker(std::string& output) : out(output), accumulator(0), bitCount(0), blockSize(0) {}
+
+        void put(int code, int codeSize) {
+            accumulator |= (uint32_t)code << bitCount;
+            bitCount += codeSize;
+            while (bitCount >= 8) {
+                pushByte((unsigned char)(accumulator & 0xFF));
+                accumulator >>= 8;
+                bitCount -= 8;
+            }
+        }
+
+        void finish() {
+            if (bitCount > 0) pushByte((unsigned char)(accumulator & 0xFF));
+            accumulator = 0;
+            bitCount = 0;
+            if (blockSize > 0) flushBlock();
+            out.push_back(0);  // block terminator
+        }
+
+    private:
+        std::string& out;
+        uint32_t accumulator;
+        int bitCount;
+        int blockSize;
+        unsigned char block[255];
+
+        void pushByte(unsigned char value) {
+            block[blockSize++] = value;
+            if (blockSize == 255) flushBlock();
+        }
+
+        void flushBlock() {
+            out.push_back((char)blockSize);
+            out.append(reinterpret_cast<const char*>(block), blockSize);
+            blockSize = 0;
+        }
+    };
+}
+
+namespace GifEncoder {
+    Palette::Palette() {}
+
+    int Palette::bits() const {
+        int bits = 1;
+        while ((1 << bits) < size()) bits++;
+        return bits;
+    }
+
+    void Palette::build(const std::vector<const unsigned char*>& images, size_t pixelsPerImage) {
+        std::unordered_map<uint32_t, uint64_t> counts;
+        for (size_t i = 0; i < images.size(); i++) {
+            const unsigned char* pixel = images[i];
+            uint32_t last = 0xFFFFFFFF;
+            std::unordered_map<uint32_t, uint64_t>::iterator lastEntry = counts.end();
+            for (size_t p = 0; p < pixelsPerImage; p++, pixel += 3) {
+                uint32_t color = packColor(pixel);
+                if (color != last) {
+                    lastEntry = counts.insert(std::make_pair(color, (uint64_t)0)).first;
+                    last = color;
+                }
+                lastEntry->second++;
+            }
+        }
+
+        std::vector<std::pair<uint64_t, uint32_t> > ranked;
+        ranked.reserve(counts.size());
+        for (std::unordered_map<uint32_t, uint64_t>::const_iterator it = counts.begin(); it != counts.end(); ++it) {
+            ranked.push_back(std::make_pair(it->second, it->first));
+        }
+        std::sort(ranked.begin(), ranked.end(), std::greater<std::pair<uint64_t, uint32_t> >());
+        if (ranked.size() > (size_t)MAX_COLORS) ranked.resize(MAX_COLORS);
+        if (ranked.empty()) ranked.push_back(std::make_pair((uint64_t)0, (uint32_t)0));
+
+        rgb.clear();
+        for (size_t i = 0; i < ranked.size(); i++) {
+            uint32_t color = ranked[i].second;
+            rgb.push_back((unsigned char)(color >> 16));
+            rgb.push_back((unsigned char)(color >> 8));
+            rgb.push_back((unsigned char)color);
+        }
+
+        // Màu chính xác: dò tuyến tính, lưu color + 1 để 0 nghĩa là ô trống
+        exactKeys.assign(EXACT_TABLE_SIZE, 0);
+        exactIndices.assign(EXACT_TABLE_SIZE, 0);
+        for (int i = 0; i < size(); i++) {
+            uint32_t color = packColor(&rgb[i * 3]);
+            uint32_t slot = exactSlot(color);
+            while (exactKeys[slot] != 0) slot = (slot + 1) & (EXACT_TABLE_SIZE - 1);
+            exactKeys[slot] = color + 1;
+            exactIndices[slot] = (uint8_t)i;
+        }
+
+        // Màu lạ (hiếm: bảng màu bị cắt bớt) lấy màu gần tâm ô 6 bit nhất
+        nearest.assign(1 << 18, 0);
+        for (uint32_t key = 0; key < nearest.size(); key++) {
+            int r = (int)((key >> 12) << 2) | 2;
+            int g = (int)(((key >> 6) & 0x3F) << 2) | 2;
+            int b = (int)((key & 0x3F) << 2) | 2;
+            int best = 0;
+            int bestDistance = 1 << 30;
+            for (int i = 0; i < size(); i++) {
+                int dr = r - rgb[i * 3];
+                int dg = g - rgb[i * 3 + 1];
+                int db = b - rgb[i * 3 + 2];
+                int distance = dr * dr + dg * dg + db * db;
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = i;
+                }
+            }
+            nearest[key] = (uint8_t)best;
+        }
+    }
+
+    int Palette::findExact(uint32_t color) const {
+        uint32_t slot = exactSlot(color);
+        while (exactKeys[slot] != 0) {
+            if (exactKeys[slot] == color + 1) return exactIndices[slot];
+            slot = (slot + 1) & (EXACT_TABLE_SIZE - 1);
+        }
+        return -1;
+    }
+
+    void Palette::map(const unsigned char* pixels, size_t count, uint8_t* indices) const {
+        // Ảnh game chủ yếu là các mảng màu đơn: nhớ màu trước để bỏ qua tra bảng
+        uint32_t last = 0xFFFFFFFF;
+        uint8_t lastIndex = 0;
+        for (size_t p = 0; p < count; p++, pixels += 3) {
+            uint32_t color = packColor(pixels);
+            if (color != last) {
+                int index = findExact(color);
+                lastIndex = index >= 0 ? (uint8_t)index : nearest[nearestKey(color)];
+                last = color;
+            }
+            indices[p] = lastIndex;
+        }
+    }
+
+    bool diffRect(const uint8_t* previous, const uint8_t* current, int width, int height,
+                  int& x, int& y, int& w, int& h) {
+        int top = 0;
+        while (top < height && std::memcmp(previous + (size_t)top * width, current + (size_t)top * width, width) == 0) top++;
+        if (top == height) return false;
+        int bottom = height - 1;
+        while (bottom > top && std::memcmp(previous + (size_t)bottom * width, current + (size_t)bottom * width, width) == 0) bottom--;
+
+        int left = width;
+        int right = -1;
+        for (int row = top; row <= bottom; row++) {
+            const uint8_t* a = previous + (size_t)row * width;
+            const uint8_t* b = current + (size_t)row * width;
+            int l = 0;
+            while (l < left && a[l] == b[l]) l++;
+            if (l < left) left = l;
+            int r = width - 1;
+            while (r > right && a[r] == b[r]) r--;
+            if (r > right) right = r;
+        }
+        x = left;
+        y = top;
+        w = right - left + 1;
+        h = bottom - top + 1;
+        return true;
+    }
+
+    void encodeFrame(const uint8_t* indices, int width, int x, int y, int w, int h,
+                     int delayCs, int bits, std::string& out) {
+        // Graphic Control Extension: giữ frame cũ dưới vùng mới (disposal 1), không trong suốt
+        out.push_back((char)0x21);
+        out.push_back((char)0xF9);
+        out.push_back((char)0x04);
+        out.push_back((char)0x04);
+        putShort(out, delayCs);
+        out.push_back(0);
+        out.push_back(0);
+
+        // Image Descriptor, dùng bảng màu toàn cục
+        out.push_back((char)0x2C);
+        putShort(out, x);
+        putShort(out, y);
+        putShort(out, w);
+        putShort(out, h);
+        out.push_back(0);
+
+        int minCodeSize = std::max(2, bits);
+        int clearCode = 1 << minCodeSize;
+        out.push_back((char)minCodeSize);
+
+        // Từ điển LZW: khoá (mã tiền tố << 8 | chỉ số màu) trong bảng băm dò tuyến tính
+        std::vector<int32_t> keys(LZW_HASH_SIZE, -1);
+        std::vector<uint16_t> codes(LZW_HASH_SIZE, 0);
+        BitPacker packer(out);
+        int codeSize = minCodeSize + 1;
+        int maxCode = clearCode + 1;
+        int current = -1;
+        packer.put(clearCode, codeSize);
+
+        for (int row = 0; row < h; row++) {
+            const uint8_t* pixel = indices + (size_t)(y + row) * width + x;
+            for (int col = 0; col < w; col++) {
+                int value = pixel[col];
+                if (current < 0) {
+                    current = value;
+                    continue;
+                }
+                int32_t key = (current << 8) | value;
+                uint32_t slot = ((uint32_t)key * 0x9E3779B1u) >> 19;
+                while (keys[slot] != -1 && keys[slot] != key) slot = (slot + 1) & (LZW_HASH_SIZE - 1);
+                if (keys[slot] == key) {
+                    current = codes[slot];
+                    continue;
+                }
+
+                packer.put(current, codeSize);
+                maxCode++;
+                keys[slot] = key;
+                codes[slot] = (uint16_t)maxCode;
+                if (maxCode >= (1 << codeSize)) codeSize++;
+                if (maxCode == LZW_MAX_CODE) {
+                    // Từ điển đầy: phát clear code và bắt đầu lại
+                    packer.put(clearCode, codeSize);
+                    std::fill(keys.begin(), keys.end(), -1);
+                    codeSize = minCodeSize + 1;
+                    maxCode = clearCode + 1;
+                }
+                current = value;
+            }
+        }
+        if (current >= 0) packer.put(current, codeSize);
+        packer.put(clearCode + 1, codeSize);
+        packer.finish();
+    }
+
+    bool Writer::open(const std::string& outputPath, int width, int height, const Palette& palette) {
+        path = outputPath;
+        tempPath = outputPath + ".tmp";
+        file.open(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Cannot write " << tempPath << std::endl;
+            return false;
+        }
+
+        int bits = palette.bits();
+        std::string header("GIF89a");
+        putShort(header, width);
+        putShort(header, height);
+        header.push_back((char)(0x80 | ((bits - 1) << 4) | (bits - 1)));
+        header.push_back(0);
+        header.push_back(0);
+        header.append(reinterpret_cast<const char*>(palette.colors()), palette.size() * 3);
+        header.append((size_t)((1 << bits) - palette.size()) * 3, '\0');
+
+        // NETSCAPE2.0: lặp vô hạn
+        const char loop[] = {0x21, (char)0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+                             0x03, 0x01, 0x00, 0x00, 0x00};
+        header.append(loop, sizeof(loop));
+        bytes = 0;
+        return write(header);
+    }
+
+    bool Writer::write(const std::string& frame) {
+        file.write(frame.data(), frame.size());
+        bytes += frame.size();
+        return !file.fail();
+    }
+
+    bool Writer::close() {
+        file.put(0x3B);
+        bytes++;
+        file.close();
+        if (!file || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "Error while writing " << path << std::endl;
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Bộ mã hoá GIF89a tự viết, không cần thư viện ngoài. Dùng một bảng màu toàn cục
+// (tối đa 256 màu) cho cả ảnh động. Mỗi frame chỉ mã hoá LZW phần hình chữ nhật
+// khác với frame trước, nên frame giữa hai nước đi chỉ tốn vài KB.
+namespace GifEncoder {
+    const int MAX_COLORS = 256;
+
+    class Palette {
+    public:
+        Palette();
+
+        // Giữ tối đa 256 màu hay gặp nhất trong các ảnh mẫu RGB24
+        void build(const std::vector<const unsigned char*>& images, size_t pixelsPerImage);
+        int size() const { return (int)(rgb.size() / 3); }
+        // Số bit mỗi chỉ số màu (bảng màu GIF có 2^bits màu)
+        int bits() const;
+        const unsigned char* colors() const { return rgb.data(); }
+
+        // Đổi RGB24 sang chỉ số màu: màu có trong bảng giữ nguyên, màu lạ lấy màu gần nhất
+        void map(const unsigned char* pixels, size_t count, uint8_t* indices) const;
+
+    private:
+        std::vector<unsigned char> rgb;
+        std::vector<uint32_t> exactKeys;     // bảng băm màu chính xác -> chỉ số (key 0 = trống)
+        std::vector<uint8_t> exactIndices;
+        std::vector<uint8_t> nearest;        // 6 bit mỗi kênh -> màu gần nhất
+
+        int findExact(uint32_t color) const;
+    };
+
+    // Hình chữ nhật nhỏ nhất chứa mọi pixel khác nhau; trả về false nếu hai ảnh giống hệt
+    bool diffRect(const uint8_t* previous, const uint8_t* current, int width, int height,
+                  int& x, int& y, int& w, int& h);
+
+    // Graphic Control Extension + Image Descriptor + dữ liệu LZW của vùng (x, y, w, h)
+    // trong ảnh chỉ số rộng width, nối vào out
+    void encodeFrame(const uint8_t* indices, int width, int x, int y, int w, int h,
+                     int delayCs, int bits, std::string& out);
+
+    class Writer {
+    public:
+        Writer() : bytes(0) {}
+
+        // Ghi vào file tạm, close() đổi tên thành path
+        bool open(const std::string& path, int width, int height, const Palette& palette);
+        bool write(const std::string& frame);
+        bool close();
+        uint64_t size() const { return bytes; }
+
+    private:
+        std::string path;
+        std::string tempPath;
+        std::ofstream file;
+        uint64_t bytes;
+    };
+}
@@ -0,0 +1,82 @@
+#include "LatencyTracker.h"
+#include <cstdio>
+#include <fstream>
+
+LatencyTracker::LatencyTracker() {
+    reset();
+}
+
+void LatencyTracker::reset() {
+    pendingCount = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = 0;
+    }
+    count = 0;
+    sumMs = 0;
+    maxMs = 0;
+}
+
+void LatencyTracker::onBoardChanged(Uint32 inputTimestamp) {
+    if (pendingCount < MAX_PENDING) {
+        pending[pendingCount++] = inputTimestamp;
+    }
+}
+
+void LatencyTracker::onPresent(Uint32 presentTicks) {
+    for (int i = 0; i < pendingCount; i++) {
+        int latency = presentTicks >= pending[i] ? (int)(presentTicks - pending[i]) : 0;
+        buckets[latency < BUCKET_COUNT - 1 ? latency : BUCKET_COUNT - 1]++;
+        count++;
+        sumMs += latency;
+        if (latency > maxMs) maxMs = latency;
+    }
+    pendingCount = 0;
+}
+
+uint64_t LatencyTracker::sampleCount() const {
+    return count;
+}
+
+double LatencyTracker::mean() const {
+    return count ? (double)sumMs / count : 0.0;
+}
+
+int LatencyTracker::percentile(double p) const {
+    if (count == 0) return 0;
+    uint64_t target = (uint64_t)(p / 100.0 * count + 0.5);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i];
+        if (seen >= target) return i;
+    }
+    return BUCKET_COUNT - 1;
+}
+
+int LatencyTracker::maxLatency() const {
+    return maxMs;
+}
+
+void LatencyTracker::formatSummary(char* buffer, size_t size) const {
+    std::snprintf(buffer, size, "input->present: n=%llu mean=%.1fms p50=%dms p95=%dms p99=%dms max=%dms",
+                  (unsigned long long)count, mean(), percentile(50), percentile(95), percentile(99), maxMs);
+}
+
+void LatencyTracker::printSummary(std::ostream& out) const {
+    char summary[160];
+    formatSummary(summary, sizeof(summary));
+    out << summary << std::endl;
+}
+
+bool LatencyTracker::exportCsv(const std::string& path) const {
+    std::ofstream file(path.c_str(), std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "latency_ms,count\n";
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        if (buckets[i] == 0) continue;
+        file << i << (i == BUCKET_COUNT - 1 ? "+" : "") << "," << buckets[i] << "\n";
+    }
+    return !file.fail();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Đo độ trễ từ SDL_KEYDOWN (timestamp của event) tới SDL_RenderPresent đầu tiên
+// hiển thị bàn cờ mới. Histogram theo từng ms, không cấp phát khi ghi mẫu.
+class LatencyTracker {
+public:
+    static const int BUCKET_COUNT = 101;  // 0..99 ms, bucket cuối là >= 100 ms
+    static const int MAX_PENDING = 16;
+
+    LatencyTracker();
+
+    // Gọi khi một phím làm thay đổi bàn cờ
+    void onBoardChanged(Uint32 inputTimestamp);
+    // Gọi ngay sau SDL_RenderPresent
+    void onPresent(Uint32 presentTicks);
+    void reset();
+
+    uint64_t sampleCount() const;
+    double mean() const;
+    int percentile(double p) const;
+    int maxLatency() const;
+
+    void formatSummary(char* buffer, size_t size) const;
+    void printSummary(std::ostream& out) const;
+    bool exportCsv(const std::string& path) const;
+
+private:
+    Uint32 pending[MAX_PENDING];
+    int pendingCount;
+    uint64_t buckets[BUCKET_COUNT];
+    uint64_t count;
+    uint64_t sumMs;
+    int maxMs;
+};
@@ -0,0 +1,365 @@
+#include "Leaderboard.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <functional>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[8] = {'2', '0', '4', '8', 'T', 'O', 'P', 'N'};
+    const uint32_t VERSION = 1;
+
+    // Khoá flock tới hết phạm vi: hai game cùng thư mục (đấu mạng qua loopback) có thể
+    // cùng ghi một bảng
+    class FileLock {
+    public:
+        explicit FileLock(int fd) : fd(fd) {
+            while (flock(fd, LOCK_EX) != 0 && errno == EINTR) {}
+        }
+        ~FileLock() { flock(fd, LOCK_UN); }
+
+    private:
+        int fd;
+        FileLock(const FileLock&);
+        FileLock& operator=(const FileLock&);
+    };
+}
+
+Leaderboard::FileHeader Leaderboard::makeHeader(uint32_t capacity) {
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.capacity = capacity;
+    header.entrySize = sizeof(Leaderboard::Entry);
+    header.generation = 0;
+    return header;
+}
+
+Leaderboard::Leaderboard()
+    : fd(-1), maxEntries(0), slotCount(0), generation(0), root(-1), rngState(0x9E3779B97F4A7C15ULL) {}
+
+bool Leaderboard::open(const std::string& path, uint32_t capacity) {
+    close();
+    filePath = path;
+    maxEntries = capacity;
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot open leaderboard " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    FileLock lock(fd);
+    FileHeader header;
+    std::vector<Entry> entries;
+    if (!readFile(header, entries)) {
+        close();
+        return false;
+    }
+    build(entries);
+    slotCount = (uint32_t)entries.size();
+    generation = header.generation;
+
+    if (size() > capacity) {
+        // N nhỏ đi: giữ capacity mục cao nhất, ghi lại file một lần
+        std::vector<Entry> kept;
+        kept.reserve(capacity);
+        for (uint32_t i = 0; i < capacity; i++) kept.push_back(at(i));
+        build(kept);
+        if (!rewrite(kept)) {
+            std::cerr << "Cannot shrink leaderboard " << path << std::endl;
+            close();
+            return false;
+        }
+    } else if (header.capacity != capacity) {
+        header = makeHeader(capacity);
+        header.generation = generation;
+        if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+            std::cerr << "Cannot write leaderboard " << path << std::endl;
+        }
+    }
+    return true;
+}
+
+bool Leaderboard::readFile(FileHeader& header, std::vector<Entry>& entries) {
+    struct stat info;
+    if (fstat(fd, &info) != 0) return false;
+    entries.clear();
+    if (info.st_size == 0) {
+        header = makeHeader(maxEntries);
+        if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+            std::cerr << "Cannot write leaderboard " << filePath << std::endl;
+            return false;
+        }
+        return true;
+    }
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.entrySize != sizeof(Entry)) {
+        std::cerr << filePath << " is not a version " << VERSION << " leaderboard" << std::endl;
+        return false;
+    }
+    // Entry ghi dở ở cuối file bị bỏ qua và sẽ bị ghi đè
+    entries.resize(((size_t)info.st_size - sizeof(FileHeader)) / sizeof(Entry));
+    size_t bytes = entries.size() * sizeof(Entry);
+    if (bytes > 0 && pread(fd, entries.data(), bytes, sizeof(FileHeader)) != (ssize_t)bytes) {
+        std::cerr << "Cannot read leaderboard " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Leaderboard::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    slotCount = 0;
+    nodes.clear();
+    freeNodes.clear();
+    root = -1;
+}
+
+void Leaderboard::build(const std::vector<Entry>& entries) {
+    // Sắp xếp một lần rồi dựng cây cân bằng theo thứ tự BFS, thay cho n lần insert với
+    // truy cập ngẫu nhiên. Độ ưu tiên ngẫu nhiên được sắp giảm dần và gán theo BFS nên
+    // cha luôn lớn hơn con: vẫn là treap hợp lệ cho các lần insert sau, và các tầng trên
+    // cùng nằm liền nhau trong bộ nhớ
+    nodes.clear();
+    freeNodes.clear();
+    root = -1;
+    if (entries.empty()) return;
+    std::vector<Node> sorted(entries.size());
+    std::vector<uint32_t> priorities(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        sorted[i].entry = entries[i];
+        sorted[i].slot = (uint32_t)i;
+        priorities[i] = nextPriority();
+    }
+    std::sort(sorted.begin(), sorted.end(), [this](const Node& a, const Node& b) { return before(a, b); });
+    std::sort(priorities.begin(), priorities.end(), std::greater<uint32_t>());
+
+    struct Range {
+        size_t begin;
+        size_t end;
+        int32_t parent;
+        bool isLeft;
+    };
+    std::vector<Range> queue;
+    queue.reserve(entries.size());
+    queue.push_back(Range{0, sorted.size(), -1, false});
+    nodes.reserve(std::max<size_t>(entries.size(), std::min<size_t>(maxEntries, entries.size() + 1024)));
+    for (size_t next = 0; next < queue.size(); next++) {
+        Range range = queue[next];
+        size_t middle = range.begin + (range.end - range.begin) / 2;
+        Node node = sorted[middle];
+        node.priority = priorities[nodes.size()];
+        node.left = node.right = -1;
+        node.size = 1;
+        int32_t index = (int32_t)nodes.size();
+        nodes.push_back(node);
+        if (range.parent < 0) {
+            root = index;
+        } else if (range.isLeft) {
+            nodes[range.parent].left = index;
+        } else {
+            nodes[range.parent].right = index;
+        }
+        if (range.begin < middle) queue.push_back(Range{range.begin, middle, index, true});
+        if (middle + 1 < range.end) queue.push_back(Range{middle + 1, range.end, index, false});
+    }
+    // Con luôn đứng sau cha trong thứ tự BFS
+    for (size_t i = nodes.size(); i > 0; i--) update((int32_t)(i - 1));
+}
+
+uint32_t Leaderboard::nextPriority() {
+    // xorshift64: độ ưu tiên ngẫu nhiên giữ treap cân bằng theo kỳ vọng
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)(rngState >> 32);
+}
+
+bool Leaderboard::rewrite(const std::vector<Entry>& entries) {
+    FileHeader header = makeHeader(maxEntries);
+    header.generation = ++generation;
+    size_t bytes = entries.size() * sizeof(Entry);
+    if (ftruncate(fd, 0) != 0 || pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) return false;
+    if (bytes > 0 && pwrite(fd, entries.data(), bytes, sizeof(FileHeader)) != (ssize_t)bytes) return false;
+    slotCount = (uint32_t)entries.size();
+    return true;
+}
+
+bool Leaderboard::writeSlot(uint32_t slot, const Entry& entry) {
+    off_t offset = (off_t)(sizeof(FileHeader) + (uint64_t)slot * sizeof(Entry));
+    return pwrite(fd, &entry, sizeof(entry), offset) == (ssize_t)sizeof(entry);
+}
+
+bool Leaderboard::before(const Node& a, const Node& b) const {
+    if (a.entry.score != b.entry.score) return a.entry.score > b.entry.score;
+    if (a.entry.timestamp != b.entry.timestamp) return a.entry.timestamp < b.entry.timestamp;
+    return a.slot < b.slot;
+}
+
+void Leaderboard::update(int32_t node) {
+    Node& n = nodes[node];
+    n.size = 1 + (n.left < 0 ? 0 : nodes[n.left].size) + (n.right < 0 ? 0 : nodes[n.right].size);
+}
+
+// left: các nút xếp trên key, right: phần còn lại
+void Leaderboard::split(int32_t node, const Node& key, int32_t& left, int32_t& right) {
+    if (node < 0) {
+        left = right = -1;
+        return;
+    }
+    if (before(nodes[node], key)) {
+        split(nodes[node].right, key, nodes[node].right, right);
+        left = node;
+    } else {
+        split(nodes[node].left, key, left, nodes[node].left);
+        right = node;
+    }
+    update(node);
+}
+
+// left: count nút đầu tiên theo thứ hạng
+void Leaderboard::splitBySize(int32_t node, uint32_t count, int32_t& left, int32_t& right) {
+    if (node < 0) {
+        left = right = -1;
+        return;
+    }
+    uint32_t leftSize = nodes[node].left < 0 ? 0 : nodes[nodes[node].left].size;
+    if (count <= leftSize) {
+        splitBySize(nodes[node].left, count, left, nodes[node].left);
+        right = node;
+    } else {
+        splitBySize(nodes[node].right, count - leftSize - 1, nodes[node].right, right);
+        left = node;
+    }
+    update(node);
+}
+
+int32_t Leaderboard::merge(int32_t left, int32_t right) {
+    if (left < 0) return right;
+    if (right < 0) return left;
+    if (nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        update(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+}
+
+int32_t Leaderboard::newNode(const Entry& entry, uint32_t slot) {
+    Node node;
+    node.entry = entry;
+    node.slot = slot;
+    node.priority = nextPriority();
+    node.size = 1;
+    node.left = -1;
+    node.right = -1;
+    if (!freeNodes.empty()) {
+        int32_t index = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[index] = node;
+        return index;
+    }
+    nodes.push_back(node);
+    return (int32_t)nodes.size() - 1;
+}
+
+void Leaderboard::insertNode(int32_t node) {
+    int32_t left, right;
+    split(root, nodes[node], left, right);
+    root = merge(merge(left, node), right);
+}
+
+uint32_t Leaderboard::insert(const Entry& entry) {
+    if (fd < 0 || maxEntries == 0) return 0;
+    // Điểm thấp hơn mục cuối thì không cần khoá: với cùng N, game khác chỉ có thể đẩy mục
+    // cuối lên cao hơn
+    if (size() >= maxEntries && entry.score < at(size() - 1).score) return 0;
+    FileLock lock(fd);
+    // Process khác đã ghi từ lần trước: nạp lại cả bảng dưới khoá trước khi chọn ô
+    uint32_t onDisk;
+    if (pread(fd, &onDisk, sizeof(onDisk), offsetof(FileHeader, generation)) == (ssize_t)sizeof(onDisk) &&
+        onDisk != generation) {
+        FileHeader header;
+        std::vector<Entry> entries;
+        if (!readFile(header, entries)) return 0;
+        build(entries);
+        slotCount = (uint32_t)entries.size();
+        generation = header.generation;
+    }
+    Node probe;
+    probe.entry = entry;
+    probe.slot = UINT32_MAX;  // điểm bằng nhau: mục mới đứng sau
+
+    uint32_t slot;
+    if (size() >= maxEntries) {
+        // Đầy: chỉ vào bảng nếu xếp trên mục thấp nhất, và lấy luôn ô của mục đó trong file
+        int32_t kept, last;
+        splitBySize(root, size() - 1, kept, last);
+        if (!before(probe, nodes[last])) {
+            root = merge(kept, last);
+            return 0;
+        }
+        slot = nodes[last].slot;
+        freeNodes.push_back(last);
+        root = kept;
+    } else {
+        slot = slotCount++;
+    }
+    generation++;
+    if (!writeSlot(slot, entry) ||
+        pwrite(fd, &generation, sizeof(generation), offsetof(FileHeader, generation)) != (ssize_t)sizeof(generation)) {
+        std::cerr << "Cannot write leaderboard " << filePath << std::endl;
+    }
+    int32_t node = newNode(entry, slot);
+    insertNode(node);
+
+    uint32_t rank = 1;
+    for (int32_t current = root; current >= 0;) {
+        const Node& n = nodes[current];
+        if (before(n, nodes[node])) {
+            rank += 1 + (n.left < 0 ? 0 : nodes[n.left].size);
+            current = n.right;
+        } else {
+            current = n.left;
+        }
+    }
+    return rank;
+}
+
+uint32_t Leaderboard::rankOf(int32_t score) const {
+    uint32_t better = 0;
+    for (int32_t current = root; current >= 0;) {
+        const Node& n = nodes[current];
+        if (n.entry.score > score) {
+            better += 1 + (n.left < 0 ? 0 : nodes[n.left].size);
+            current = n.right;
+        } else {
+            current = n.left;
+        }
+    }
+    return better + 1;
+}
+
+const Leaderboard::Entry& Leaderboard::at(uint32_t index) const {
+    int32_t current = root;
+    while (true) {
+        const Node& n = nodes[current];
+        uint32_t leftSize = n.left < 0 ? 0 : nodes[n.left].size;
+        if (index < leftSize) {
+            current = n.left;
+        } else if (index == leftSize) {
+            return n.entry;
+        } else {
+            index -= leftSize + 1;
+            current = n.right;
+        }
+    }
+}
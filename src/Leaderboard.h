@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Bảng N điểm cao nhất lưu trên đĩa. Trong bộ nhớ là treap có kích thước cây con
+// (order-statistic tree) nên thêm điểm, bỏ điểm thấp nhất, tính hạng và lấy mục thứ k
+// đều O(log n), dùng được cả với N rất lớn (kiosk). File là Header | Entry[] không sắp
+// xếp: mỗi lần vào bảng chỉ ghi đúng một Entry 16 byte, vào ô trống cuối file hoặc đè
+// lên ô của mục vừa bị đẩy ra, cùng bộ đếm thế hệ 4 byte trong header, không bao giờ ghi
+// lại cả file. Mỗi lần ghi giữ flock; thấy thế hệ đổi (game khác cùng thư mục vừa ghi)
+// thì nạp lại bảng trước khi thêm.
+class Leaderboard {
+public:
+    struct Entry {
+        int32_t score;
+        uint8_t mode;        // GameHistory::Mode
+        uint8_t player;      // 1 hoặc 2
+        uint8_t maxTile;     // số mũ ô lớn nhất
+        uint8_t reserved;
+        int64_t timestamp;   // unix giây
+    };
+
+    Leaderboard();
+    ~Leaderboard() { close(); }
+
+    // Nạp hoặc tạo file với sức chứa capacity. File cũ lớn hơn được cắt còn capacity mục cao nhất
+    bool open(const std::string& path, uint32_t capacity);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    uint32_t size() const { return root < 0 ? 0 : nodes[root].size; }
+    uint32_t capacity() const { return maxEntries; }
+
+    // Hạng của entry sau khi vào bảng (1 = cao nhất), 0 nếu không đủ điểm. Điểm bằng nhau
+    // thì mục vào trước đứng trên
+    uint32_t insert(const Entry& entry);
+    // Hạng mà score sẽ có nếu ván kết thúc lúc này: 1 + số mục có điểm cao hơn
+    uint32_t rankOf(int32_t score) const;
+    // Mục thứ index, 0 = cao nhất; index < size()
+    const Entry& at(uint32_t index) const;
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t capacity;    // chỉ để tham khảo, sức chứa thật lấy từ tuỳ chọn
+        uint32_t entrySize;
+        uint32_t generation;  // tăng mỗi lần ghi: process khác thấy đổi thì nạp lại
+    };
+
+    struct Node {
+        Entry entry;
+        uint32_t slot;       // vị trí Entry trong file
+        uint32_t priority;
+        uint32_t size;
+        int32_t left;
+        int32_t right;
+    };
+
+    bool before(const Node& a, const Node& b) const;
+    void update(int32_t node);
+    void split(int32_t node, const Node& key, int32_t& left, int32_t& right);
+    void splitBySize(int32_t node, uint32_t count, int32_t& left, int32_t& right);
+    int32_t merge(int32_t left, int32_t right);
+    int32_t newNode(const Entry& entry, uint32_t slot);
+    uint32_t nextPriority();
+    // Dựng lại cây từ mọi entry, slot của entry i là i
+    void build(const std::vector<Entry>& entries);
+    void insertNode(int32_t node);
+    static FileHeader makeHeader(uint32_t capacity);
+    bool writeSlot(uint32_t slot, const Entry& entry);
+    // Đọc header và mọi Entry; file rỗng thì ghi header mới
+    bool readFile(FileHeader& header, std::vector<Entry>& entries);
+    bool rewrite(const std::vector<Entry>& entries);
+
+    std::string filePath;
+    int fd;
+    uint32_t maxEntries;
+    uint32_t slotCount;             // số Entry đã có trong file
+    uint32_t generation;            // thế hệ file ứng với cây trong bộ nhớ
+    std::vector<Node> nodes;
+    std::vector<int32_t> freeNodes;
+    int32_t root;
+    uint64_t rngState;
+
+    Leaderboard(const Leaderboard&);
+    Leaderboard& operator=(const Leaderboard&);
+};
@@ -0,0 +1,69 @@
+#include "LiveState.h"
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+bool LivePublisher::open(const std::string& name) {
+    close();
+    // shm_open cần tên bắt đầu bằng '/'
+    std::string fullName = name.empty() || name[0] != '/' ? "/" + name : name;
+    int fd = shm_open(fullName.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot create shared memory " << fullName << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, sizeof(Live2048Segment)) != 0) {
+        std::cerr << "Cannot resize shared memory " << fullName << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, sizeof(Live2048Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Cannot map shared memory " << fullName << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    segment = static_cast<Live2048Segment*>(mapping);
+    segmentName = fullName;
+
+    // Segment cũ của lần chạy trước có thể còn sequence lẻ nếu game bị kill giữa lúc ghi
+    __atomic_store_n(&segment->sequence, 0u, __ATOMIC_RELAXED);
+    segment->version = LIVE2048_VERSION;
+    std::memset(&segment->data, 0, sizeof(segment->data));
+    __atomic_store_n(&segment->magic, LIVE2048_MAGIC, __ATOMIC_RELEASE);
+    std::cout << "Publishing live state to shared memory " << fullName << std::endl;
+    return true;
+}
+
+void LivePublisher::close() {
+    if (segment) {
+        munmap(segment, sizeof(Live2048Segment));
+        shm_unlink(segmentName.c_str());
+        segment = nullptr;
+    }
+}
+
+void LivePublisher::publish(const Live2048Snapshot& snapshot) {
+    if (!segment) return;
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);  // vDSO, không vào kernel
+
+    // Chỉ game ghi nên không cần RMW: sequence lẻ, ghi dữ liệu, sequence chẵn
+    uint32_t sequence = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    Live2048Snapshot& data = segment->data;
+    __atomic_store_n(&data.board, snapshot.board, __ATOMIC_RELAXED);
+    __atomic_store_n(&data.board2, snapshot.board2, __ATOMIC_RELAXED);
+    __atomic_store_n(&data.score, snapshot.score, __ATOMIC_RELAXED);
+    __atomic_store_n(&data.score2, snapshot.score2, __ATOMIC_RELAXED);
+    __atomic_store_n(&data.flags, snapshot.flags, __ATOMIC_RELAXED);
+    __atomic_store_n(&data.writerPid, snapshot.writerPid, __ATOMIC_RELAXED);
+    __atomic_store_n(&data.moves, snapshot.moves, __ATOMIC_RELAXED);
+    __atomic_store_n(&data.updateNs, (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec, __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include "live2048.h"
+
+// Phía game của vùng nhớ chia sẻ mô tả trong live2048.h. publish chỉ gồm vài lệnh store
+// vào một cache line, không syscall, không khoá, không phụ thuộc người đọc có chạy hay không
+class LivePublisher {
+public:
+    LivePublisher() : segment(nullptr) {}
+    ~LivePublisher() { close(); }
+
+    // Tạo (hoặc dùng lại) segment tên name, ví dụ "/2048-live"
+    bool open(const std::string& name);
+    // Gỡ mmap và shm_unlink để người đọc biết game đã thoát
+    void close();
+
+    bool isOpen() const { return segment != nullptr; }
+    void publish(const Live2048Snapshot& snapshot);
+
+private:
+    Live2048Segment* segment;
+    std::string segmentName;
+
+    LivePublisher(const LivePublisher&);
+    LivePublisher& operator=(const LivePublisher&);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Ánh xạ cả file chỉ đọc bằng mmap; dùng cho các bảng tra dựng sẵn (opening book, tablebase)
+class MappedFile {
+public:
+    MappedFile() : mapping(nullptr), mappingSize(0) {}
+    ~MappedFile() { unmap(); }
+
+    bool map(const std::string& path);
+    void unmap();
+
+    bool isMapped() const { return mapping != nullptr; }
+    const void* data() const { return mapping; }
+    size_t size() const { return mappingSize; }
+
+private:
+    void* mapping;
+    size_t mappingSize;
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
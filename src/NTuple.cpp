@@ -0,0 +1,262 @@
+#include "NTuple.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char WEIGHTS_MAGIC[8] = {'2', '0', '4', '8', 'N', 'T', 'W', '1'};
+    const uint32_t WEIGHTS_VERSION = 1;
+
+    // Ô theo thứ tự row-major (nibble row * 4 + col)
+    const int CELLS_4X4[4 * 4] = {
+        0, 1, 2, 3,     // hàng ngoài
+        4, 5, 6, 7,     // hàng trong
+        0, 1, 4, 5,     // hình vuông ở góc
+        1, 2, 5, 6      // hình vuông ở cạnh
+    };
+    const int CELLS_4X6[4 * 6] = {
+        0, 1, 2, 3, 4, 5,
+        4, 5, 6, 7, 8, 9,
+        0, 1, 2, 4, 5, 6,
+        4, 5, 6, 8, 9, 10
+    };
+
+    // Lật trái-phải: đảo thứ tự 4 nibble trong mỗi hàng
+    Engine::Board flipColumns(Engine::Board b) {
+        return ((b & 0x000F000F000F000FULL) << 12) | ((b & 0x00F000F000F000F0ULL) << 4) |
+               ((b & 0x0F000F000F000F00ULL) >> 4) | ((b & 0xF000F000F000F000ULL) >> 12);
+    }
+
+    // Lật trên-dưới: đảo thứ tự 4 hàng 16 bit
+    Engine::Board flipRows(Engine::Board b) {
+        return (b << 48) | ((b & 0xFFFF0000ULL) << 16) | ((b >> 16) & 0xFFFF0000ULL) | (b >> 48);
+    }
+}
+
+NTupleNetwork::NTupleNetwork() : currentPreset(PRESET_4X4), tupleCount(0), tupleSize(0), tableSize(0), cells(nullptr),
+    weights(nullptr), mapping(nullptr), mappingSize(0) {}
+
+NTupleNetwork::~NTupleNetwork() {
+    unmap();
+}
+
+bool NTupleNetwork::parsePreset(const char* text, Preset& preset) {
+    if (std::strcmp(text, "4x4") == 0) {
+        preset = PRESET_4X4;
+    } else if (std::strcmp(text, "4x6") == 0) {
+        preset = PRESET_4X6;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* NTupleNetwork::presetName(Preset preset) {
+    return preset == PRESET_4X6 ? "4x6" : "4x4";
+}
+
+void NTupleNetwork::setPreset(Preset preset) {
+    currentPreset = preset;
+    tupleCount = 4;
+    tupleSize = preset == PRESET_4X6 ? 6 : 4;
+    tableSize = (size_t)1 << (4 * tupleSize);
+    cells = preset == PRESET_4X6 ? CELLS_4X6 : CELLS_4X4;
+}
+
+void NTupleNetwork::symmetries(Engine::Board board, Engine::Board out[SYMMETRY_COUNT]) {
+    Engine::Board transposed = Engine::transpose(board);
+    out[0] = board;
+    out[1] = flipColumns(board);
+    out[2] = flipRows(board);
+    out[3] = flipRows(out[1]);
+    out[4] = transposed;
+    out[5] = flipColumns(transposed);
+    out[6] = flipRows(transposed);
+    out[7] = flipRows(out[5]);
+}
+
+float NTupleNetwork::evaluate(Engine::Board board) const {
+    Engine::Board boards[SYMMETRY_COUNT];
+    symmetries(board, boards);
+    // Tính hết chỉ số trước rồi mới tra để các lần đọc bộ nhớ chạy song song
+    const float* entries[MAX_TUPLES * SYMMETRY_COUNT];
+    int count = 0;
+    for (int t = 0; t < tupleCount; t++) {
+        const float* table = weights + t * tableSize;
+        for (int s = 0; s < SYMMETRY_COUNT; s++) {
+            entries[count++] = table + tupleIndex(t, boards[s]);
+        }
+    }
+    float value = 0.0f;
+    for (int i = 0; i < count; i++) {
+        value += *entries[i];
+    }
+    return value;
+}
+
+int NTupleNetwork::greedyMove(Engine::Board board, Engine::Board& afterstate, int& reward, float& value) const {
+    int best = -1;
+    float bestTotal = 0.0f;
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        int delta = 0;
+        Engine::Board moved = Engine::move(board, m, delta);
+        if (moved == board) continue;
+        float afterValue = evaluate(moved);
+        float total = delta + afterValue;
+        if (best < 0 || total > bestTotal) {
+            best = m;
+            bestTotal = total;
+            afterstate = moved;
+            reward = delta;
+            value = afterValue;
+        }
+    }
+    return best;
+}
+
+void NTupleNetwork::update(Engine::Board board, float delta) {
+    if (mapping) return;
+    Engine::Board boards[SYMMETRY_COUNT];
+    symmetries(board, boards);
+    for (int t = 0; t < tupleCount; t++) {
+        float* table = weights + t * tableSize;
+        for (int s = 0; s < SYMMETRY_COUNT; s++) {
+            table[tupleIndex(t, boards[s])] += delta;
+        }
+    }
+}
+
+bool NTupleNetwork::init(Preset preset) {
+    unmap();
+    setPreset(preset);
+    owned.assign(weightCount(), 0.0f);
+    weights = owned.data();
+    return true;
+}
+
+bool NTupleNetwork::checkHeader(const FileHeader& header, const std::string& path) const {
+    if (std::memcmp(header.magic, WEIGHTS_MAGIC, sizeof(WEIGHTS_MAGIC)) != 0 || header.version != WEIGHTS_VERSION) {
+        std::cerr << path << " is not an n-tuple weights file" << std::endl;
+        return false;
+    }
+    if (header.preset > PRESET_4X6) {
+        std::cerr << path << ": unknown n-tuple preset " << header.preset << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NTupleNetwork::load(const std::string& path) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    FileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || !checkHeader(header, path)) return false;
+
+    // Kiểm tra và đọc hết trước khi đổi preset: lỗi thì mạng hiện tại giữ nguyên
+    NTupleNetwork probe;
+    probe.setPreset((Preset)header.preset);
+    if (header.weightCount != probe.weightCount()) {
+        std::cerr << path << ": weight count does not match preset" << std::endl;
+        return false;
+    }
+    std::vector<float> loaded(probe.weightCount());
+    file.read(reinterpret_cast<char*>(loaded.data()), loaded.size() * sizeof(float));
+    if (!file) {
+        std::cerr << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    owned.swap(loaded);
+    unmap();
+    setPreset((Preset)header.preset);
+    weights = owned.data();
+    return true;
+}
+
+bool NTupleNetwork::map(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FileHeader)) {
+        close(fd);
+        std::cerr << path << " is too small for n-tuple weights" << std::endl;
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Cannot mmap " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    bool valid = checkHeader(header, path);
+    if (valid) {
+        NTupleNetwork probe;
+        probe.setPreset((Preset)header.preset);
+        valid = header.weightCount == probe.weightCount() &&
+                (size_t)info.st_size == sizeof(FileHeader) + probe.weightCount() * sizeof(float);
+        if (!valid) std::cerr << path << ": size does not match preset" << std::endl;
+    }
+    if (!valid) {
+        munmap(data, (size_t)info.st_size);
+        return false;
+    }
+
+    unmap();
+    owned.clear();
+    setPreset((Preset)header.preset);
+    mapping = data;
+    mappingSize = (size_t)info.st_size;
+    // Bảng trọng số chỉ được đọc; trang chỉ nạp khi được tra tới
+    weights = reinterpret_cast<float*>(static_cast<char*>(data) + sizeof(FileHeader));
+    return true;
+}
+
+bool NTupleNetwork::save(const std::string& path) const {
+    if (!weights) return false;
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Cannot write " << temporary << std::endl;
+        return false;
+    }
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, WEIGHTS_MAGIC, sizeof(WEIGHTS_MAGIC));
+    header.version = WEIGHTS_VERSION;
+    header.preset = (uint32_t)currentPreset;
+    header.weightCount = weightCount();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(weights), weightCount() * sizeof(float));
+    file.close();
+    if (!file) {
+        std::cerr << "Error while writing " << temporary << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Cannot rename " << temporary << " to " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void NTupleNetwork::unmap() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+    weights = owned.empty() ? nullptr : owned.data();
+}
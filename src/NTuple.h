@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Engine.h"
+
+// Hàm đánh giá n-tuple: mỗi tuple là một nhóm ô cố định, số mũ của các ô ghép thành
+// chỉ số vào bảng trọng số riêng của tuple. Mỗi tuple được lấy mẫu trên cả 8 phép
+// đối xứng của bàn cờ (cùng dùng một bảng), giá trị bàn cờ là tổng mọi trọng số tra được.
+// Toàn bộ trọng số nằm liền trong một mảng float; khi đánh giá, bàn cờ được biến đổi
+// đối xứng trước rồi tra lần lượt từng bảng để các lần tra gần nhau trong bộ nhớ.
+class NTupleNetwork {
+public:
+    enum Preset {
+        PRESET_4X4 = 0,  // 4 tuple 4 ô: 1 MB, học nhanh
+        PRESET_4X6 = 1   // 4 tuple 6 ô: 256 MB, mạnh hơn
+    };
+
+    static const int SYMMETRY_COUNT = 8;
+    static const int MAX_TUPLES = 4;
+
+    NTupleNetwork();
+    ~NTupleNetwork();
+
+    // Tạo trọng số 0 (bộ nhớ tự quản, ghi được)
+    bool init(Preset preset);
+    // Đọc file vào bộ nhớ tự quản (để huấn luyện tiếp)
+    bool load(const std::string& path);
+    // Ánh xạ file chỉ đọc bằng mmap; update() không có tác dụng
+    bool map(const std::string& path);
+    // Ghi ra file tạm rồi đổi tên để file cũ không bị hỏng giữa chừng
+    bool save(const std::string& path) const;
+
+    bool isReady() const { return weights != nullptr; }
+    bool isMapped() const { return mapping != nullptr; }
+    Preset preset() const { return currentPreset; }
+    size_t weightCount() const { return (size_t)tupleCount * tableSize; }
+    int featureCount() const { return tupleCount * SYMMETRY_COUNT; }
+
+    float evaluate(Engine::Board board) const;
+    // Chính sách tham lam dùng chung cho huấn luyện và NTupleAdvisor: nước có điểm gộp
+    // + V(afterstate) lớn nhất. Trả về -1 khi hết nước; value là V(afterstate) của nước đó
+    int greedyMove(Engine::Board board, Engine::Board& afterstate, int& reward, float& value) const;
+    // Cộng delta vào mọi trọng số của bàn cờ. Nhiều luồng có thể gọi cùng lúc
+    // không khoá (Hogwild): thỉnh thoảng mất một cập nhật nhưng không ảnh hưởng hội tụ
+    void update(Engine::Board board, float delta);
+
+    static bool parsePreset(const char* text, Preset& preset);
+    static const char* presetName(Preset preset);
+    static void symmetries(Engine::Board board, Engine::Board out[SYMMETRY_COUNT]);
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t preset;
+        uint64_t weightCount;
+        uint64_t reserved;
+    };
+
+    void setPreset(Preset preset);
+    bool checkHeader(const FileHeader& header, const std::string& path) const;
+    size_t tupleIndex(int tuple, Engine::Board board) const {
+        size_t index = 0;
+        for (int i = 0; i < tupleSize; i++) {
+            index |= (size_t)((board >> (4 * cells[tuple * tupleSize + i])) & 0xF) << (4 * i);
+        }
+        return index;
+    }
+    void unmap();
+
+    Preset currentPreset;
+    int tupleCount;
+    int tupleSize;
+    size_t tableSize;
+    const int* cells;
+
+    std::vector<float> owned;
+    float* weights;
+    void* mapping;
+    size_t mappingSize;
+
+    NTupleNetwork(const NTupleNetwork&);
+    NTupleNetwork& operator=(const NTupleNetwork&);
+};
@@ -0,0 +1,10 @@
+#include "NTupleAdvisor.h"
+
+int NTupleAdvisor::chooseMove(Engine::Board board) {
+    Engine::Board afterstate = 0;
+    int reward = 0;
+    float value = 0.0f;
+    int best = network.greedyMove(board, afterstate, reward, value);
+    bestValue = best < 0 ? 0.0 : reward + (double)value;
+    return best;
+}
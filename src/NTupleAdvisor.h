@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Advisor.h"
+#include "NTuple.h"
+
+// Chọn nước đi tham lam một tầng: điểm gộp + giá trị n-tuple của bàn cờ sau nước đi
+class NTupleAdvisor : public Advisor {
+public:
+    explicit NTupleAdvisor(const NTupleNetwork& network) : network(network), bestValue(0.0) {}
+
+    const char* name() const { return "ntuple"; }
+    int chooseMove(Engine::Board board);
+    double lastValue() const { return bestValue; }
+
+private:
+    const NTupleNetwork& network;
+    double bestValue;
+};
@@ -0,0 +1,388 @@
+#include "NetSession.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    // Byte đầu của mỗi tin; nước đi chính là byte 0..3, không có phần thân
+    const uint8_t TAG_MOVE_LAST = 0x03;
+    const uint8_t TAG_HASH = 0x10;    // + u32 hash
+    const uint8_t TAG_PING = 0x20;    // + u32 thời điểm gửi (µs)
+    const uint8_t TAG_PONG = 0x21;    // + u32 thời điểm của ping được trả lời
+    const uint8_t TAG_HELLO = 0x30;   // + u32 phiên bản + u64 seed
+
+    const uint32_t PROTOCOL_VERSION = 0x32303401;  // "2048" + 1
+    const size_t HELLO_SIZE = 13;
+    const int POLL_MS = 20;
+    const int PING_INTERVAL_MS = 500;
+    const int CONNECT_RETRY_MS = 500;
+    const int CONNECT_TIMEOUT_MS = 5000;
+    const int HANDSHAKE_TIMEOUT_MS = 5000;
+    // Vài giây nước đi, ping và hash; đầy nghĩa là đối thủ đã ngừng đọc
+    const size_t OUTBOX_CAPACITY = 64 * 1024;
+
+    uint32_t nowMicros() {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void putU32(uint8_t* out, uint32_t value) {
+        for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+    }
+
+    uint32_t getU32(const uint8_t* in) {
+        return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+    }
+
+    void putU64(uint8_t* out, uint64_t value) {
+        putU32(out, (uint32_t)value);
+        putU32(out + 4, (uint32_t)(value >> 32));
+    }
+
+    uint64_t getU64(const uint8_t* in) {
+        return (uint64_t)getU32(in) | ((uint64_t)getU32(in + 4) << 32);
+    }
+}
+
+NetSession::NetSession() : stopping(false), currentState(STATE_CONNECTING), socketFd(-1), listenFd(-1), hosting(false),
+    matchSeed(0), rttLastUs(-1000), rttMinUs(-1000), sentBytes(0), receivedBytes(0) {
+    // Không tạo được pipe thì poll vẫn hết hạn sau POLL_MS, chỉ chậm hơn
+    if (pipe2(wakeFds, O_NONBLOCK | O_CLOEXEC) != 0) wakeFds[0] = wakeFds[1] = -1;
+    outbox.reserve(OUTBOX_CAPACITY);
+}
+
+NetSession::~NetSession() {
+    stopping = true;
+    int fd = socketFd.load();
+    if (fd >= 0) shutdown(fd, SHUT_RDWR);
+    uint8_t wake = 0;
+    ssize_t written = write(wakeFds[1], &wake, 1);  // đánh thức poll của luồng mạng
+    (void)written;
+    if (worker.joinable()) worker.join();
+    fd = socketFd.exchange(-1);
+    if (fd >= 0) ::close(fd);
+    if (wakeFds[0] >= 0) ::close(wakeFds[0]);
+    if (wakeFds[1] >= 0) ::close(wakeFds[1]);
+}
+
+uint32_t NetSession::boardHash(Engine::Board board, int score) {
+    // Bộ trộn của splitmix64: đổi một ô hay một điểm là đổi cả hash
+    uint64_t z = board ^ ((uint64_t)(uint32_t)score * 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (uint32_t)(z ^ (z >> 32));
+}
+
+std::string NetSession::status() const {
+    std::lock_guard<std::mutex> lock(statusMutex);
+    return statusText;
+}
+
+void NetSession::setStatus(const std::string& text) {
+    std::lock_guard<std::mutex> lock(statusMutex);
+    statusText = text;
+}
+
+bool NetSession::host(int port, uint64_t seed) {
+    hosting = true;
+    matchSeed = seed;
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Cannot create socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t)port);
+    if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, 1) != 0) {
+        std::cerr << "Cannot listen on port " << port << ": " << std::strerror(errno) << std::endl;
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    setStatus("Waiting for opponent on port " + std::to_string(port) + "...");
+    worker = std::thread(&NetSession::hostLoop, this, port);
+    return true;
+}
+
+bool NetSession::connect(const std::string& address) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        std::cerr << "Expected HOST:PORT, got " << address << std::endl;
+        return false;
+    }
+    hosting = false;
+    setStatus("Connecting to " + address + "...");
+    worker = std::thread(&NetSession::connectLoop, this, address.substr(0, colon), address.substr(colon + 1));
+    return true;
+}
+
+void NetSession::hostLoop(int port) {
+    pollfd fds[2] = {{listenFd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}};
+    int fd = -1;
+    while (!stopping && fd < 0) {
+        if (poll(fds, 2, POLL_MS * 5) > 0 && (fds[0].revents & POLLIN)) {
+            fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK);
+        }
+    }
+    ::close(listenFd);
+    listenFd = -1;
+    if (fd < 0) return;
+    socketFd = fd;
+    std::cout << "Opponent connected on port " << port << std::endl;
+    sessionLoop();
+}
+
+void NetSession::connectLoop(std::string hostName, std::string port) {
+    // Host có thể chưa mở cổng (hai bản khởi động cùng lúc): thử lại cho tới khi được
+    while (!stopping) {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* results = nullptr;
+        if (getaddrinfo(hostName.c_str(), port.c_str(), &hints, &results) != 0) {
+            close("Cannot resolve " + hostName);
+            return;
+        }
+        int fd = -1;
+        for (addrinfo* it = results; it && fd < 0 && !stopping; it = it->ai_next) {
+            fd = socket(it->ai_family, it->ai_socktype | SOCK_NONBLOCK, it->ai_protocol);
+            if (fd >= 0 && !connectTo(fd, it->ai_addr, it->ai_addrlen)) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(results);
+        if (fd >= 0) {
+            socketFd = fd;
+            std::cout << "Connected to " << hostName << ":" << port << std::endl;
+            sessionLoop();
+            return;
+        }
+        waitForWake(CONNECT_RETRY_MS);
+    }
+}
+
+bool NetSession::connectTo(int fd, const sockaddr* address, socklen_t length) {
+    // Socket không chặn: connect trả về ngay, poll từng POLL_MS để ~NetSession không phải
+    // chờ hết thời gian kết nối của hệ điều hành
+    if (::connect(fd, address, length) == 0) return true;
+    if (errno != EINPROGRESS) return false;
+    pollfd fds[2] = {{fd, POLLOUT, 0}, {wakeFds[0], POLLIN, 0}};
+    for (int waitedMs = 0; !stopping && waitedMs < CONNECT_TIMEOUT_MS; waitedMs += POLL_MS) {
+        if (poll(fds, 2, POLL_MS) <= 0 || !(fds[0].revents & (POLLOUT | POLLERR | POLLHUP))) continue;
+        int error = 0;
+        socklen_t size = sizeof(error);
+        return getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size) == 0 && error == 0;
+    }
+    return false;
+}
+
+void NetSession::waitForWake(int ms) {
+    pollfd wake = {wakeFds[0], POLLIN, 0};
+    if (poll(&wake, 1, ms) > 0) {
+        uint8_t buffer[64];
+        while (read(wakeFds[0], buffer, sizeof(buffer)) > 0) {}
+    }
+}
+
+void NetSession::sessionLoop() {
+    // Tin rất nhỏ: tắt Nagle để nước đi được gửi ngay thay vì gom gói
+    int noDelay = 1;
+    setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    if (!handshake()) {
+        close("Handshake failed");
+        return;
+    }
+    currentState = STATE_READY;
+    setStatus(hosting ? "Opponent connected" : "Connected to host");
+
+    pollfd fds[2] = {{socketFd.load(), POLLIN, 0}, {wakeFds[0], POLLIN, 0}};
+    std::chrono::steady_clock::time_point nextPing = std::chrono::steady_clock::now();
+    uint8_t buffer[4096];
+    while (!stopping) {
+        if (std::chrono::steady_clock::now() >= nextPing) {
+            uint8_t ping[5] = {TAG_PING};
+            putU32(ping + 1, nowMicros());
+            if (!queueBytes(ping, sizeof(ping))) {
+                close("Opponent stopped reading");
+                return;
+            }
+            nextPing += std::chrono::milliseconds(PING_INTERVAL_MS);
+        }
+        bool pending = false;
+        if (!flushOutbox(pending)) {
+            close("Connection lost");
+            return;
+        }
+        fds[0].events = (short)(POLLIN | (pending ? POLLOUT : 0));
+        int ready = poll(fds, 2, POLL_MS);
+        if (ready <= 0) continue;
+        if (fds[1].revents & POLLIN) {
+            while (read(wakeFds[0], buffer, sizeof(buffer)) > 0) {}
+        }
+        if (!(fds[0].revents & (POLLIN | POLLERR | POLLHUP))) continue;
+        ssize_t count = recv(fds[0].fd, buffer, sizeof(buffer), 0);
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+        if (count <= 0) {
+            if (!stopping) close("Opponent disconnected");
+            return;
+        }
+        receivedBytes += (uint64_t)count;
+        inbox.insert(inbox.end(), buffer, buffer + count);
+        if (!parseInbox()) {
+            close("Protocol error");
+            return;
+        }
+    }
+}
+
+bool NetSession::handshake() {
+    uint8_t hello[HELLO_SIZE] = {TAG_HELLO};
+    putU32(hello + 1, PROTOCOL_VERSION);
+    putU64(hello + 5, hosting ? matchSeed : 0);
+    if (!queueBytes(hello, sizeof(hello))) return false;
+
+    uint8_t reply[HELLO_SIZE];
+    if (!readExact(reply, sizeof(reply))) return false;
+    receivedBytes += sizeof(reply);
+    if (reply[0] != TAG_HELLO || getU32(reply + 1) != PROTOCOL_VERSION) {
+        std::cerr << "Opponent speaks a different protocol" << std::endl;
+        return false;
+    }
+    if (!hosting) matchSeed = getU64(reply + 5);
+    return true;
+}
+
+bool NetSession::readExact(uint8_t* data, size_t size) {
+    // Gửi lời chào trong hàng gửi song song với việc chờ lời chào của đối thủ
+    pollfd connection = {socketFd.load(), POLLIN, 0};
+    int waitedMs = 0;
+    size_t done = 0;
+    while (done < size && !stopping && waitedMs < HANDSHAKE_TIMEOUT_MS) {
+        bool pending = false;
+        if (!flushOutbox(pending)) return false;
+        connection.events = (short)(POLLIN | (pending ? POLLOUT : 0));
+        if (poll(&connection, 1, POLL_MS) <= 0) {
+            waitedMs += POLL_MS;
+            continue;
+        }
+        if (!(connection.revents & (POLLIN | POLLERR | POLLHUP))) continue;
+        ssize_t count = recv(connection.fd, data + done, size - done, 0);
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+        if (count <= 0) return false;
+        done += (size_t)count;
+    }
+    return done == size;
+}
+
+bool NetSession::queueBytes(const uint8_t* data, size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        if (outbox.size() + size > OUTBOX_CAPACITY) return false;
+        outbox.insert(outbox.end(), data, data + size);
+    }
+    // Pipe đầy cũng không sao: luồng mạng đã có việc để thức dậy
+    uint8_t wake = 0;
+    ssize_t written = write(wakeFds[1], &wake, 1);
+    (void)written;
+    return true;
+}
+
+bool NetSession::flushOutbox(bool& pending) {
+    std::lock_guard<std::mutex> lock(sendMutex);
+    int fd = socketFd.load();
+    if (fd < 0) return false;
+    size_t done = 0;
+    while (done < outbox.size()) {
+        ssize_t count = send(fd, outbox.data() + done, outbox.size() - done, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (count <= 0) return false;
+        done += (size_t)count;
+    }
+    outbox.erase(outbox.begin(), outbox.begin() + done);
+    sentBytes += done;
+    pending = !outbox.empty();
+    return true;
+}
+
+bool NetSession::parseInbox() {
+    size_t position = 0;
+    while (position < inbox.size()) {
+        uint8_t tag = inbox[position];
+        size_t remaining = inbox.size() - position;
+        if (tag <= TAG_MOVE_LAST) {
+            Message message = {MESSAGE_MOVE, tag, 0};
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            received.push_back(message);
+            position += 1;
+        } else if (tag == TAG_HASH || tag == TAG_PING || tag == TAG_PONG) {
+            if (remaining < 5) break;
+            uint32_t value = getU32(&inbox[position + 1]);
+            if (tag == TAG_HASH) {
+                Message message = {MESSAGE_HASH, -1, value};
+                std::lock_guard<std::mutex> lock(inboxMutex);
+                received.push_back(message);
+            } else if (tag == TAG_PING) {
+                // Trả lời ngay trên luồng mạng; hàng gửi đầy thì bỏ pong, lần ping kế sẽ đóng phiên
+                uint8_t pong[5] = {TAG_PONG};
+                putU32(pong + 1, value);
+                queueBytes(pong, sizeof(pong));
+            } else {
+                int64_t rtt = (int64_t)(uint32_t)(nowMicros() - value);
+                rttLastUs = rtt;
+                if (rttMinUs.load() < 0 || rtt < rttMinUs.load()) rttMinUs = rtt;
+            }
+            position += 5;
+        } else {
+            return false;
+        }
+    }
+    inbox.erase(inbox.begin(), inbox.begin() + position);
+    return true;
+}
+
+void NetSession::sendMove(int move) {
+    if (state() != STATE_READY || move < 0 || move > TAG_MOVE_LAST) return;
+    uint8_t data = (uint8_t)move;
+    if (!queueBytes(&data, 1)) close("Opponent stopped reading");
+}
+
+void NetSession::sendHash(uint32_t hash) {
+    if (state() != STATE_READY) return;
+    uint8_t data[5] = {TAG_HASH};
+    putU32(data + 1, hash);
+    if (!queueBytes(data, sizeof(data))) close("Opponent stopped reading");
+}
+
+bool NetSession::nextMessage(Message& message) {
+    std::lock_guard<std::mutex> lock(inboxMutex);
+    if (received.empty()) return false;
+    message = received.front();
+    received.pop_front();
+    return true;
+}
+
+void NetSession::close(const std::string& reason) {
+    if (currentState.exchange(STATE_CLOSED) == STATE_CLOSED) return;
+    setStatus(reason);
+    std::cerr << "Network: " << reason << std::endl;
+    int fd = socketFd.load();
+    if (fd >= 0) shutdown(fd, SHUT_RDWR);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include "Engine.h"
+
+// Kết nối TCP giữa hai bản game cho chế độ đấu mạng. Bên host gửi seed trong lời chào,
+// hai bên tự sinh ô mới từ seed đó nên chỉ có nước đi (1 byte) và hash bàn cờ định kỳ
+// (5 byte, phát hiện lệch trạng thái) đi qua mạng, không bao giờ gửi cả bàn cờ.
+// Luồng mạng riêng nhận dữ liệu và trả lời ping ngay lập tức, nên RTT đo được không
+// bị nhịp frame của game cộng thêm. Luồng game chỉ xếp tin vào hàng gửi và lấy tin đã
+// nhận, không bao giờ chờ socket: socket không chặn và chỉ luồng mạng gọi send.
+class NetSession {
+public:
+    enum State {
+        STATE_CONNECTING = 0,   // đang chờ client / đang kết nối tới host
+        STATE_READY = 1,        // đã chào nhau, có seed
+        STATE_CLOSED = 2        // mất kết nối hoặc lỗi giao thức
+    };
+
+    enum MessageType {
+        MESSAGE_MOVE = 0,
+        MESSAGE_HASH = 1
+    };
+
+    struct Message {
+        int type;
+        int move;        // MESSAGE_MOVE: Engine::Move
+        uint32_t hash;   // MESSAGE_HASH: hash bàn cờ của đối thủ sau các nước đã nhận
+    };
+
+    NetSession();
+    ~NetSession();
+
+    // Host lắng nghe trên port và chờ một client; seed được gửi cho client khi kết nối
+    bool host(int port, uint64_t seed);
+    // address dạng host:port
+    bool connect(const std::string& address);
+
+    State state() const { return (State)currentState.load(); }
+    bool isHost() const { return hosting; }
+    uint64_t seed() const { return matchSeed; }
+    std::string status() const;
+
+    void sendMove(int move);
+    void sendHash(uint32_t hash);
+    // Lấy tin tiếp theo của đối thủ theo đúng thứ tự nhận
+    bool nextMessage(Message& message);
+
+    // RTT gần nhất và nhỏ nhất (ms), -1 khi chưa đo được
+    double lastRttMs() const { return rttLastUs.load() / 1000.0; }
+    double minRttMs() const { return rttMinUs.load() / 1000.0; }
+    uint64_t bytesSent() const { return sentBytes.load(); }
+    uint64_t bytesReceived() const { return receivedBytes.load(); }
+
+    // Hash 32 bit của bàn cờ và điểm để hai bên so sánh
+    static uint32_t boardHash(Engine::Board board, int score);
+
+private:
+    void hostLoop(int port);
+    void connectLoop(std::string hostName, std::string port);
+    void sessionLoop();
+    bool handshake();
+    // Xếp vào hàng gửi và đánh thức luồng mạng, false nếu hàng đầy (đối thủ không đọc)
+    bool queueBytes(const uint8_t* data, size_t size);
+    // Luồng mạng: gửi phần hàng gửi socket nhận được ngay; pending = còn dữ liệu chờ gửi
+    bool flushOutbox(bool& pending);
+    // Chờ tối đa ms hoặc tới khi bị đánh thức (có tin cần gửi / đang dừng)
+    void waitForWake(int ms);
+    bool connectTo(int fd, const sockaddr* address, socklen_t length);
+    bool readExact(uint8_t* data, size_t size);
+    // Xử lý mọi tin hoàn chỉnh trong inbox, false nếu gặp tin không hợp lệ
+    bool parseInbox();
+    void setStatus(const std::string& text);
+    void close(const std::string& reason);
+
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::atomic<int> currentState;
+    std::atomic<int> socketFd;
+    int listenFd;
+    bool hosting;
+    uint64_t matchSeed;
+    mutable std::mutex statusMutex;
+    std::string statusText;
+
+    int wakeFds[2];               // pipe đánh thức poll của luồng mạng
+    std::mutex sendMutex;
+    std::vector<uint8_t> outbox;  // cấp phát một lần, luồng game chỉ chép vào
+    std::mutex inboxMutex;
+    std::deque<Message> received;
+    std::vector<uint8_t> inbox;
+
+    std::atomic<int64_t> rttLastUs;
+    std::atomic<int64_t> rttMinUs;
+    std::atomic<uint64_t> sentBytes;
+    std::atomic<uint64_t> receivedBytes;
+
+    NetSession(const NetSession&);
+    NetSession& operator=(const NetSession&);
+};
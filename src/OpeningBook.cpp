@@ -0,0 +1,135 @@
+#include "OpeningBook.h"
+#include "NTuple.h"
+#include "PositionTable.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static_assert(sizeof(OpeningBook::Entry) == 16, "entry phải có kích thước cố định trên đĩa");
+
+namespace {
+    const char BOOK_MAGIC[8] = {'2', '0', '4', '8', 'B', 'O', 'K', '1'};
+    const uint32_t BOOK_VERSION = 1;
+
+    // MOVE_MAP[s][m]: nước m trên bàn cờ gốc tương ứng nước nào sau phép đối xứng s
+    // (lật trái-phải đổi trái/phải, lật trên-dưới đổi lên/xuống, chuyển vị đổi trái/lên)
+    const int MOVE_MAP[NTupleNetwork::SYMMETRY_COUNT][Engine::MOVE_COUNT] = {
+        {0, 1, 2, 3},
+        {1, 0, 2, 3},
+        {0, 1, 3, 2},
+        {1, 0, 3, 2},
+        {2, 3, 0, 1},
+        {2, 3, 1, 0},
+        {3, 2, 0, 1},
+        {3, 2, 1, 0}
+    };
+}
+
+Engine::Board OpeningBook::canonical(Engine::Board board, int& symmetry) {
+    Engine::Board boards[NTupleNetwork::SYMMETRY_COUNT];
+    NTupleNetwork::symmetries(board, boards);
+    symmetry = 0;
+    for (int s = 1; s < NTupleNetwork::SYMMETRY_COUNT; s++) {
+        if (boards[s] < boards[symmetry]) symmetry = s;
+    }
+    return boards[symmetry];
+}
+
+int OpeningBook::toCanonicalMove(int move, int symmetry) {
+    return MOVE_MAP[symmetry][move];
+}
+
+int OpeningBook::fromCanonicalMove(int move, int symmetry) {
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        if (MOVE_MAP[symmetry][m] == move) return m;
+    }
+    return -1;
+}
+
+bool OpeningBook::map(const std::string& path) {
+    slots = nullptr;
+    if (!file.map(path)) return false;
+    const FileHeader* header = static_cast<const FileHeader*>(file.data());
+    bool valid = file.size() >= sizeof(FileHeader) && std::memcmp(header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) == 0 &&
+                 header->version == BOOK_VERSION && header->entrySize == sizeof(Entry) &&
+                 header->slotCount > 0 && (header->slotCount & (header->slotCount - 1)) == 0 &&
+                 file.size() == sizeof(FileHeader) + header->slotCount * sizeof(Entry);
+    if (!valid) {
+        std::cerr << path << " is not an opening book" << std::endl;
+        file.unmap();
+        return false;
+    }
+    slots = reinterpret_cast<const Entry*>(static_cast<const char*>(file.data()) + sizeof(FileHeader));
+    slotMask = header->slotCount - 1;
+    entryCount = header->entryCount;
+    return true;
+}
+
+bool OpeningBook::lookup(Engine::Board board, int& move, float& value) const {
+    if (!slots) return false;
+    int symmetry;
+    Engine::Board key = canonical(board, symmetry);
+    uint64_t i = PositionTable::hash(key) & slotMask;
+    while (slots[i].board != 0) {
+        if (slots[i].board == key) {
+            move = fromCanonicalMove(slots[i].move, symmetry);
+            value = slots[i].value;
+            return true;
+        }
+        i = (i + 1) & slotMask;
+    }
+    return false;
+}
+
+bool OpeningBook::write(const std::string& path, const std::vector<Entry>& entries) {
+    uint64_t slotCount = 16;
+    while (slotCount < entries.size() * 2) slotCount <<= 1;
+    Entry empty;
+    std::memset(&empty, 0, sizeof(empty));
+    std::vector<Entry> table(slotCount, empty);
+    for (size_t e = 0; e < entries.size(); e++) {
+        uint64_t i = PositionTable::hash(entries[e].board) & (slotCount - 1);
+        while (table[i].board != 0 && table[i].board != entries[e].board) {
+            i = (i + 1) & (slotCount - 1);
+        }
+        table[i] = entries[e];
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = BOOK_VERSION;
+    header.entrySize = sizeof(Entry);
+    header.slotCount = slotCount;
+    header.entryCount = entries.size();
+
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Cannot write " << temporary << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(Entry));
+    out.close();
+    if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error while writing " << path << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+int BookAdvisor::chooseMove(Engine::Board board) {
+    int move;
+    float bookValue;
+    if (book.lookup(board, move, bookValue)) {
+        hits++;
+        value = bookValue;
+        return move;
+    }
+    move = fallback->chooseMove(board);
+    value = fallback->lastValue();
+    return move;
+}
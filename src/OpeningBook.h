@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Advisor.h"
+#include "MappedFile.h"
+
+// Opening book: bảng băm địa chỉ mở dựng sẵn trong file, khoá là bàn cờ chuẩn hoá
+// (nhỏ nhất trong 8 phép đối xứng), giá trị là nước đi tốt nhất và kỳ vọng của nó.
+// File được mmap chỉ đọc, tra cứu O(1) trực tiếp trên vùng nhớ, không cần phân tích.
+class OpeningBook {
+public:
+    struct Entry {
+        Engine::Board board;  // 0 = ô trống
+        float value;
+        uint8_t move;         // nước đi trong hệ toạ độ của bàn cờ chuẩn hoá
+        uint8_t reserved[3];
+    };
+
+    OpeningBook() : slots(nullptr), slotMask(0), entryCount(0) {}
+
+    bool map(const std::string& path);
+    bool isReady() const { return slots != nullptr; }
+    size_t size() const { return entryCount; }
+
+    bool lookup(Engine::Board board, int& move, float& value) const;
+
+    // Bàn cờ chuẩn hoá và chỉ số phép đối xứng (theo NTupleNetwork::symmetries) tạo ra nó
+    static Engine::Board canonical(Engine::Board board, int& symmetry);
+    static int toCanonicalMove(int move, int symmetry);
+    static int fromCanonicalMove(int move, int symmetry);
+
+    // Dựng bảng băm (tải <= 50%) từ các entry và ghi ra file
+    static bool write(const std::string& path, const std::vector<Entry>& entries);
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entrySize;
+        uint64_t slotCount;
+        uint64_t entryCount;
+    };
+
+    MappedFile file;
+    const Entry* slots;
+    uint64_t slotMask;
+    uint64_t entryCount;
+};
+
+// Tra opening book trước, ngoài book thì hỏi advisor dự phòng
+class BookAdvisor : public Advisor {
+public:
+    // Nhận quyền sở hữu fallback
+    BookAdvisor(const OpeningBook& book, Advisor* fallback) : book(book), fallback(fallback), value(0.0), hits(0) {}
+    ~BookAdvisor() { delete fallback; }
+
+    const char* name() const { return fallback->name(); }
+    int chooseMove(Engine::Board board);
+    double lastValue() const { return value; }
+    uint64_t bookHits() const { return hits; }
+
+private:
+    const OpeningBook& book;
+    Advisor* fallback;
+    double value;
+    uint64_t hits;
+
+    BookAdvisor(const BookAdvisor&);
+    BookAdvisor& operator=(const BookAdvisor&);
+};
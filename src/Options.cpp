@@ -0,0 +1,218 @@
+#include "Options.h"
+#include "Constants.h"
+#include "RolloutAdvisor.h"
+#include "Strategies.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+GameOptions::GameOptions() : headless(false), hasSeed(false), seed(0), benchFrames(0), allocAssert(false),
+    syntheticInputHz(0), runSeconds(0), soakSeconds(0), soakIntervalSeconds(SOAK_DEFAULT_INTERVAL_SECONDS),
+    advisorMs(ADVISOR_DEFAULT_MS), advisorThreads(0), advisorPolicy("random"), autoplay(false),
+    advisorName("auto"), weightsPath("ntuple.weights"), bookPath("opening.book"),
+    assetPackPath("assets.pack"),
+    hardMode(false), hardSpawnMs(HARD_SPAWN_DEFAULT_MS), vsCpu(false), cpuMoveMs(CPU_DEFAULT_MOVE_MS),
+    cpuPaceMs(CPU_DEFAULT_PACE_MS), replayDir("replays"), historyPath("history.db"),
+    leaderboardSize(MAX_HIGH_SCORES),
+    sessionFast(false), exportThreads(0), exportDelayMs(REPLAY_STEP_MS),
+    netHostPort(0) {}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --headless           render offscreen with the software renderer\n"
+              << "  --seed N             seed the tile RNG\n"
+              << "  --dump-frames DIR    write rendered screens to DIR/<screen>.ppm\n"
+              << "  --golden DIR         compare rendered screens against DIR/<screen>.ppm\n"
+              << "  --bench-frames N     render each screen N times without vsync and report FPS\n"
+              << "  --alloc-assert       abort when an allocation-free section allocates\n"
+              << "  --synthetic-input HZ inject arrow/WASD key presses at a fixed rate\n"
+              << "  --run-seconds N      quit the game loop after N seconds\n"
+              << "  --latency-out FILE   export the input-to-present latency histogram as CSV\n"
+              << "  --soak N             run N seconds of synthetic play and fail on resource growth\n"
+              << "  --soak-interval N    seconds between soak samples\n"
+              << "  --advisor-ms MS      rollout advisor time budget per move (H = hint, P = autoplay)\n"
+              << "  --advisor-threads N  rollout advisor threads (0 = all cores)\n"
+              << "  --advisor-policy P   playout policy: random | greedy\n"
+              << "  --autoplay           start single-player games with autoplay on\n"
+              << "  --advisor NAME       hint/autoplay advisor: auto | rollout | ntuple | greedy | corner |\n"
+              << "                       expectimax:D | expectimax-ntuple:D | rollout:P | rollout-greedy:P\n"
+              << "  --weights FILE       n-tuple weights to memory-map (default ntuple.weights)\n"
+              << "  --book FILE          opening book to memory-map (default opening.book)\n"
+              << "  --assets FILE        asset pack built by 2048-pack (default assets.pack; falls back\n"
+              << "                       to the files under assets/ when missing)\n"
+              << "  --hard               adversarial spawns: every new tile is the worst one for the player\n"
+              << "  --hard-ms MS         max search time per adversarial spawn (default 4); the search\n"
+              << "                       also stops at the time left in the current frame\n"
+              << "  --vs-cpu             two-player mode against the computer (player 2)\n"
+              << "  --cpu-ms MS          hard search deadline per computer move (default 50)\n"
+              << "  --cpu-pace MS        minimum time between computer moves (default 250)\n"
+              << "  --replay-dir DIR     where single-player replays are written (default replays, \"\" = off)\n"
+              << "  --history FILE       append every finished game to FILE for the Statistics screen\n"
+              << "                       (default history.db, \"\" = off)\n"
+              << "  --leaderboard-size N high scores kept in leaderboard.dat and leaderboard-2p.dat (default 10,\n"
+              << "                       0 = off); the single-player screen shows your live rank\n"
+              << "  --replay FILE        open the replay viewer (Space play/pause, Left/Right step,\n"
+              << "                       Up/Down jump 100, Home/End, +/- speed, drag the bar to scrub)\n"
+              << "  --record-session FILE  capture every input event with timestamps and the RNG seed\n"
+              << "  --play-session FILE  feed a captured session back through the game loop\n"
+              << "  --session-speed S    realtime (default) | fast: no frame delay, 16 ms of session time per frame\n"
+              << "  --frame-times FILE   write per-frame times of a played session as CSV\n"
+              << "  --export-replay FILE render every move of a replay offscreen and exit\n"
+              << "  --export-out PATH    animated GIF (PATH ends in .gif) or directory of numbered PPM frames\n"
+              << "  --export-threads N   render threads for --export-replay (0 = all cores)\n"
+              << "  --export-delay MS    time per move in the exported GIF (default 150)\n"
+              << "  --host PORT          host a networked two-player match (you are P1)\n"
+              << "  --connect HOST:PORT  join a networked match (you are P2); arrows or WASD move your board\n"
+              << "  --live-shm NAME      publish boards, scores and move count to POSIX shared memory NAME\n"
+              << "                       for overlays and bots (see src/live2048.h, examples/live_reader.c)\n";
+}
+
+bool parseOptions(int argc, char* argv[], GameOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(arg, "--alloc-assert") == 0) {
+            options.allocAssert = true;
+        } else if (std::strcmp(arg, "--seed") == 0 && hasValue) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            options.hasSeed = true;
+        } else if (std::strcmp(arg, "--dump-frames") == 0 && hasValue) {
+            options.dumpDir = argv[++i];
+        } else if (std::strcmp(arg, "--golden") == 0 && hasValue) {
+            options.goldenDir = argv[++i];
+        } else if (std::strcmp(arg, "--bench-frames") == 0 && hasValue) {
+            options.benchFrames = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--synthetic-input") == 0 && hasValue) {
+            options.syntheticInputHz = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--run-seconds") == 0 && hasValue) {
+            options.runSeconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--latency-out") == 0 && hasValue) {
+            options.latencyOut = argv[++i];
+        } else if (std::strcmp(arg, "--soak") == 0 && hasValue) {
+            options.soakSeconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--soak-interval") == 0 && hasValue) {
+            options.soakIntervalSeconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--advisor-ms") == 0 && hasValue) {
+            options.advisorMs = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--advisor-threads") == 0 && hasValue) {
+            options.advisorThreads = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--advisor-policy") == 0 && hasValue) {
+            RolloutAdvisor::Policy policy;
+            options.advisorPolicy = argv[++i];
+            if (!RolloutAdvisor::parsePolicy(options.advisorPolicy.c_str(), policy)) {
+                std::cerr << "Unknown advisor policy: " << options.advisorPolicy << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--autoplay") == 0) {
+            options.autoplay = true;
+        } else if (std::strcmp(arg, "--advisor") == 0 && hasValue) {
+            options.advisorName = argv[++i];
+            if (options.advisorName != "auto" && !Strategies::isKnown(options.advisorName)) {
+                std::cerr << "Unknown advisor: " << options.advisorName << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--weights") == 0 && hasValue) {
+            options.weightsPath = argv[++i];
+        } else if (std::strcmp(arg, "--book") == 0 && hasValue) {
+            options.bookPath = argv[++i];
+        } else if (std::strcmp(arg, "--assets") == 0 && hasValue) {
+            options.assetPackPath = argv[++i];
+        } else if (std::strcmp(arg, "--hard") == 0) {
+            options.hardMode = true;
+        } else if (std::strcmp(arg, "--hard-ms") == 0 && hasValue) {
+            options.hardSpawnMs = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--vs-cpu") == 0) {
+            options.vsCpu = true;
+        } else if (std::strcmp(arg, "--cpu-ms") == 0 && hasValue) {
+            options.cpuMoveMs = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--cpu-pace") == 0 && hasValue) {
+            options.cpuPaceMs = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--replay-dir") == 0 && hasValue) {
+            options.replayDir = argv[++i];
+        } else if (std::strcmp(arg, "--history") == 0 && hasValue) {
+            options.historyPath = argv[++i];
+        } else if (std::strcmp(arg, "--leaderboard-size") == 0 && hasValue) {
+            options.leaderboardSize = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (std::strcmp(arg, "--record-session") == 0 && hasValue) {
+            options.recordSession = argv[++i];
+        } else if (std::strcmp(arg, "--play-session") == 0 && hasValue) {
+            options.playSession = argv[++i];
+        } else if (std::strcmp(arg, "--session-speed") == 0 && hasValue) {
+            const char* speed = argv[++i];
+            if (std::strcmp(speed, "fast") != 0 && std::strcmp(speed, "realtime") != 0) {
+                std::cerr << "Unknown session speed: " << speed << std::endl;
+                return false;
+            }
+            options.sessionFast = std::strcmp(speed, "fast") == 0;
+        } else if (std::strcmp(arg, "--frame-times") == 0 && hasValue) {
+            options.frameTimesPath = argv[++i];
+        } else if (std::strcmp(arg, "--host") == 0 && hasValue) {
+            options.netHostPort = std::atoi(argv[++i]);
+            if (options.netHostPort <= 0 || options.netHostPort > 65535) {
+                std::cerr << "Invalid port: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--connect") == 0 && hasValue) {
+            options.netConnect = argv[++i];
+        } else if (std::strcmp(arg, "--live-shm") == 0 && hasValue) {
+            options.liveShm = argv[++i];
+        } else if (std::strcmp(arg, "--export-replay") == 0 && hasValue) {
+            options.exportReplay = argv[++i];
+        } else if (std::strcmp(arg, "--export-out") == 0 && hasValue) {
+            options.exportOut = argv[++i];
+        } else if (std::strcmp(arg, "--export-threads") == 0 && hasValue) {
+            options.exportThreads = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--export-delay") == 0 && hasValue) {
+            options.exportDelayMs = std::max(10, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if (!options.playSession.empty() && (options.syntheticInputHz > 0 || options.soakSeconds > 0 ||
+                                          !options.recordSession.empty())) {
+        // Phát phiên thay cho mọi nguồn input khác
+        std::cerr << "--play-session cannot be combined with --synthetic-input, --soak or --record-session" << std::endl;
+        return false;
+    }
+    if ((!options.playSession.empty() || !options.recordSession.empty()) &&
+        (options.autoplay || options.hardMode || options.vsCpu)) {
+        // Advisor, ô mới chế độ khó và máy đối thủ tìm kiếm theo đồng hồ: phát lại không khớp
+        std::cerr << "--record-session/--play-session cannot be combined with --autoplay, --hard or --vs-cpu"
+                  << std::endl;
+        return false;
+    }
+
+    if (options.netEnabled() && (options.netHostPort > 0) == !options.netConnect.empty()) {
+        std::cerr << "Use either --host or --connect, not both" << std::endl;
+        return false;
+    }
+    if (options.netEnabled() && (options.vsCpu || options.hardMode || !options.replayPath.empty() ||
+                                 !options.playSession.empty() || options.headless)) {
+        // Ô mới của chế độ khó phụ thuộc thời gian tìm kiếm nên hai máy không tái tạo giống nhau
+        std::cerr << "--host/--connect cannot be combined with --vs-cpu, --hard, --replay, --play-session or --headless"
+                  << std::endl;
+        return false;
+    }
+
+    if (!options.exportReplay.empty() && options.exportOut.empty()) {
+        std::cerr << "--export-replay needs --export-out" << std::endl;
+        return false;
+    }
+
+    if (options.soakSeconds > 0) {
+        // Soak cần input giả lập và thời gian chạy cố định
+        options.runSeconds = options.soakSeconds;
+        if (options.syntheticInputHz == 0) options.syntheticInputHz = SOAK_DEFAULT_INPUT_HZ;
+        if (options.soakIntervalSeconds <= 0) options.soakIntervalSeconds = SOAK_DEFAULT_INTERVAL_SECONDS;
+    }
+    return true;
+}
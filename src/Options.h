@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+
+// Tuỳ chọn dòng lệnh của game
+struct GameOptions {
+    bool headless;            // --headless: render offscreen, không cần màn hình/GPU
+    bool hasSeed;
+    unsigned int seed;        // --seed N
+    std::string dumpDir;      // --dump-frames DIR: ghi frame ra DIR/<screen>.ppm
+    std::string goldenDir;    // --golden DIR: so sánh từng pixel với DIR/<screen>.ppm
+    int benchFrames;          // --bench-frames N: đo FPS khi render không vsync
+    bool allocAssert;         // --alloc-assert
+    int syntheticInputHz;     // --synthetic-input HZ: tự sinh phím với tần số cố định
+    int runSeconds;           // --run-seconds N: tự thoát sau N giây
+    std::string latencyOut;   // --latency-out FILE: xuất histogram độ trễ (CSV) khi thoát
+    int soakSeconds;          // --soak N: chạy N giây, luân phiên 1/2 người chơi, kiểm tra rò rỉ
+    int soakIntervalSeconds;  // --soak-interval N: chu kỳ lấy mẫu
+    double advisorMs;         // --advisor-ms MS: thời gian suy nghĩ mỗi nước của gợi ý/tự chơi
+    int advisorThreads;       // --advisor-threads N: số luồng chạy playout (0 = số nhân)
+    std::string advisorPolicy;  // --advisor-policy random|greedy: cách chơi trong playout
+    bool autoplay;            // --autoplay: bật tự chơi ngay khi vào ván một người
+    std::string advisorName;  // --advisor auto|rollout|<chiến lược của Strategies> (auto: ntuple nếu có trọng số)
+    std::string weightsPath;  // --weights FILE: trọng số n-tuple, mmap lúc khởi động
+    std::string bookPath;     // --book FILE: opening book, mmap lúc khởi động
+    std::string assetPackPath;  // --assets FILE: gói font/âm thanh, mmap lúc khởi động (không có thì đọc assets/)
+    bool hardMode;            // --hard: ô mới được đặt ở vị trí tệ nhất cho người chơi
+    double hardSpawnMs;       // --hard-ms MS: ngân sách tìm kiếm cho mỗi ô mới ở chế độ khó
+    bool vsCpu;               // --vs-cpu: người chơi 2 do máy điều khiển
+    double cpuMoveMs;         // --cpu-ms MS: deadline tìm kiếm mỗi nước của máy
+    int cpuPaceMs;            // --cpu-pace MS: khoảng cách tối thiểu giữa hai nước của máy
+    std::string replayDir;    // --replay-dir DIR: nơi ghi replay mỗi ván một người ("" = không ghi)
+    std::string historyPath;  // --history FILE: lịch sử mọi ván đã kết thúc ("" = không ghi)
+    int leaderboardSize;      // --leaderboard-size N: số điểm cao giữ lại mỗi bảng (0 = tắt)
+    std::string replayPath;   // --replay FILE: mở trình xem replay thay cho game
+    std::string recordSession;  // --record-session FILE: ghi mọi event SDL kèm thời điểm và seed
+    std::string playSession;  // --play-session FILE: phát lại phiên đã ghi qua vòng lặp game
+    bool sessionFast;         // --session-speed fast: phát nhanh nhất có thể thay cho thời gian thật
+    std::string frameTimesPath;  // --frame-times FILE: thời gian từng frame khi phát phiên (CSV)
+    std::string exportReplay; // --export-replay FILE: render mọi frame của replay offscreen rồi thoát
+    std::string exportOut;    // --export-out PATH: file .gif hoặc thư mục cho chuỗi PPM
+    int exportThreads;        // --export-threads N: số luồng render (0 = số nhân)
+    int exportDelayMs;        // --export-delay MS: thời gian mỗi nước trong GIF
+
+    int netHostPort;          // --host PORT: chờ đối thủ kết nối, gửi seed chung
+    std::string netConnect;   // --connect HOST:PORT: vào trận của máy host
+    std::string liveShm;      // --live-shm NAME: công bố bàn cờ, điểm vào vùng nhớ chia sẻ POSIX
+
+    GameOptions();
+    bool netEnabled() const { return netHostPort > 0 || !netConnect.empty(); }
+};
+
+bool parseOptions(int argc, char* argv[], GameOptions& options);
+void printUsage(const char* program);
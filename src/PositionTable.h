@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Engine.h"
+
+// Bảng băm địa chỉ mở (linear probing) từ bàn cờ nén sang bộ đếm 64 bit.
+// Board 0 (bàn cờ trống) không bao giờ xuất hiện trong ván thật nên dùng làm ô trống.
+class PositionTable {
+public:
+    struct Entry {
+        Engine::Board board;
+        uint64_t value;
+    };
+
+    explicit PositionTable(size_t initialCapacity = 1024) : count(0) {
+        size_t capacity = 16;
+        while (capacity < initialCapacity * 2) capacity <<= 1;
+        entries.assign(capacity, Entry());
+        mask = capacity - 1;
+    }
+
+    static uint64_t hash(Engine::Board board) {
+        uint64_t h = board;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Cộng value vào bộ đếm của board, trả về true nếu board mới được thêm
+    bool add(Engine::Board board, uint64_t value) {
+        if ((count + 1) * 2 > entries.size()) grow();
+        size_t i = hash(board) & mask;
+        while (entries[i].board != 0) {
+            if (entries[i].board == board) {
+                entries[i].value += value;
+                return false;
+            }
+            i = (i + 1) & mask;
+        }
+        entries[i].board = board;
+        entries[i].value = value;
+        count++;
+        return true;
+    }
+
+    const Entry* find(Engine::Board board) const {
+        size_t i = hash(board) & mask;
+        while (entries[i].board != 0) {
+            if (entries[i].board == board) return &entries[i];
+            i = (i + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // Ghi các phần tử (không theo thứ tự) vào out
+    void appendTo(std::vector<Entry>& out) const {
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].board != 0) out.push_back(entries[i]);
+        }
+    }
+
+    void clear() {
+        std::vector<Entry>().swap(entries);
+        entries.assign(16, Entry());
+        mask = 15;
+        count = 0;
+    }
+
+private:
+    std::vector<Entry> entries;
+    size_t mask;
+    size_t count;
+
+    void grow() {
+        std::vector<Entry> old;
+        old.swap(entries);
+        entries.assign(old.size() * 2, Entry());
+        mask = entries.size() - 1;
+        count = 0;
+        for (size_t i = 0; i < old.size(); i++) {
+            if (old[i].board != 0) add(old[i].board, old[i].value);
+        }
+    }
+};
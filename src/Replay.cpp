@@ -0,0 +1,185 @@
+#include "Replay.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    const char REPLAY_MAGIC[8] = {'2', '0', '4', '8', 'R', 'P', 'L', '1'};
+    const uint32_t REPLAY_VERSION = 1;
+    const size_t RESERVE_MOVES = 16384;
+
+    size_t moveBytes(uint32_t moveCount) {
+        // 4 nước mỗi byte, độn tới bội 8 để các mảng phía sau được căn hàng
+        return (((size_t)moveCount + 3) / 4 + 7) & ~(size_t)7;
+    }
+
+    bool overrideBefore(const Replay::Override& entry, uint32_t move) {
+        return entry.move < move;
+    }
+}
+
+namespace Replay {
+    void Writer::begin(uint64_t gameSeed, Engine::Board board, uint64_t rngState, int startingScore, uint32_t interval) {
+        reset();
+        active = true;
+        seed = gameSeed;
+        startBoard = board;
+        startRngState = rngState;
+        startScore = startingScore;
+        keyframeInterval = interval > 0 ? interval : DEFAULT_KEYFRAME_INTERVAL;
+        current = board;
+        rng.state = rngState;
+        score = startingScore;
+        // Cấp phát trước để ghi từng nước không phải cấp phát lại trong ván bình thường
+        moveBits.reserve(RESERVE_MOVES / 4);
+        keyframes.reserve(RESERVE_MOVES / keyframeInterval + 1);
+        Keyframe first = {board, rngState, startingScore, 0};
+        keyframes.push_back(first);
+    }
+
+    void Writer::reset() {
+        active = false;
+        moveCount = 0;
+        moveBits.clear();
+        overrides.clear();
+        keyframes.clear();
+    }
+
+    bool Writer::addMove(int move, Engine::Board board) {
+        if (!active) return false;
+        int delta = 0;
+        Engine::Board afterstate = Engine::move(current, move, delta);
+        Engine::Board spawned = afterstate;
+        if (afterstate != current) spawned = Engine::spawnRandom(afterstate, rng);
+
+        Engine::Board diff = board ^ afterstate;
+        int cell = diff ? __builtin_ctzll(diff) / 4 : 0;
+        if (afterstate == current || (diff >> (4 * cell)) > 0xF || Engine::getCell(afterstate, cell) != 0) {
+            std::cerr << "Replay out of sync at move " << moveCount << ", recording stopped" << std::endl;
+            reset();
+            return false;
+        }
+        if (spawned != board) {
+            Override entry = {moveCount, (uint8_t)cell, (uint8_t)Engine::getCell(board, cell), 0};
+            overrides.push_back(entry);
+        }
+
+        if (moveCount % 4 == 0) moveBits.push_back(0);
+        moveBits.back() |= (uint8_t)(move << (2 * (moveCount % 4)));
+        moveCount++;
+        current = board;
+        score += delta;
+        if (moveCount % keyframeInterval == 0) {
+            Keyframe keyframe = {board, rng.state, score, 0};
+            keyframes.push_back(keyframe);
+        }
+        return true;
+    }
+
+    bool Writer::save(const std::string& path) {
+        if (!active) return false;
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+        header.version = REPLAY_VERSION;
+        header.keyframeInterval = keyframeInterval;
+        header.seed = seed;
+        header.startBoard = startBoard;
+        header.startRngState = startRngState;
+        header.startScore = startScore;
+        header.finalScore = score;
+        header.moveCount = moveCount;
+        header.overrideCount = (uint32_t)overrides.size();
+        header.keyframeCount = (uint32_t)keyframes.size();
+        moveBits.resize(moveBytes(moveCount), 0);
+
+        std::string temporary = path + ".tmp";
+        std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Cannot write " << temporary << std::endl;
+            reset();
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(moveBits.data()), moveBits.size());
+        out.write(reinterpret_cast<const char*>(overrides.data()), overrides.size() * sizeof(Override));
+        out.write(reinterpret_cast<const char*>(keyframes.data()), keyframes.size() * sizeof(Keyframe));
+        out.close();
+        reset();
+        if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::cerr << "Error while writing " << path << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    Reader::Reader() : loaded(false) {
+        std::memset(&header, 0, sizeof(header));
+    }
+
+    bool Reader::load(const std::string& path) {
+        loaded = false;
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot open " << path << std::endl;
+            return false;
+        }
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 || header.version != REPLAY_VERSION ||
+            header.keyframeInterval == 0 || header.keyframeCount != header.moveCount / header.keyframeInterval + 1) {
+            std::cerr << path << " is not a replay" << std::endl;
+            return false;
+        }
+        moveBits.resize(moveBytes(header.moveCount));
+        overrides.resize(header.overrideCount);
+        keyframes.resize(header.keyframeCount);
+        in.read(reinterpret_cast<char*>(moveBits.data()), moveBits.size());
+        in.read(reinterpret_cast<char*>(overrides.data()), overrides.size() * sizeof(Override));
+        in.read(reinterpret_cast<char*>(keyframes.data()), keyframes.size() * sizeof(Keyframe));
+        if (!in) {
+            std::cerr << path << " is truncated" << std::endl;
+            return false;
+        }
+        // stateAt ghi thẳng override vào bàn cờ và tìm nhị phân theo move: ô ngoài bàn cờ,
+        // số mũ 0 hay thứ tự sai sẽ làm hỏng bàn cờ nên cả file bị từ chối
+        for (size_t i = 0; i < overrides.size(); i++) {
+            const Override& entry = overrides[i];
+            if (entry.cell >= 16 || entry.exponent == 0 || entry.exponent > Engine::MAX_EXPONENT ||
+                entry.move >= header.moveCount || (i > 0 && entry.move <= overrides[i - 1].move)) {
+                std::cerr << path << " has an invalid override at entry " << i << std::endl;
+                return false;
+            }
+        }
+        loaded = true;
+        return true;
+    }
+
+    int Reader::moveAt(uint32_t index) const {
+        if (index >= header.moveCount) return -1;
+        return (moveBits[index / 4] >> (2 * (index % 4))) & 3;
+    }
+
+    bool Reader::stateAt(uint32_t index, Engine::Board& board, int& score) const {
+        if (!loaded || index > header.moveCount) return false;
+        const Keyframe& keyframe = keyframes[index / header.keyframeInterval];
+        board = keyframe.board;
+        score = keyframe.score;
+        Engine::Rng rng(keyframe.rngState);
+        uint32_t move = index / header.keyframeInterval * header.keyframeInterval;
+        std::vector<Override>::const_iterator next = std::lower_bound(overrides.begin(), overrides.end(), move, overrideBefore);
+        for (; move < index; move++) {
+            int delta = 0;
+            Engine::Board afterstate = Engine::move(board, moveAt(move), delta);
+            board = Engine::spawnRandom(afterstate, rng);
+            score += delta;
+            if (next != overrides.end() && next->move == move) {
+                board = Engine::setCell(afterstate, next->cell, next->exponent);
+                ++next;
+            }
+        }
+        return true;
+    }
+}
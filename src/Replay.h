@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Engine.h"
+
+// Replay nhỏ gọn của một ván một người. Ô mới được tái tạo từ RNG của Engine
+// (Engine::spawnRandom với trạng thái lưu trong header), nên mỗi nước đi chỉ tốn 2 bit.
+// Ô mới khác với RNG (chế độ khó...) được ghi thành "override" riêng, hiếm khi có.
+// Cứ K nước lại có một keyframe (bàn cờ, trạng thái RNG, điểm) nên nhảy tới nước bất kỳ
+// chỉ cần phát lại tối đa K nước.
+//
+// File: Header | nước đi 2 bit (4 nước mỗi byte, độn tới bội 8) | Override[] | Keyframe[]
+namespace Replay {
+    const uint32_t DEFAULT_KEYFRAME_INTERVAL = 256;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t keyframeInterval;
+        uint64_t seed;            // seed của ván (chỉ để tham khảo)
+        uint64_t startBoard;
+        uint64_t startRngState;   // trạng thái Engine::Rng tại startBoard
+        int32_t startScore;
+        int32_t finalScore;
+        uint32_t moveCount;
+        uint32_t overrideCount;
+        uint32_t keyframeCount;
+        uint32_t reserved;
+    };
+
+    // Ô mới sau nước đi thứ move (RNG vẫn được rút như bình thường)
+    struct Override {
+        uint32_t move;
+        uint8_t cell;
+        uint8_t exponent;
+        uint16_t reserved;
+    };
+
+    // Trạng thái sau index * keyframeInterval nước đi
+    struct Keyframe {
+        uint64_t board;
+        uint64_t rngState;
+        int32_t score;
+        uint32_t reserved;
+    };
+
+    class Writer {
+    public:
+        Writer() : active(false), seed(0), startBoard(0), startRngState(0), startScore(0), keyframeInterval(0),
+                   current(0), score(0), moveCount(0) {}
+
+        // board/rngState: trạng thái trước nước đi đầu tiên được ghi
+        void begin(uint64_t seed, Engine::Board board, uint64_t rngState, int score,
+                   uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+        bool isActive() const { return active; }
+        uint32_t moves() const { return moveCount; }
+        int currentScore() const { return score; }
+
+        // board: bàn cờ sau nước đi move và ô mới. Trả về false (và dừng ghi) nếu
+        // board không khớp luật Engine từ trạng thái trước
+        bool addMove(int move, Engine::Board board);
+        // Ghi file (tạm rồi đổi tên) và kết thúc replay
+        bool save(const std::string& path);
+        void reset();
+
+    private:
+        bool active;
+        uint64_t seed;
+        Engine::Board startBoard;
+        uint64_t startRngState;
+        int startScore;
+        uint32_t keyframeInterval;
+        Engine::Board current;
+        Engine::Rng rng;
+        int score;
+        uint32_t moveCount;
+        std::vector<uint8_t> moveBits;
+        std::vector<Override> overrides;
+        std::vector<Keyframe> keyframes;
+    };
+
+    class Reader {
+    public:
+        Reader();
+
+        bool load(const std::string& path);
+        bool isLoaded() const { return loaded; }
+        uint32_t moveCount() const { return header.moveCount; }
+        uint32_t overrideCount() const { return header.overrideCount; }
+        uint32_t keyframeInterval() const { return header.keyframeInterval; }
+        uint64_t seed() const { return header.seed; }
+        int finalScore() const { return header.finalScore; }
+
+        int moveAt(uint32_t index) const;
+        // Trạng thái sau index nước đi (0 = bàn cờ bắt đầu); phát lại tối đa K nước từ keyframe
+        bool stateAt(uint32_t index, Engine::Board& board, int& score) const;
+
+    private:
+        bool loaded;
+        Header header;
+        std::vector<uint8_t> moveBits;
+        std::vector<Override> overrides;
+        std::vector<Keyframe> keyframes;
+    };
+}
@@ -0,0 +1,233 @@
+#include "ReplayExport.h"
+#include "Constants.h"
+#include "FrameCapture.h"
+#include "Game2048.h"
+#include "GifEncoder.h"
+#include "Replay.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct ExportJob {
+        uint32_t frameCount;
+        bool gif;
+        std::string outDir;
+        const GifEncoder::Palette* palette;
+        int delayCs;
+        int finalDelayCs;
+
+        std::atomic<uint32_t> nextChunk;
+        std::atomic<bool> failed;
+
+        // Frame GIF đã mã hoá, luồng chính lấy ra theo thứ tự rồi giải phóng
+        std::mutex mutex;
+        std::condition_variable readyChanged;
+        std::vector<std::string> encoded;
+        std::vector<char> ready;
+
+        ExportJob() : frameCount(0), gif(false), palette(nullptr), delayCs(0), finalDelayCs(0),
+                      nextChunk(0), failed(false) {}
+    };
+
+    bool endsWith(const std::string& text, const char* suffix) {
+        size_t length = std::char_traits<char>::length(suffix);
+        return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+    }
+
+    void fail(ExportJob& job) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.failed = true;
+        job.readyChanged.notify_all();
+    }
+
+    void renderChunks(Game2048* game, ExportJob& job) {
+        FrameCapture::Frame frame;
+        size_t pixels = (size_t)WINDOW_WIDTH * WINDOW_HEIGHT;
+        std::vector<uint8_t> previous(pixels);
+        std::vector<uint8_t> current(pixels);
+        std::string data;
+
+        while (!job.failed) {
+            uint32_t begin = job.nextChunk.fetch_add(1) * EXPORT_CHUNK_FRAMES;
+            if (begin >= job.frameCount) break;
+            uint32_t end = std::min(job.frameCount, begin + EXPORT_CHUNK_FRAMES);
+
+            // Frame ngay trước dải làm gốc so sánh (frame đầu tiên mã hoá toàn ảnh)
+            if (job.gif && begin > 0) {
+                if (!game->renderReplayFrame(begin - 1, frame)) {
+                    fail(job);
+                    return;
+                }
+                job.palette->map(frame.rgb.data(), pixels, previous.data());
+            }
+
+            for (uint32_t index = begin; index < end; index++) {
+                if (!game->renderReplayFrame(index, frame)) {
+                    fail(job);
+                    return;
+                }
+                if (!job.gif) {
+                    char name[32];
+                    std::snprintf(name, sizeof(name), "/frame_%06u.ppm", index);
+                    if (!FrameCapture::writePPM(job.outDir + name, frame)) {
+                        fail(job);
+                        return;
+                    }
+                    continue;
+                }
+
+                job.palette->map(frame.rgb.data(), pixels, current.data());
+                int x = 0, y = 0, w = WINDOW_WIDTH, h = WINDOW_HEIGHT;
+                if (index > 0 && !GifEncoder::diffRect(previous.data(), current.data(), WINDOW_WIDTH, WINDOW_HEIGHT,
+                                                       x, y, w, h)) {
+                    // Không đổi gì: vẫn giữ một pixel để frame có thời gian hiển thị riêng
+                    x = y = 0;
+                    w = h = 1;
+                }
+                data.clear();
+                int delay = index + 1 == job.frameCount ? job.finalDelayCs : job.delayCs;
+                GifEncoder::encodeFrame(current.data(), WINDOW_WIDTH, x, y, w, h, delay, job.palette->bits(), data);
+                previous.swap(current);
+
+                std::lock_guard<std::mutex> lock(job.mutex);
+                job.encoded[index].swap(data);
+                job.ready[index] = 1;
+                job.readyChanged.notify_all();
+            }
+        }
+    }
+
+    // Bảng màu từ vài frame rải đều cả ván (luôn có frame đầu và cuối, nơi có ô lớn nhất)
+    bool buildPalette(Game2048* game, const Replay::Reader& reader, GifEncoder::Palette& palette) {
+        uint32_t frameCount = reader.moveCount() + 1;
+        int samples = (int)std::min<uint32_t>(frameCount, EXPORT_PALETTE_SAMPLES);
+        std::vector<FrameCapture::Frame> frames(samples);
+        std::vector<const unsigned char*> images;
+        for (int i = 0; i < samples; i++) {
+            uint32_t index = samples == 1 ? 0 : (uint32_t)((uint64_t)(frameCount - 1) * i / (samples - 1));
+            if (!game->renderReplayFrame(index, frames[i])) return false;
+            images.push_back(frames[i].rgb.data());
+        }
+        palette.build(images, (size_t)WINDOW_WIDTH * WINDOW_HEIGHT);
+        return true;
+    }
+
+    bool exportFrames(const GameOptions& options, const Replay::Reader& reader, std::vector<Game2048*>& games) {
+        ExportJob job;
+        job.frameCount = reader.moveCount() + 1;
+        job.gif = endsWith(options.exportOut, ".gif");
+        job.delayCs = std::max(2, (options.exportDelayMs + 5) / 10);
+        job.finalDelayCs = std::max(job.delayCs, EXPORT_FINAL_HOLD_MS / 10);
+
+        GifEncoder::Palette palette;
+        GifEncoder::Writer writer;
+        if (job.gif) {
+            if (!buildPalette(games[0], reader, palette)) return false;
+            if (!writer.open(options.exportOut, WINDOW_WIDTH, WINDOW_HEIGHT, palette)) return false;
+            job.palette = &palette;
+            job.encoded.resize(job.frameCount);
+            job.ready.assign(job.frameCount, 0);
+            std::cout << "GIF palette: " << palette.size() << " colors" << std::endl;
+        } else {
+            job.outDir = options.exportOut;
+            mkdir(job.outDir.c_str(), 0755);  // thư mục đã có thì bỏ qua lỗi
+        }
+
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < games.size(); t++) {
+            workers.push_back(std::thread(renderChunks, games[t], std::ref(job)));
+        }
+
+        bool ok = true;
+        if (job.gif) {
+            std::string data;
+            for (uint32_t index = 0; index < job.frameCount && ok; index++) {
+                {
+                    std::unique_lock<std::mutex> lock(job.mutex);
+                    while (!job.ready[index] && !job.failed) job.readyChanged.wait(lock);
+                    if (job.failed) {
+                        ok = false;
+                        break;
+                    }
+                    data.swap(job.encoded[index]);
+                    std::string().swap(job.encoded[index]);
+                }
+                ok = writer.write(data);
+            }
+            if (!ok) fail(job);
+        }
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+        ok = ok && !job.failed;
+
+        if (job.gif) {
+            ok = writer.close() && ok;
+            if (ok) std::cout << "GIF size: " << writer.size() / 1024 << " KB" << std::endl;
+        }
+        return ok;
+    }
+}
+
+namespace ReplayExport {
+    bool run(const GameOptions& options) {
+        Replay::Reader reader;
+        if (!reader.load(options.exportReplay)) {
+            return false;
+        }
+
+        // Chỉ cần renderer phần mềm và font, không mở cửa sổ hay âm thanh
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        if (TTF_Init() == -1) {
+            std::cerr << "SDL_ttf could not initialize! TTF_Error: " << TTF_GetError() << std::endl;
+            SDL_Quit();
+            return false;
+        }
+
+        uint32_t frameCount = reader.moveCount() + 1;
+        int threadCount = options.exportThreads > 0 ? options.exportThreads : (int)std::thread::hardware_concurrency();
+        uint32_t chunkCount = (frameCount + EXPORT_CHUNK_FRAMES - 1) / EXPORT_CHUNK_FRAMES;
+        threadCount = std::max(1, std::min(threadCount, (int)chunkCount));
+
+        // Font được mở tuần tự ở đây; sau đó mỗi luồng chỉ đụng tới Game2048 của nó
+        bool ok = true;
+        std::vector<Game2048*> games;
+        for (int t = 0; t < threadCount && ok; t++) {
+            games.push_back(new Game2048());
+            ok = games.back()->initOffscreen(options, reader);
+        }
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        if (ok) {
+            std::cout << "Exporting " << frameCount << " frames of " << options.exportReplay << " to "
+                      << options.exportOut << " with " << threadCount << " threads..." << std::endl;
+            ok = exportFrames(options, reader, games);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        for (size_t t = 0; t < games.size(); t++) {
+            delete games[t];
+        }
+        TTF_Quit();
+        SDL_Quit();
+
+        if (ok) {
+            std::cout << "Exported " << frameCount << " frames in " << seconds << " s ("
+                      << (seconds > 0 ? frameCount / seconds : 0.0) << " frames/s)" << std::endl;
+        }
+        return ok;
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Options.h"
+
+// Xuất replay thành ảnh động GIF hoặc chuỗi PPM đánh số, không cần cửa sổ.
+// Mỗi luồng có Game2048 offscreen riêng (renderer phần mềm, font, cache texture ô)
+// và render một dải frame liên tiếp bằng chính trình xem replay của game.
+// GIF: luồng render cũng tự lượng tử hoá và mã hoá LZW frame của mình,
+// luồng chính chỉ ghi các frame đã mã hoá theo thứ tự.
+namespace ReplayExport {
+    bool run(const GameOptions& options);
+}
@@ -0,0 +1,51 @@
+#include "Resources.h"
+#include <atomic>
+
+namespace {
+    std::atomic<int> textureCount(0);
+    std::atomic<int> surfaceCount(0);
+}
+
+namespace Resources {
+    SDL_Surface* renderText(TTF_Font* font, const char* text, SDL_Color color) {
+        SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
+        if (surface) surfaceCount++;
+        return surface;
+    }
+
+    void freeSurface(SDL_Surface* surface) {
+        if (surface) {
+            SDL_FreeSurface(surface);
+            surfaceCount--;
+        }
+    }
+
+    SDL_Texture* createTexture(SDL_Renderer* renderer, SDL_Surface* surface) {
+        if (!surface) return nullptr;
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (texture) textureCount++;
+        return texture;
+    }
+
+    void destroyTexture(SDL_Texture* texture) {
+        if (texture) {
+            SDL_DestroyTexture(texture);
+            textureCount--;
+        }
+    }
+
+    TTF_Font* openFont(const AssetPack& pack, const char* path, int size) {
+        size_t bytes = 0;
+        const void* data = pack.find(path, bytes);
+        if (!data) return TTF_OpenFont(path, size);
+        return TTF_OpenFontRW(SDL_RWFromConstMem(data, (int)bytes), 1, size);
+    }
+
+    int liveTextures() {
+        return textureCount.load();
+    }
+
+    int liveSurfaces() {
+        return surfaceCount.load();
+    }
+}
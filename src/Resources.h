@@ -0,0 +1,20 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "AssetPack.h"
+
+// Bọc các hàm tạo/huỷ texture và surface để đếm số đối tượng SDL còn sống
+// (dùng cho soak test phát hiện rò rỉ)
+namespace Resources {
+    SDL_Surface* renderText(TTF_Font* font, const char* text, SDL_Color color);
+    void freeSurface(SDL_Surface* surface);
+    SDL_Texture* createTexture(SDL_Renderer* renderer, SDL_Surface* surface);
+    void destroyTexture(SDL_Texture* texture);
+
+    // Mở font thẳng từ vùng mmap của pack (không sao chép), pack không có thì đọc file path
+    TTF_Font* openFont(const AssetPack& pack, const char* path, int size);
+
+    int liveTextures();
+    int liveSurfaces();
+}
@@ -0,0 +1,147 @@
+#include "RolloutAdvisor.h"
+#include <chrono>
+#include <cstring>
+
+RolloutAdvisor::RolloutAdvisor(const Config& advisorConfig)
+    : config(advisorConfig), pool(advisorConfig.threads), callCount(0), callSeed(0), playouts(0), bestMean(0.0) {
+    stats.resize(pool.size());
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) means[m] = 0.0;
+}
+
+const char* RolloutAdvisor::name() const {
+    return config.policy == POLICY_GREEDY ? "rollout-greedy" : "rollout";
+}
+
+bool RolloutAdvisor::parsePolicy(const char* text, Policy& policy) {
+    if (std::strcmp(text, "random") == 0) {
+        policy = POLICY_RANDOM;
+    } else if (std::strcmp(text, "greedy") == 0) {
+        policy = POLICY_GREEDY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int RolloutAdvisor::playout(Engine::Board board, Engine::Rng& rng) const {
+    int score = 0;
+    while (true) {
+        Engine::Board best = board;
+        int bestDelta = -1;
+        if (config.policy == POLICY_GREEDY) {
+            // Nước gộp được nhiều điểm nhất, hoà thì ưu tiên hướng bắt đầu ngẫu nhiên
+            int first = rng.below(Engine::MOVE_COUNT);
+            for (int i = 0; i < Engine::MOVE_COUNT; i++) {
+                int delta = 0;
+                Engine::Board moved = Engine::move(board, (first + i) & 3, delta);
+                if (moved != board && delta > bestDelta) {
+                    best = moved;
+                    bestDelta = delta;
+                }
+            }
+        } else {
+            // Thử các hướng theo thứ tự ngẫu nhiên tới khi có hướng hợp lệ
+            int first = rng.below(Engine::MOVE_COUNT);
+            for (int i = 0; i < Engine::MOVE_COUNT; i++) {
+                int delta = 0;
+                Engine::Board moved = Engine::move(board, (first + i) & 3, delta);
+                if (moved != board) {
+                    best = moved;
+                    bestDelta = delta;
+                    break;
+                }
+            }
+        }
+        if (bestDelta < 0) return score;
+        score += bestDelta;
+        board = Engine::spawnRandom(best, rng);
+    }
+}
+
+void RolloutAdvisor::work(int worker, Engine::Board board, const int* legalMoves, int legalCount,
+                          std::chrono::steady_clock::time_point deadline) {
+    WorkerStats& local = stats[worker];
+    Engine::Board children[Engine::MOVE_COUNT];
+    int deltas[Engine::MOVE_COUNT];
+    for (int i = 0; i < legalCount; i++) {
+        deltas[i] = 0;
+        children[i] = Engine::move(board, legalMoves[i], deltas[i]);
+    }
+
+    if (config.playoutsPerMove > 0) {
+        // Playout thứ p dùng RNG riêng theo p nên kết quả không phụ thuộc số luồng
+        for (int p = worker; p < config.playoutsPerMove; p += pool.size()) {
+            Engine::Rng rng(callSeed + (uint64_t)p * 0x9E3779B97F4A7C15ULL);
+            for (int i = 0; i < legalCount; i++) {
+                Engine::Board start = Engine::spawnRandom(children[i], rng);
+                local.scoreSum[i] += deltas[i] + playout(start, rng);
+                local.count[i]++;
+            }
+        }
+        return;
+    }
+    // Xem đồng hồ trước mỗi playout (đọc đồng hồ ~20 ns, một playout vài µs tới hàng trăm µs
+    // ở cuối ván) nên chỉ vượt ngân sách tối đa một playout. Vòng đầu luôn chạy đủ để mọi
+    // hướng có ít nhất một mẫu
+    for (bool first = true;; first = false) {
+        for (int i = 0; i < legalCount; i++) {
+            if (!first && std::chrono::steady_clock::now() >= deadline) return;
+            Engine::Board start = Engine::spawnRandom(children[i], local.rng);
+            local.scoreSum[i] += deltas[i] + playout(start, local.rng);
+            local.count[i]++;
+        }
+    }
+}
+
+int RolloutAdvisor::chooseMove(Engine::Board board) {
+    int legalMoves[Engine::MOVE_COUNT];
+    int legalCount = 0;
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        means[m] = 0.0;
+        if (Engine::move(board, m) != board) legalMoves[legalCount++] = m;
+    }
+    playouts = 0;
+    bestMean = 0.0;
+    if (legalCount == 0) return -1;
+    if (legalCount == 1) return legalMoves[0];
+
+    // Hạn chót tính từ lúc gọi, trước khi đánh thức các luồng, để thời gian chờ pool cũng
+    // nằm trong ngân sách
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+        std::chrono::microseconds((long long)(config.budgetMs * 1000.0));
+
+    // Dòng RNG của mỗi luồng phụ thuộc seed, số thứ tự lần gọi và chỉ số luồng
+    callCount++;
+    Engine::Rng seeder(config.seed ^ (callCount * 0xD1B54A32D192ED03ULL));
+    callSeed = seeder.next();
+    for (size_t w = 0; w < stats.size(); w++) {
+        stats[w].rng = Engine::Rng(seeder.next());
+        for (int i = 0; i < Engine::MOVE_COUNT; i++) {
+            stats[w].scoreSum[i] = 0.0;
+            stats[w].count[i] = 0;
+        }
+    }
+
+    pool.run([this, board, &legalMoves, legalCount, deadline](int worker) {
+        work(worker, board, legalMoves, legalCount, deadline);
+    });
+
+    int best = legalMoves[0];
+    bestMean = -1.0;
+    for (int i = 0; i < legalCount; i++) {
+        double sum = 0.0;
+        uint64_t count = 0;
+        for (size_t w = 0; w < stats.size(); w++) {
+            sum += stats[w].scoreSum[i];
+            count += stats[w].count[i];
+        }
+        playouts += count;
+        double mean = count > 0 ? sum / count : 0.0;
+        means[legalMoves[i]] = mean;
+        if (mean > bestMean) {
+            bestMean = mean;
+            best = legalMoves[i];
+        }
+    }
+    return best;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "Advisor.h"
+#include "ThreadPool.h"
+
+// Chọn nước đi bằng Monte Carlo: với mỗi hướng hợp lệ, chơi nhiều ván ngẫu nhiên
+// (random hoặc greedy) tới khi hết nước và lấy hướng có điểm cuối trung bình cao nhất.
+// Playout chia đều cho các luồng của ThreadPool, mỗi luồng một dòng RNG riêng.
+class RolloutAdvisor : public Advisor {
+public:
+    enum Policy {
+        POLICY_RANDOM = 0,
+        POLICY_GREEDY = 1
+    };
+
+    struct Config {
+        int threads;          // <= 0: số nhân của máy
+        double budgetMs;      // thời gian cho mỗi nước đi
+        int playoutsPerMove;  // > 0: số playout cố định mỗi hướng (bỏ qua budgetMs, tất định với mọi số luồng)
+        Policy policy;
+        uint64_t seed;
+
+        Config() : threads(0), budgetMs(20.0), playoutsPerMove(0), policy(POLICY_RANDOM), seed(2048) {}
+    };
+
+    explicit RolloutAdvisor(const Config& config = Config());
+
+    const char* name() const;
+    int chooseMove(Engine::Board board);
+    double lastValue() const { return bestMean; }
+
+    // Thống kê của lần chooseMove gần nhất
+    uint64_t lastPlayouts() const { return playouts; }
+    double lastMean(int move) const { return means[move]; }
+    int threadCount() const { return pool.size(); }
+
+    static bool parsePolicy(const char* text, Policy& policy);
+
+private:
+    // Mỗi luồng cộng dồn riêng; phần đệm tách dữ liệu các luồng ra khác cache line
+    struct WorkerStats {
+        double scoreSum[Engine::MOVE_COUNT];
+        uint64_t count[Engine::MOVE_COUNT];
+        Engine::Rng rng;
+        char padding[64];
+    };
+
+    int playout(Engine::Board board, Engine::Rng& rng) const;
+    void work(int worker, Engine::Board board, const int* legalMoves, int legalCount,
+              std::chrono::steady_clock::time_point deadline);
+
+    Config config;
+    ThreadPool pool;
+    std::vector<WorkerStats> stats;
+    uint64_t callCount;
+    uint64_t callSeed;
+    uint64_t playouts;
+    double means[Engine::MOVE_COUNT];
+    double bestMean;
+};
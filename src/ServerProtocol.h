@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Engine.h"
+
+// Giao thức nhị phân của 2048-server (little-endian, không có độ dài khung vì mọi tin
+// có kích thước cố định theo byte đầu):
+//   client -> server: 0..3          nước đi (Engine::Move), 1 byte
+//                     'N' + u64     ván mới với seed (0 = server tự chọn), 9 byte
+//   server -> client: status + u64 bàn cờ nén + u32 điểm, luôn 13 byte cho mỗi yêu cầu
+// Mỗi kết nối là một ván; client được gửi nhiều yêu cầu liên tiếp không cần chờ (pipeline).
+namespace ServerProtocol {
+    const uint8_t REQUEST_MOVE_LAST = 0x03;
+    const uint8_t REQUEST_NEW_GAME = 'N';
+    const size_t NEW_GAME_SIZE = 9;
+    const size_t RESPONSE_SIZE = 13;
+    const int DEFAULT_PORT = 7049;
+
+    enum Status {
+        STATUS_MOVED = 0,      // nước đi hợp lệ, đã sinh ô mới
+        STATUS_ILLEGAL = 1,    // nước đi không làm bàn cờ thay đổi
+        STATUS_GAME_OVER = 2,  // ván đã hết nước (sau nước này hoặc từ trước)
+        STATUS_NEW_GAME = 3,   // trả lời 'N'
+        STATUS_NO_GAME = 4     // nước đi khi chưa có ván
+    };
+
+    inline void putResponse(uint8_t* out, int status, Engine::Board board, uint32_t score) {
+        out[0] = (uint8_t)status;
+        for (int i = 0; i < 8; i++) out[1 + i] = (uint8_t)(board >> (8 * i));
+        for (int i = 0; i < 4; i++) out[9 + i] = (uint8_t)(score >> (8 * i));
+    }
+
+    inline void getResponse(const uint8_t* in, int& status, Engine::Board& board, uint32_t& score) {
+        status = in[0];
+        board = 0;
+        for (int i = 0; i < 8; i++) board |= (Engine::Board)in[1 + i] << (8 * i);
+        score = 0;
+        for (int i = 0; i < 4; i++) score |= (uint32_t)in[9 + i] << (8 * i);
+    }
+
+    inline void putNewGame(uint8_t* out, uint64_t seed) {
+        out[0] = REQUEST_NEW_GAME;
+        for (int i = 0; i < 8; i++) out[1 + i] = (uint8_t)(seed >> (8 * i));
+    }
+
+    inline uint64_t getSeed(const uint8_t* in) {
+        uint64_t seed = 0;
+        for (int i = 0; i < 8; i++) seed |= (uint64_t)in[1 + i] << (8 * i);
+        return seed;
+    }
+}
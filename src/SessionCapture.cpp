@@ -0,0 +1,150 @@
+#include "SessionCapture.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const char SESSION_MAGIC[8] = {'2', '0', '4', '8', 'S', 'E', 'S', '1'};
+    const uint32_t SESSION_VERSION = 1;
+}
+
+namespace SessionCapture {
+    bool Recorder::open(const std::string& filePath, uint32_t sessionSeed) {
+        path = filePath;
+        seed = sessionSeed;
+        eventCount = 0;
+        std::string temporary = path + ".tmp";
+        out.open(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Cannot write " << temporary << std::endl;
+            return false;
+        }
+        // Header tạm, ghi lại khi đóng
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return true;
+    }
+
+    void Recorder::record(const SDL_Event& event, uint32_t timeMs) {
+        if (!out.is_open()) return;
+        Event entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.time = timeMs;
+        switch (event.type) {
+            case SDL_QUIT:
+                entry.type = EVENT_QUIT;
+                break;
+            case SDL_KEYDOWN:
+            case SDL_KEYUP:
+                entry.type = event.type == SDL_KEYDOWN ? EVENT_KEY_DOWN : EVENT_KEY_UP;
+                entry.detail = event.key.repeat;
+                entry.a = event.key.keysym.sym;
+                entry.b = event.key.keysym.scancode;
+                entry.c = event.key.keysym.mod;
+                break;
+            case SDL_MOUSEMOTION:
+                entry.type = EVENT_MOUSE_MOTION;
+                entry.a = event.motion.x;
+                entry.b = event.motion.y;
+                entry.c = (int32_t)event.motion.state;
+                break;
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+                entry.type = event.type == SDL_MOUSEBUTTONDOWN ? EVENT_BUTTON_DOWN : EVENT_BUTTON_UP;
+                entry.detail = event.button.button;
+                entry.extra = event.button.clicks;
+                entry.a = event.button.x;
+                entry.b = event.button.y;
+                break;
+            default:
+                return;
+        }
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        eventCount++;
+    }
+
+    bool Recorder::close(uint32_t durationMs) {
+        if (!out.is_open()) return false;
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, SESSION_MAGIC, sizeof(SESSION_MAGIC));
+        header.version = SESSION_VERSION;
+        header.seed = seed;
+        header.eventCount = eventCount;
+        header.durationMs = durationMs;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        std::string temporary = path + ".tmp";
+        if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::cerr << "Error while writing " << path << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+        std::cout << "Recorded " << eventCount << " events (" << durationMs << " ms) to " << path << std::endl;
+        return true;
+    }
+
+    bool Player::load(const std::string& path) {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot open " << path << std::endl;
+            return false;
+        }
+        Header header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, SESSION_MAGIC, sizeof(SESSION_MAGIC)) != 0 || header.version != SESSION_VERSION) {
+            std::cerr << path << " is not a session capture" << std::endl;
+            return false;
+        }
+        events.resize(header.eventCount);
+        in.read(reinterpret_cast<char*>(events.data()), events.size() * sizeof(Event));
+        if (!in) {
+            std::cerr << path << " is truncated" << std::endl;
+            events.clear();
+            return false;
+        }
+        next = 0;
+        durationMs = header.durationMs;
+        seedValue = header.seed;
+        return true;
+    }
+
+    bool Player::poll(uint32_t nowMs, Uint32 ticks, SDL_Event& event) {
+        if (next >= events.size() || events[next].time > nowMs) return false;
+        const Event& entry = events[next++];
+        SDL_memset(&event, 0, sizeof(event));
+        switch (entry.type) {
+            case EVENT_QUIT:
+                event.type = SDL_QUIT;
+                break;
+            case EVENT_KEY_DOWN:
+            case EVENT_KEY_UP:
+                event.type = entry.type == EVENT_KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+                event.key.state = entry.type == EVENT_KEY_DOWN ? SDL_PRESSED : SDL_RELEASED;
+                event.key.repeat = entry.detail;
+                event.key.keysym.sym = entry.a;
+                event.key.keysym.scancode = (SDL_Scancode)entry.b;
+                event.key.keysym.mod = (Uint16)entry.c;
+                break;
+            case EVENT_MOUSE_MOTION:
+                event.type = SDL_MOUSEMOTION;
+                event.motion.x = entry.a;
+                event.motion.y = entry.b;
+                event.motion.state = (Uint32)entry.c;
+                break;
+            default:
+                event.type = entry.type == EVENT_BUTTON_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+                event.button.state = entry.type == EVENT_BUTTON_DOWN ? SDL_PRESSED : SDL_RELEASED;
+                event.button.button = entry.detail;
+                event.button.clicks = entry.extra;
+                event.button.x = entry.a;
+                event.button.y = entry.b;
+                break;
+        }
+        // Timestamp theo đồng hồ hiện tại để đo độ trễ input vẫn đúng khi phát lại
+        event.common.timestamp = ticks;
+        return true;
+    }
+}
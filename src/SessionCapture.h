@@ -0,0 +1,83 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Ghi lại luồng event SDL thô mà Game2048::run tiêu thụ (phím, chuột, thoát) kèm thời
+// điểm và seed RNG, rồi phát lại qua đúng vòng lặp đó: theo thời gian thật hoặc nhanh
+// nhất có thể (mỗi frame tiến 16 ms ảo, không SDL_Delay). Dùng để tái hiện chính xác một
+// phiên chơi dưới profiler và so sánh thời gian frame giữa các bản build.
+//
+// File: Header | Event[eventCount], header được ghi lại khi đóng.
+namespace SessionCapture {
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t seed;
+        uint32_t eventCount;
+        uint32_t durationMs;
+        uint32_t reserved[2];
+    };
+
+    enum EventType {
+        EVENT_QUIT = 0,
+        EVENT_KEY_DOWN = 1,
+        EVENT_KEY_UP = 2,
+        EVENT_MOUSE_MOTION = 3,
+        EVENT_BUTTON_DOWN = 4,
+        EVENT_BUTTON_UP = 5
+    };
+
+    // Phím: a = sym, b = scancode, c = mod, detail = repeat.
+    // Chuột: a = x, b = y, c = trạng thái nút (motion), detail = nút, extra = số lần click
+    struct Event {
+        uint32_t time;
+        uint16_t type;
+        uint8_t detail;
+        uint8_t extra;
+        int32_t a;
+        int32_t b;
+        int32_t c;
+    };
+
+    class Recorder {
+    public:
+        Recorder() : eventCount(0) {}
+
+        bool open(const std::string& path, uint32_t seed);
+        bool isOpen() const { return out.is_open(); }
+        // Bỏ qua event mà game không dùng (cửa sổ, text input...)
+        void record(const SDL_Event& event, uint32_t timeMs);
+        bool close(uint32_t durationMs);
+
+    private:
+        std::ofstream out;
+        std::string path;
+        uint32_t seed;
+        uint32_t eventCount;
+    };
+
+    class Player {
+    public:
+        Player() : next(0), durationMs(0), seedValue(0) {}
+
+        bool load(const std::string& path);
+        bool isLoaded() const { return durationMs > 0 || !events.empty(); }
+        uint32_t seed() const { return seedValue; }
+        uint32_t duration() const { return durationMs; }
+        size_t eventCount() const { return events.size(); }
+
+        // Event kế tiếp có thời điểm <= nowMs (timestamp đổi thành ticks hiện tại)
+        bool poll(uint32_t nowMs, Uint32 ticks, SDL_Event& event);
+        bool finished(uint32_t nowMs) const { return next >= events.size() && nowMs >= durationMs; }
+
+    private:
+        std::vector<Event> events;
+        size_t next;
+        uint32_t durationMs;
+        uint32_t seedValue;
+    };
+}
@@ -0,0 +1,27 @@
+#include "SimpleAdvisors.h"
+
+const int CornerAdvisor::PRIORITY[Engine::MOVE_COUNT] = {
+    Engine::MOVE_DOWN, Engine::MOVE_LEFT, Engine::MOVE_RIGHT, Engine::MOVE_UP
+};
+
+int GreedyAdvisor::chooseMove(Engine::Board board) {
+    int best = -1;
+    bestDelta = 0;
+    for (int i = 0; i < Engine::MOVE_COUNT; i++) {
+        int move = CornerAdvisor::PRIORITY[i];
+        int delta = 0;
+        if (Engine::move(board, move, delta) == board) continue;
+        if (best < 0 || delta > bestDelta) {
+            best = move;
+            bestDelta = delta;
+        }
+    }
+    return best;
+}
+
+int CornerAdvisor::chooseMove(Engine::Board board) {
+    for (int i = 0; i < Engine::MOVE_COUNT; i++) {
+        if (Engine::move(board, PRIORITY[i]) != board) return PRIORITY[i];
+    }
+    return -1;
+}
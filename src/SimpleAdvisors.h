@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Advisor.h"
+
+// Tham lam: nước gộp được nhiều điểm nhất, hoà thì theo thứ tự ưu tiên của CornerAdvisor
+class GreedyAdvisor : public Advisor {
+public:
+    GreedyAdvisor() : bestDelta(0) {}
+    const char* name() const { return "greedy"; }
+    int chooseMove(Engine::Board board);
+    double lastValue() const { return bestDelta; }
+
+private:
+    int bestDelta;
+};
+
+// Giữ ô lớn ở góc dưới trái: thử xuống, trái, phải rồi mới lên
+class CornerAdvisor : public Advisor {
+public:
+    const char* name() const { return "corner"; }
+    int chooseMove(Engine::Board board);
+
+    static const int PRIORITY[Engine::MOVE_COUNT];
+};
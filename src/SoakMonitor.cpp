@@ -0,0 +1,109 @@
+#include "SoakMonitor.h"
+#include "Constants.h"
+#include "Resources.h"
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+
+SoakMonitor::SoakMonitor() : intervalMs(0), nextSampleTicks(0), startTicks(0), frameMsSum(0.0), frameCount(0),
+    rssGrowth(false), textureGrowth(false), surfaceGrowth(false), frameTimeDrift(false) {}
+
+void SoakMonitor::start(Uint32 now, int intervalSeconds, int durationSeconds) {
+    intervalMs = (Uint32)intervalSeconds * 1000;
+    startTicks = now;
+    nextSampleTicks = now + intervalMs;
+    samples.clear();
+    // Mỗi chu kỳ tối đa một mẫu: vector không phải nới (chép lại) giữa phiên dù soak dài bao nhiêu
+    samples.reserve((size_t)(durationSeconds / intervalSeconds) + 2);
+    frameMsSum = 0.0;
+    frameCount = 0;
+}
+
+long SoakMonitor::currentRssKb() {
+#ifdef __linux__
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) return -1;
+    long pages = 0;
+    long residentPages = 0;
+    int read = std::fscanf(file, "%ld %ld", &pages, &residentPages);
+    std::fclose(file);
+    if (read != 2) return -1;
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return -1;
+#endif
+}
+
+void SoakMonitor::onFrame(Uint32 now, double frameMs) {
+    frameMsSum += frameMs;
+    frameCount++;
+    if (now >= nextSampleTicks) {
+        takeSample(now);
+        nextSampleTicks = now + intervalMs;
+    }
+}
+
+void SoakMonitor::takeSample(Uint32 now) {
+    Sample sample;
+    sample.ticks = now - startTicks;
+    sample.rssKb = currentRssKb();
+    sample.textures = Resources::liveTextures();
+    sample.surfaces = Resources::liveSurfaces();
+    sample.frameMs = frameCount ? frameMsSum / frameCount : 0.0;
+    samples.push_back(sample);
+    frameMsSum = 0.0;
+    frameCount = 0;
+
+    std::cout << "[soak] t=" << sample.ticks / 1000 << "s rss=" << sample.rssKb << "KB textures=" << sample.textures
+              << " surfaces=" << sample.surfaces << " frame=" << sample.frameMs << "ms" << std::endl;
+    checkGrowth();
+}
+
+void SoakMonitor::checkGrowth() {
+    // Bỏ qua các mẫu khởi động (cache font, texture tên người chơi...)
+    if ((int)samples.size() < SOAK_WARMUP_SAMPLES + SOAK_GROWTH_WINDOW) return;
+
+    size_t first = samples.size() - SOAK_GROWTH_WINDOW;
+    bool rssUp = samples[first].rssKb >= 0;
+    bool texturesUp = true;
+    bool surfacesUp = true;
+    bool frameUp = true;
+    for (size_t i = first + 1; i < samples.size(); i++) {
+        rssUp = rssUp && samples[i].rssKb > samples[i - 1].rssKb;
+        texturesUp = texturesUp && samples[i].textures > samples[i - 1].textures;
+        surfacesUp = surfacesUp && samples[i].surfaces > samples[i - 1].surfaces;
+        frameUp = frameUp && samples[i].frameMs > samples[i - 1].frameMs;
+    }
+
+    const Sample& oldest = samples[first];
+    const Sample& newest = samples.back();
+    if (rssUp && newest.rssKb - oldest.rssKb >= SOAK_RSS_GROWTH_KB) rssGrowth = true;
+    if (texturesUp) textureGrowth = true;
+    if (surfacesUp) surfaceGrowth = true;
+    if (frameUp && newest.frameMs > oldest.frameMs * (1.0 + SOAK_FRAME_DRIFT_RATIO)) frameTimeDrift = true;
+}
+
+bool SoakMonitor::leakDetected() const {
+    return rssGrowth || textureGrowth || surfaceGrowth || frameTimeDrift;
+}
+
+const std::vector<SoakMonitor::Sample>& SoakMonitor::getSamples() const {
+    return samples;
+}
+
+void SoakMonitor::printReport(std::ostream& out) const {
+    out << "Soak report: " << samples.size() << " samples" << std::endl;
+    if (!samples.empty()) {
+        const Sample& firstSample = samples.front();
+        const Sample& lastSample = samples.back();
+        out << "  rss: " << firstSample.rssKb << "KB -> " << lastSample.rssKb << "KB" << std::endl;
+        out << "  textures: " << firstSample.textures << " -> " << lastSample.textures << std::endl;
+        out << "  surfaces: " << firstSample.surfaces << " -> " << lastSample.surfaces << std::endl;
+        out << "  frame time: " << firstSample.frameMs << "ms -> " << lastSample.frameMs << "ms" << std::endl;
+    }
+    if (rssGrowth) out << "  FAIL: RSS grows monotonically" << std::endl;
+    if (textureGrowth) out << "  FAIL: live SDL textures grow monotonically" << std::endl;
+    if (surfaceGrowth) out << "  FAIL: live SDL surfaces grow monotonically" << std::endl;
+    if (frameTimeDrift) out << "  FAIL: frame time drifts upwards" << std::endl;
+    if (!leakDetected()) out << "  PASS" << std::endl;
+}
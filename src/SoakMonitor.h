@@ -0,0 +1,45 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <ostream>
+#include <vector>
+
+// Lấy mẫu RSS, số texture/surface SDL còn sống và thời gian frame theo chu kỳ,
+// báo lỗi khi một chỉ số tăng đơn điệu qua nhiều mẫu liên tiếp
+class SoakMonitor {
+public:
+    struct Sample {
+        Uint32 ticks;
+        long rssKb;
+        int textures;
+        int surfaces;
+        double frameMs;
+    };
+
+    SoakMonitor();
+
+    // durationSeconds: độ dài cả phiên soak, để cấp phát chỗ cho mọi mẫu một lần từ đầu
+    void start(Uint32 now, int intervalSeconds, int durationSeconds);
+    void onFrame(Uint32 now, double frameMs);
+    bool leakDetected() const;
+    const std::vector<Sample>& getSamples() const;
+    void printReport(std::ostream& out) const;
+
+    // RSS hiện tại (KB), -1 nếu hệ điều hành không hỗ trợ
+    static long currentRssKb();
+
+private:
+    std::vector<Sample> samples;
+    Uint32 intervalMs;
+    Uint32 nextSampleTicks;
+    Uint32 startTicks;
+    double frameMsSum;
+    int frameCount;
+    bool rssGrowth;
+    bool textureGrowth;
+    bool surfaceGrowth;
+    bool frameTimeDrift;
+
+    void takeSample(Uint32 now);
+    void checkGrowth();
+};
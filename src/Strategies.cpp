@@ -0,0 +1,68 @@
+#include "Strategies.h"
+#include "Expectimax.h"
+#include "NTupleAdvisor.h"
+#include "RolloutAdvisor.h"
+#include "SimpleAdvisors.h"
+#include <cstdlib>
+
+namespace {
+    const int DEFAULT_DEPTH = 2;
+    const int DEFAULT_PLAYOUTS = 100;
+    const int MAX_DEPTH = 8;
+
+    // Tách "name:arg"; arg = fallback nếu không có
+    bool split(const std::string& spec, std::string& name, int& argument, int fallback) {
+        size_t colon = spec.find(':');
+        name = spec.substr(0, colon);
+        argument = fallback;
+        if (colon == std::string::npos) return true;
+        std::string text = spec.substr(colon + 1);
+        char* end = nullptr;
+        long value = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || value <= 0) return false;
+        argument = (int)value;
+        return true;
+    }
+}
+
+namespace Strategies {
+    bool isKnown(const std::string& spec) {
+        std::string name;
+        int argument;
+        if (!split(spec, name, argument, 1)) return false;
+        if (name == "greedy" || name == "corner" || name == "ntuple") return spec.find(':') == std::string::npos;
+        if (name == "expectimax" || name == "expectimax-ntuple") return argument <= MAX_DEPTH;
+        return name == "rollout" || name == "rollout-greedy";
+    }
+
+    bool needsNetwork(const std::string& spec) {
+        return spec == "ntuple" || spec.compare(0, 17, "expectimax-ntuple") == 0;
+    }
+
+    Advisor* create(const std::string& spec, const NTupleNetwork* network, uint64_t seed, std::string& error) {
+        if (!isKnown(spec)) {
+            error = "unknown strategy '" + spec + "'";
+            return nullptr;
+        }
+        if (needsNetwork(spec) && (!network || !network->isReady())) {
+            error = "strategy '" + spec + "' needs n-tuple weights (--weights FILE)";
+            return nullptr;
+        }
+
+        std::string name;
+        int argument;
+        split(spec, name, argument, 0);
+        if (name == "greedy") return new GreedyAdvisor();
+        if (name == "corner") return new CornerAdvisor();
+        if (name == "ntuple") return new NTupleAdvisor(*network);
+        if (name == "expectimax") return new ExpectimaxAdvisor(argument > 0 ? argument : DEFAULT_DEPTH);
+        if (name == "expectimax-ntuple") return new ExpectimaxAdvisor(argument > 0 ? argument : DEFAULT_DEPTH, network);
+
+        RolloutAdvisor::Config config;
+        config.threads = 1;
+        config.playoutsPerMove = argument > 0 ? argument : DEFAULT_PLAYOUTS;
+        config.policy = name == "rollout-greedy" ? RolloutAdvisor::POLICY_GREEDY : RolloutAdvisor::POLICY_RANDOM;
+        config.seed = seed;
+        return new RolloutAdvisor(config);
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include "Advisor.h"
+#include "NTuple.h"
+
+// Tạo Advisor từ chuỗi mô tả, dùng chung cho 2048-tournament và --advisor của game:
+//   greedy | corner | ntuple | expectimax:D | expectimax-ntuple:D | rollout:P | rollout-greedy:P
+// D là độ sâu tìm kiếm, P là số playout cố định mỗi hướng (một luồng, kết quả tất định).
+namespace Strategies {
+    bool isKnown(const std::string& spec);
+    bool needsNetwork(const std::string& spec);
+    // Trả về nullptr và ghi lý do vào error nếu spec sai hoặc thiếu trọng số n-tuple
+    Advisor* create(const std::string& spec, const NTupleNetwork* network, uint64_t seed, std::string& error);
+}
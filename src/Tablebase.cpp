@@ -0,0 +1,366 @@
+#include "Tablebase.h"
+#include "PositionTable.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    const char TABLEBASE_MAGIC[8] = {'2', '0', '4', '8', 'T', 'B', 'L', '1'};
+    const uint32_t TABLEBASE_VERSION = 1;
+    const int SYMMETRY_COUNT = 8;
+    // Mỗi tầng chờ chia thành nhiều bảng theo bit cao của hash để các luồng chèn song song
+    const int SHARD_BITS = 6;
+    const size_t SHARD_COUNT = (size_t)1 << SHARD_BITS;
+
+    size_t shardOf(Engine::Board board) {
+        // Bit thấp của hash chọn ô trong PositionTable, bit cao chọn bảng
+        return (size_t)(PositionTable::hash(board) >> (64 - SHARD_BITS));
+    }
+
+    // Chỉ số ô thứ k trên đường thứ line theo hướng move (ô đầu tiên là ô sát tường)
+    int lineCell(int move, int line, int k, int size) {
+        switch (move) {
+            case Engine::MOVE_LEFT: return line * size + k;
+            case Engine::MOVE_RIGHT: return line * size + (size - 1 - k);
+            case Engine::MOVE_UP: return k * size + line;
+            default: return (size - 1 - k) * size + line;
+        }
+    }
+
+    // Ô (r, c) sau phép đối xứng s trong nhóm 8 phép của hình vuông
+    int symmetricCell(int s, int r, int c, int size) {
+        int rr = size - 1 - r;
+        int cc = size - 1 - c;
+        switch (s) {
+            case 0: return r * size + c;
+            case 1: return r * size + cc;
+            case 2: return rr * size + c;
+            case 3: return rr * size + cc;
+            case 4: return c * size + r;
+            case 5: return c * size + rr;
+            case 6: return cc * size + r;
+            default: return cc * size + rr;
+        }
+    }
+
+    // Một tầng: bàn cờ đã sắp xếp (để tìm nhị phân) và giá trị song song
+    struct Layer {
+        std::vector<Engine::Board> boards;
+        std::vector<float> values;
+    };
+
+    float layerValue(const Layer& layer, Engine::Board board) {
+        std::vector<Engine::Board>::const_iterator it = std::lower_bound(layer.boards.begin(), layer.boards.end(), board);
+        return layer.values[it - layer.boards.begin()];
+    }
+}
+
+Engine::Board Tablebase::move(Engine::Board board, int direction, int size, int capExponent, int& scoreDelta) {
+    Engine::Board result = board;
+    for (int line = 0; line < size; line++) {
+        int cells[4];
+        int count = 0;
+        for (int k = 0; k < size; k++) {
+            int value = Engine::getCell(board, lineCell(direction, line, k, size));
+            if (value != 0) cells[count++] = value;
+        }
+        int merged[4] = {0, 0, 0, 0};
+        int out = 0;
+        for (int i = 0; i < count; i++) {
+            if (i + 1 < count && cells[i] == cells[i + 1] && cells[i] < capExponent) {
+                merged[out++] = cells[i] + 1;
+                scoreDelta += 1 << (cells[i] + 1);
+                i++;
+            } else {
+                merged[out++] = cells[i];
+            }
+        }
+        for (int k = 0; k < size; k++) {
+            result = Engine::setCell(result, lineCell(direction, line, k, size), merged[k]);
+        }
+    }
+    return result;
+}
+
+Engine::Board Tablebase::canonical(Engine::Board board, int size) {
+    Engine::Board best = 0;
+    for (int s = 0; s < SYMMETRY_COUNT; s++) {
+        Engine::Board transformed = 0;
+        for (int r = 0; r < size; r++) {
+            for (int c = 0; c < size; c++) {
+                transformed = Engine::setCell(transformed, symmetricCell(s, r, c, size), Engine::getCell(board, r * size + c));
+            }
+        }
+        if (s == 0 || transformed < best) best = transformed;
+    }
+    return best;
+}
+
+bool Tablebase::solve(int size, int capExponent, int threads, const std::string& path, std::ostream& progress) {
+    if (size < 2 || size > 4 || capExponent < 2 || capExponent > Engine::MAX_EXPONENT) {
+        std::cerr << "Unsupported tablebase size " << size << " / cap " << capExponent << std::endl;
+        return false;
+    }
+    int cellCount = size * size;
+    uint64_t emptyMask = 0;
+    for (int i = 0; i < cellCount; i++) emptyMask |= (uint64_t)1 << (4 * i);
+
+    // Tầng theo tổng giá trị / 2
+    size_t layerCount = (size_t)cellCount * ((size_t)1 << (capExponent - 1)) + 3;
+    std::vector<Layer> layers(layerCount);
+    ThreadPool pool(threads);
+
+    // Tầng S chỉ sinh ra S + 1 và S + 2, nên chỉ ba tầng chờ tồn tại cùng lúc: vòng 3 bảng,
+    // bảng của tầng S được giải phóng ngay sau khi đọc và dùng lại cho tầng S + 3.
+    // Tầng 0 và 1 luôn rỗng, vòng lặp bắt đầu từ tầng 2 để bảng khởi đầu không bị đọc nhầm
+    const size_t PENDING_RING = 3;
+    const size_t FIRST_LAYER = 2;
+    std::vector<std::vector<PositionTable> > pending(PENDING_RING, std::vector<PositionTable>(SHARD_COUNT));
+    // Bàn cờ khởi đầu: hai ô 2/4 ở hai vị trí khác nhau (tầng 2, 3 hoặc 4)
+    for (int a = 0; a < cellCount; a++) {
+        for (int b = a + 1; b < cellCount; b++) {
+            for (int ea = 1; ea <= 2; ea++) {
+                for (int eb = 1; eb <= 2; eb++) {
+                    Engine::Board start = canonical(Engine::setCell(Engine::setCell(0, a, ea), b, eb), size);
+                    pending[((ea == 1 ? 1 : 2) + (eb == 1 ? 1 : 2)) % PENDING_RING][shardOf(start)].add(start, 1);
+                }
+            }
+        }
+    }
+
+    // Chiều tiến: sinh tầng S + 1 và S + 2 (đơn vị 2) từ tầng S
+    uint64_t total = 0;
+    size_t highest = 0;
+    for (size_t s = FIRST_LAYER; s < layerCount; s++) {
+        std::vector<PositionTable>& current = pending[s % PENDING_RING];
+        std::vector<PositionTable::Entry> entries;
+        for (size_t k = 0; k < SHARD_COUNT; k++) {
+            current[k].appendTo(entries);
+            current[k].clear();
+        }
+        if (entries.empty()) continue;
+        Layer& layer = layers[s];
+        for (size_t i = 0; i < entries.size(); i++) layer.boards.push_back(entries[i].board);
+        std::vector<PositionTable::Entry>().swap(entries);
+        std::sort(layer.boards.begin(), layer.boards.end());
+        layer.values.assign(layer.boards.size(), 0.0f);
+        total += layer.boards.size();
+        highest = s;
+
+        // Con của mỗi luồng được chia sẵn theo bảng đích: children[worker][shard]
+        std::vector<std::vector<std::vector<Engine::Board> > > children2(
+            pool.size(), std::vector<std::vector<Engine::Board> >(SHARD_COUNT));
+        std::vector<std::vector<std::vector<Engine::Board> > > children4(
+            pool.size(), std::vector<std::vector<Engine::Board> >(SHARD_COUNT));
+        std::atomic<size_t> next(0);
+        pool.run([&](int worker) {
+            size_t i;
+            while ((i = next.fetch_add(1)) < layer.boards.size()) {
+                Engine::Board board = layer.boards[i];
+                for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+                    int delta = 0;
+                    Engine::Board moved = move(board, m, size, capExponent, delta);
+                    if (moved == board) continue;
+                    uint64_t empties = Engine::zeroNibbles(moved) & emptyMask;
+                    while (empties) {
+                        uint64_t cell = empties & (~empties + 1);
+                        empties &= empties - 1;
+                        Engine::Board two = canonical(moved | cell, size);
+                        Engine::Board four = canonical(moved | (cell * 2), size);
+                        children2[worker][shardOf(two)].push_back(two);
+                        children4[worker][shardOf(four)].push_back(four);
+                    }
+                }
+            }
+        });
+        // Mỗi bảng chỉ do một luồng chèn nên không cần khoá
+        std::vector<PositionTable>& plus2 = pending[(s + 1) % PENDING_RING];
+        std::vector<PositionTable>& plus4 = pending[(s + 2) % PENDING_RING];
+        std::atomic<size_t> nextShard(0);
+        pool.run([&](int) {
+            size_t k;
+            while ((k = nextShard.fetch_add(1)) < SHARD_COUNT) {
+                for (int w = 0; w < pool.size(); w++) {
+                    const std::vector<Engine::Board>& two = children2[w][k];
+                    const std::vector<Engine::Board>& four = children4[w][k];
+                    for (size_t i = 0; i < two.size(); i++) plus2[k].add(two[i], 1);
+                    for (size_t i = 0; i < four.size(); i++) plus4[k].add(four[i], 1);
+                }
+            }
+        });
+        if (s % 64 == 0) progress << "forward: sum " << 2 * s << ", " << total << " positions" << std::endl;
+    }
+    progress << "forward done: " << total << " positions, highest tile sum " << 2 * highest << std::endl;
+
+    // Chiều ngược: tầng S chỉ cần giá trị tầng S + 1, S + 2 đã giải
+    for (size_t s = highest + 1; s-- > 0;) {
+        Layer& layer = layers[s];
+        if (layer.boards.empty()) continue;
+        const Layer& plus2 = layers[s + 1 < layerCount ? s + 1 : s];
+        const Layer& plus4 = layers[s + 2 < layerCount ? s + 2 : s];
+        std::atomic<size_t> next(0);
+        pool.run([&](int) {
+            size_t i;
+            while ((i = next.fetch_add(1)) < layer.boards.size()) {
+                Engine::Board board = layer.boards[i];
+                float best = 0.0f;
+                for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+                    int delta = 0;
+                    Engine::Board moved = move(board, m, size, capExponent, delta);
+                    if (moved == board) continue;
+                    uint64_t empties = Engine::zeroNibbles(moved) & emptyMask;
+                    int emptyCount = __builtin_popcountll(empties);
+                    double expectation = 0.0;
+                    while (empties) {
+                        uint64_t cell = empties & (~empties + 1);
+                        empties &= empties - 1;
+                        expectation += 0.9 * layerValue(plus2, canonical(moved | cell, size));
+                        expectation += 0.1 * layerValue(plus4, canonical(moved | (cell * 2), size));
+                    }
+                    float candidate = (float)(delta + expectation / emptyCount);
+                    if (candidate > best) best = candidate;
+                }
+                layer.values[i] = best;
+            }
+        });
+        if (s % 64 == 0) progress << "backward: sum " << 2 * s << std::endl;
+    }
+
+    // Kỳ vọng từ đầu ván theo đúng thứ tự hai lần addNewTile
+    double startExpectation = 0.0;
+    for (int a = 0; a < cellCount; a++) {
+        for (int b = 0; b < cellCount; b++) {
+            if (a == b) continue;
+            for (int ea = 1; ea <= 2; ea++) {
+                for (int eb = 1; eb <= 2; eb++) {
+                    double probability = (1.0 / cellCount) * (1.0 / (cellCount - 1)) * (ea == 1 ? 0.9 : 0.1) * (eb == 1 ? 0.9 : 0.1);
+                    Engine::Board start = canonical(Engine::setCell(Engine::setCell(0, a, ea), b, eb), size);
+                    startExpectation += probability * layerValue(layers[(ea == 1 ? 1 : 2) + (eb == 1 ? 1 : 2)], start);
+                }
+            }
+        }
+    }
+    progress << "expected score from the start: " << startExpectation << std::endl;
+
+    // Bảng băm địa chỉ mở: khoá và giá trị ở hai mảng riêng (12 byte mỗi ô)
+    uint64_t slotCount = 16;
+    while (slotCount < total * 2) slotCount <<= 1;
+    std::vector<uint64_t> keys(slotCount, 0);
+    std::vector<float> values(slotCount, 0.0f);
+    for (size_t s = 0; s <= highest; s++) {
+        for (size_t i = 0; i < layers[s].boards.size(); i++) {
+            uint64_t slot = PositionTable::hash(layers[s].boards[i]) & (slotCount - 1);
+            while (keys[slot] != 0) slot = (slot + 1) & (slotCount - 1);
+            keys[slot] = layers[s].boards[i];
+            values[slot] = layers[s].values[i];
+        }
+        Layer().boards.swap(layers[s].boards);
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+    header.version = TABLEBASE_VERSION;
+    header.boardSize = (uint32_t)size;
+    header.capExponent = (uint32_t)capExponent;
+    header.slotCount = slotCount;
+    header.entryCount = total;
+    header.startValue = startExpectation;
+
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Cannot write " << temporary << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    out.close();
+    if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error while writing " << path << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Tablebase::map(const std::string& path) {
+    keys = nullptr;
+    if (!file.map(path)) return false;
+    const FileHeader* header = static_cast<const FileHeader*>(file.data());
+    const size_t slotBytes = sizeof(uint64_t) + sizeof(float);
+    bool valid = file.size() >= sizeof(FileHeader) &&
+                 std::memcmp(header->magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC)) == 0 &&
+                 header->version == TABLEBASE_VERSION && header->slotCount > 0 &&
+                 (header->slotCount & (header->slotCount - 1)) == 0 &&
+                 header->slotCount <= (file.size() - sizeof(FileHeader)) / slotBytes &&
+                 file.size() == sizeof(FileHeader) + header->slotCount * slotBytes;
+    // move() và bestMove() dựa vào boardSize/capExponent; solve() luôn để trống ít nhất
+    // nửa số ô nên find() dừng được
+    valid = valid && header->boardSize >= 2 && header->boardSize <= 4 && header->capExponent >= 2 &&
+            header->capExponent <= (uint32_t)Engine::MAX_EXPONENT && header->entryCount > 0 &&
+            header->entryCount <= header->slotCount / 2;
+    if (!valid) {
+        std::cerr << path << " is not a tablebase" << std::endl;
+        file.unmap();
+        return false;
+    }
+    const char* base = static_cast<const char*>(file.data()) + sizeof(FileHeader);
+    keys = reinterpret_cast<const uint64_t*>(base);
+    values = reinterpret_cast<const float*>(base + header->slotCount * sizeof(uint64_t));
+    slotMask = header->slotCount - 1;
+    boardSize = (int)header->boardSize;
+    cap = (int)header->capExponent;
+    entryCount = header->entryCount;
+    startValue = header->startValue;
+    return true;
+}
+
+bool Tablebase::find(Engine::Board canonicalBoard, float& result) const {
+    uint64_t slot = PositionTable::hash(canonicalBoard) & slotMask;
+    // Dừng sau một vòng bảng kể cả khi file hỏng không còn ô trống
+    for (uint64_t probe = 0; probe <= slotMask && keys[slot] != 0; probe++) {
+        if (keys[slot] == canonicalBoard) {
+            result = values[slot];
+            return true;
+        }
+        slot = (slot + 1) & slotMask;
+    }
+    return false;
+}
+
+bool Tablebase::value(Engine::Board board, float& result) const {
+    return keys && find(canonical(board, boardSize), result);
+}
+
+int Tablebase::bestMove(Engine::Board board, double expectations[Engine::MOVE_COUNT]) const {
+    uint64_t emptyMask = 0;
+    for (int i = 0; i < boardSize * boardSize; i++) emptyMask |= (uint64_t)1 << (4 * i);
+    int best = -1;
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        expectations[m] = -1.0;
+        int delta = 0;
+        Engine::Board moved = move(board, m, boardSize, cap, delta);
+        if (moved == board) continue;
+        uint64_t empties = Engine::zeroNibbles(moved) & emptyMask;
+        int emptyCount = __builtin_popcountll(empties);
+        double expectation = 0.0;
+        while (empties) {
+            uint64_t cell = empties & (~empties + 1);
+            empties &= empties - 1;
+            float two = 0.0f;
+            float four = 0.0f;
+            value(moved | cell, two);
+            value(moved | (cell * 2), four);
+            expectation += 0.9 * two + 0.1 * four;
+        }
+        expectations[m] = delta + expectation / emptyCount;
+        if (best < 0 || expectations[m] > expectations[best]) best = m;
+    }
+    return best;
+}
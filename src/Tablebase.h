@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "Engine.h"
+#include "MappedFile.h"
+
+// Tablebase chính xác cho bàn cờ nhỏ (3x3, hoặc 4x4 với giới hạn ô thấp): giá trị kỳ vọng
+// của điểm còn kiếm được khi chơi tối ưu, ô mới theo luật addNewTile (90% 2, 10% 4).
+// Ô (row, col) là nibble row * size + col. Hai ô bằng cap không gộp được nên mọi ván đều kết thúc.
+//
+// Mỗi nước đi cộng đúng 2 hoặc 4 vào tổng giá trị các ô, nên vị trí được chia tầng theo
+// tổng: tầng S chỉ phụ thuộc tầng S + 2 và S + 4. Bộ giải sinh mọi vị trí đạt được theo
+// chiều tiến (sinh nước đi và chèn vào bảng chia theo hash đều song song), rồi giải ngược
+// từ tầng cao nhất, mỗi tầng song song trên mọi nhân.
+// Vị trí được chuẩn hoá theo 8 phép đối xứng.
+class Tablebase {
+public:
+    Tablebase() : keys(nullptr), values(nullptr), slotMask(0), boardSize(0), cap(0), entryCount(0), startValue(0.0) {}
+
+    bool map(const std::string& path);
+    bool isReady() const { return keys != nullptr; }
+    int size() const { return boardSize; }
+    int capExponent() const { return cap; }
+    uint64_t positions() const { return entryCount; }
+    // Kỳ vọng điểm từ đầu ván (trung bình trên mọi bàn cờ khởi đầu)
+    double startExpectation() const { return startValue; }
+
+    // Giá trị của vị trí trước nước đi; false nếu vị trí không đạt được
+    bool value(Engine::Board board, float& result) const;
+    // Nước tốt nhất, tính lại từ giá trị các vị trí con; -1 nếu hết nước.
+    // expectations[m] = -1 cho nước không hợp lệ
+    int bestMove(Engine::Board board, double expectations[Engine::MOVE_COUNT]) const;
+
+    // Giải và ghi file; progress nhận tiến độ từng tầng
+    static bool solve(int boardSize, int capExponent, int threads, const std::string& path, std::ostream& progress);
+
+    // Luật trên bàn cờ size x size
+    static Engine::Board move(Engine::Board board, int move, int boardSize, int capExponent, int& scoreDelta);
+    static Engine::Board canonical(Engine::Board board, int boardSize);
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t boardSize;
+        uint32_t capExponent;
+        uint32_t reserved;
+        uint64_t slotCount;
+        uint64_t entryCount;
+        double startValue;
+    };
+
+    bool find(Engine::Board canonicalBoard, float& result) const;
+
+    MappedFile file;
+    const uint64_t* keys;
+    const float* values;
+    uint64_t slotMask;
+    int boardSize;
+    int cap;
+    uint64_t entryCount;
+    double startValue;
+};
@@ -0,0 +1,49 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threadCount) : currentJob(nullptr), generation(0), pending(0), stopping(false) {
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCondition.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+void ThreadPool::run(const std::function<void(int)>& job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    currentJob = &job;
+    pending = (int)workers.size();
+    generation++;
+    startCondition.notify_all();
+    doneCondition.wait(lock, [this] { return pending == 0; });
+    currentJob = nullptr;
+}
+
+void ThreadPool::workerLoop(int index) {
+    unsigned long seen = 0;
+    while (true) {
+        const std::function<void(int)>* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCondition.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            job = currentJob;
+        }
+        (*job)(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) doneCondition.notify_one();
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Nhóm luồng cố định cho các tác vụ song song kiểu fork/join:
+// run(job) gọi job(workerIndex) trên mọi worker và chờ tất cả xong.
+// Luồng được tạo một lần khi khởi tạo, không tạo lại mỗi lần run.
+class ThreadPool {
+public:
+    // threadCount <= 0: dùng số nhân của máy
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    int size() const { return (int)workers.size(); }
+    void run(const std::function<void(int)>& job);
+
+private:
+    void workerLoop(int index);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    const std::function<void(int)>* currentJob;
+    unsigned long generation;
+    int pending;
+    bool stopping;
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
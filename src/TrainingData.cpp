@@ -0,0 +1,166 @@
+#include "TrainingData.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(TrainingData::Record) == 24, "bản ghi phải có kích thước cố định trên đĩa");
+static_assert(sizeof(TrainingData::ShardHeader) == 72, "header phải có kích thước cố định trên đĩa");
+
+namespace {
+    const char SHARD_MAGIC[8] = {'2', '0', '4', '8', 'T', 'R', 'D', '1'};
+    const uint32_t SHARD_VERSION = 1;
+    // Bản ghi bắt đầu ở offset căn 64 byte sau header
+    const uint64_t RECORDS_OFFSET = 128;
+
+    bool writeAll(int fd, const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = write(fd, bytes, size);
+            if (written < 0) return false;
+            bytes += written;
+            size -= (size_t)written;
+        }
+        return true;
+    }
+}
+
+namespace TrainingData {
+    std::string shardPath(const std::string& prefix, int index) {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "-%05d.bin", index);
+        return prefix + suffix;
+    }
+
+    ShardWriter::ShardWriter() : maxRecords(0), fd(-1), shardIndex(0), shardRecords(0), shardGames(0), total(0) {}
+
+    ShardWriter::~ShardWriter() {
+        close();
+    }
+
+    bool ShardWriter::open(const std::string& shardPrefix, const std::string& strategyName, uint64_t maxRecordsPerShard) {
+        prefix = shardPrefix;
+        strategy = strategyName;
+        maxRecords = maxRecordsPerShard;
+        shardIndex = 0;
+        total = 0;
+        buffer.reserve(BUFFER_RECORDS);
+        return openShard();
+    }
+
+    bool ShardWriter::openShard() {
+        std::string path = shardPath(prefix, shardIndex);
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::cerr << "Cannot create " << path << std::endl;
+            return false;
+        }
+        shardRecords = 0;
+        shardGames = 0;
+        // Chừa chỗ cho header, ghi thật khi đóng shard
+        char zeros[RECORDS_OFFSET];
+        std::memset(zeros, 0, sizeof(zeros));
+        return writeAll(fd, zeros, sizeof(zeros));
+    }
+
+    bool ShardWriter::flush() {
+        if (buffer.empty()) return true;
+        bool ok = writeAll(fd, buffer.data(), buffer.size() * sizeof(Record));
+        buffer.clear();
+        if (!ok) std::cerr << "Write failed for " << shardPath(prefix, shardIndex) << std::endl;
+        return ok;
+    }
+
+    bool ShardWriter::closeShard() {
+        if (fd < 0) return true;
+        bool ok = flush();
+        ShardHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, SHARD_MAGIC, sizeof(SHARD_MAGIC));
+        header.version = SHARD_VERSION;
+        header.recordSize = sizeof(Record);
+        header.recordCount = shardRecords;
+        header.recordsOffset = RECORDS_OFFSET;
+        header.gameCount = shardGames;
+        std::strncpy(header.strategy, strategy.c_str(), sizeof(header.strategy) - 1);
+        ok = ok && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+        ok = (::close(fd) == 0) && ok;
+        fd = -1;
+        shardIndex++;
+        return ok;
+    }
+
+    bool ShardWriter::appendGame(const Record* records, size_t count) {
+        if (fd < 0) return false;
+        if (shardRecords > 0 && shardRecords + count > maxRecords) {
+            if (!closeShard() || !openShard()) return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            buffer.push_back(records[i]);
+            buffer.back().game = (uint32_t)shardGames;
+            if (buffer.size() == BUFFER_RECORDS && !flush()) return false;
+        }
+        shardRecords += count;
+        shardGames++;
+        total += count;
+        return true;
+    }
+
+    bool ShardWriter::close() {
+        return closeShard();
+    }
+
+    Shard::Shard() : mapping(nullptr), mappingSize(0), headerData(nullptr), records(nullptr) {}
+
+    Shard::~Shard() {
+        unmap();
+    }
+
+    bool Shard::map(const std::string& path) {
+        unmap();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Cannot open " << path << std::endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < RECORDS_OFFSET) {
+            ::close(fd);
+            std::cerr << path << " is too small for a training shard" << std::endl;
+            return false;
+        }
+        void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            std::cerr << "Cannot mmap " << path << std::endl;
+            return false;
+        }
+        const ShardHeader* header = static_cast<const ShardHeader*>(data);
+        bool valid = std::memcmp(header->magic, SHARD_MAGIC, sizeof(SHARD_MAGIC)) == 0 && header->version == SHARD_VERSION &&
+                     header->recordSize == sizeof(Record) &&
+                     header->recordsOffset + header->recordCount * sizeof(Record) <= (uint64_t)info.st_size;
+        if (!valid) {
+            std::cerr << path << " is not a complete training shard" << std::endl;
+            munmap(data, (size_t)info.st_size);
+            return false;
+        }
+        mapping = data;
+        mappingSize = (size_t)info.st_size;
+        headerData = header;
+        records = reinterpret_cast<const Record*>(static_cast<const char*>(data) + header->recordsOffset);
+        return true;
+    }
+
+    void Shard::unmap() {
+        if (mapping) {
+            munmap(mapping, mappingSize);
+            mapping = nullptr;
+            mappingSize = 0;
+            headerData = nullptr;
+            records = nullptr;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Engine.h"
+
+// Dữ liệu huấn luyện dạng nhị phân: mỗi shard là một header cố định rồi tới mảng bản
+// ghi cùng kích thước, nên đọc bản ghi thứ i chỉ là records[i] sau khi mmap.
+namespace TrainingData {
+    struct Record {
+        Engine::Board board;   // bàn cờ trước nước đi (nibble số mũ)
+        uint32_t scoreDelta;   // điểm gộp được của nước đi
+        uint32_t finalScore;   // điểm cuối ván
+        uint32_t game;         // số thứ tự ván trong shard
+        uint16_t moveNumber;   // nước thứ mấy trong ván
+        uint8_t move;          // Engine::Move
+        uint8_t reserved;
+    };
+
+    struct ShardHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t recordCount;
+        uint64_t recordsOffset;
+        uint64_t gameCount;
+        char strategy[32];
+    };
+
+    // Ghi một chuỗi shard (prefix-00000.bin, prefix-00001.bin, ...) cho một luồng.
+    // Bản ghi gom vào bộ đệm lớn rồi mới write(); header được ghi lại khi đóng shard.
+    class ShardWriter {
+    public:
+        ShardWriter();
+        ~ShardWriter();
+
+        bool open(const std::string& prefix, const std::string& strategy, uint64_t maxRecordsPerShard);
+        // Thêm các bản ghi của một ván; ván không bị chia qua hai shard
+        bool appendGame(const Record* records, size_t count);
+        bool close();
+
+        uint64_t totalRecords() const { return total; }
+        int shardCount() const { return shardIndex; }
+
+    private:
+        bool openShard();
+        bool closeShard();
+        bool flush();
+
+        static const size_t BUFFER_RECORDS = 1 << 16;
+
+        std::string prefix;
+        std::string strategy;
+        uint64_t maxRecords;
+        int fd;
+        int shardIndex;
+        uint64_t shardRecords;
+        uint64_t shardGames;
+        uint64_t total;
+        std::vector<Record> buffer;
+    };
+
+    // Shard được mmap chỉ đọc
+    class Shard {
+    public:
+        Shard();
+        ~Shard();
+
+        bool map(const std::string& path);
+        void unmap();
+
+        const ShardHeader& header() const { return *headerData; }
+        uint64_t size() const { return headerData ? headerData->recordCount : 0; }
+        const Record& operator[](uint64_t index) const { return records[index]; }
+
+    private:
+        void* mapping;
+        size_t mappingSize;
+        const ShardHeader* headerData;
+        const Record* records;
+
+        Shard(const Shard&);
+        Shard& operator=(const Shard&);
+    };
+
+    std::string shardPath(const std::string& prefix, int index);
+}
@@ -0,0 +1,116 @@
+#include "env2048.h"
+#include "BatchEngine.h"
+#include <new>
+
+static_assert(sizeof(int) == sizeof(int32_t), "env2048_step truyền thẳng int32_t cho BatchEngine");
+
+struct Env2048 {
+    std::vector<Engine::Board> boards;
+    std::vector<int32_t> scores;
+    std::vector<int32_t> rewards;
+    std::vector<uint8_t> dones;
+    std::vector<uint64_t> rngStates;
+    BatchEngine* batch;
+
+    Env2048() : batch(NULL) {}
+    ~Env2048() { delete batch; }
+};
+
+namespace {
+    // Ngoại lệ không được đi qua ranh giới C
+    Env2048* createEnv(size_t count, uint64_t* boards, int32_t* scores, int32_t* rewards, uint8_t* dones) {
+        if (count == 0) return NULL;
+        Env2048* env = NULL;
+        try {
+            env = new Env2048();
+            if (boards == NULL) {
+                env->boards.assign(count, 0);
+                env->scores.assign(count, 0);
+                env->rewards.assign(count, 0);
+                env->dones.assign(count, 0);
+                boards = env->boards.data();
+                scores = env->scores.data();
+                rewards = env->rewards.data();
+                dones = env->dones.data();
+            }
+            env->rngStates.assign(count, 0);
+            BatchEngine::Lanes lanes = {count, boards, scores, rewards, dones, env->rngStates.data()};
+            env->batch = new BatchEngine(lanes);
+            env2048_reset(env, NULL);
+        } catch (const std::bad_alloc&) {
+            delete env;
+            return NULL;
+        }
+        return env;
+    }
+}
+
+extern "C" {
+
+int env2048_abi_version(void) {
+    return ENV2048_ABI_VERSION;
+}
+
+Env2048* env2048_create(size_t count) {
+    return createEnv(count, NULL, NULL, NULL, NULL);
+}
+
+Env2048* env2048_create_with_buffers(size_t count, uint64_t* boards, int32_t* scores,
+                                     int32_t* rewards, uint8_t* dones) {
+    if (!boards || !scores || !rewards || !dones) return NULL;
+    return createEnv(count, boards, scores, rewards, dones);
+}
+
+void env2048_destroy(Env2048* env) {
+    delete env;
+}
+
+void env2048_reset(Env2048* env, const uint64_t* seeds) {
+    size_t count = env->batch->size();
+    for (size_t i = 0; i < count; i++) {
+        env2048_reset_lane(env, i, seeds ? seeds[i] : (uint64_t)i);
+    }
+}
+
+void env2048_reset_lane(Env2048* env, size_t lane, uint64_t seed) {
+    if (lane >= env->batch->size()) return;
+    env->rngStates[lane] = seed;
+    env->batch->resetLane(lane);
+}
+
+size_t env2048_step(Env2048* env, const int32_t* actions) {
+    return env->batch->step(actions);
+}
+
+size_t env2048_size(const Env2048* env) {
+    return env->batch->size();
+}
+
+const uint64_t* env2048_boards(const Env2048* env) {
+    return env->batch->boards();
+}
+
+const int32_t* env2048_scores(const Env2048* env) {
+    return env->batch->scores();
+}
+
+const int32_t* env2048_rewards(const Env2048* env) {
+    return env->batch->rewards();
+}
+
+const uint8_t* env2048_dones(const Env2048* env) {
+    return env->batch->dones();
+}
+
+void env2048_decode(uint64_t board, int32_t values[16]) {
+    for (int i = 0; i < Engine::CELL_COUNT; i++) {
+        values[i] = Engine::valueOf(Engine::getCell(board, i));
+    }
+}
+
+int env2048_is_legal(uint64_t board, int32_t action) {
+    if (action < 0 || action >= Engine::MOVE_COUNT) return 0;
+    return Engine::move(board, action) != board ? 1 : 0;
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef ENV2048_H
+#define ENV2048_H
+
+/*
+ * C ABI cho lib2048env.so: một lô môi trường 2048 chạy bằng BatchEngine.
+ * Luật giống hệt Game2048 (moveTiles/addNewTile/canMove). Bàn cờ là uint64 nén,
+ * mỗi ô một nibble số mũ, ô (row, col) ở nibble row * 4 + col.
+ * Action: 0 = trái, 1 = phải, 2 = lên, 3 = xuống. Action khác là nước không hợp lệ:
+ * bàn cờ giữ nguyên, reward 0 (như nước không làm thay đổi bàn cờ).
+ * Lane có done = 1 tự reset ở lần env2048_step kế tiếp (action của lane đó bị bỏ qua).
+ * Không hàm nào cấp phát bộ nhớ sau env2048_create*.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define ENV2048_API __declspec(dllexport)
+#else
+#define ENV2048_API __attribute__((visibility("default")))
+#endif
+
+#define ENV2048_ABI_VERSION 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Env2048 Env2048;
+
+ENV2048_API int env2048_abi_version(void);
+
+/* Tự cấp phát bộ nhớ cho count lane; trả về NULL nếu lỗi */
+ENV2048_API Env2048* env2048_create(size_t count);
+/* Dùng bộ nhớ của người gọi (zero-copy), mỗi mảng count phần tử và phải sống lâu hơn env */
+ENV2048_API Env2048* env2048_create_with_buffers(size_t count, uint64_t* boards, int32_t* scores,
+                                                 int32_t* rewards, uint8_t* dones);
+ENV2048_API void env2048_destroy(Env2048* env);
+
+/* seeds có count phần tử; NULL nghĩa là seed 0 cho lane 0, 1 cho lane 1, ... */
+ENV2048_API void env2048_reset(Env2048* env, const uint64_t* seeds);
+ENV2048_API void env2048_reset_lane(Env2048* env, size_t lane, uint64_t seed);
+/* Trả về số lane có action ngoài [0, 3] (0 nếu mọi action hợp lệ) */
+ENV2048_API size_t env2048_step(Env2048* env, const int32_t* actions);
+
+ENV2048_API size_t env2048_size(const Env2048* env);
+ENV2048_API const uint64_t* env2048_boards(const Env2048* env);
+ENV2048_API const int32_t* env2048_scores(const Env2048* env);
+ENV2048_API const int32_t* env2048_rewards(const Env2048* env);
+ENV2048_API const uint8_t* env2048_dones(const Env2048* env);
+
+/* Giải nén bàn cờ thành 16 giá trị ô thật (0, 2, 4, ...) theo thứ tự row-major */
+ENV2048_API void env2048_decode(uint64_t board, int32_t values[16]);
+/* 1 nếu action làm thay đổi bàn cờ */
+ENV2048_API int env2048_is_legal(uint64_t board, int32_t action);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
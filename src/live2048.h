@@ -0,0 +1,80 @@
+#ifndef LIVE2048_H
+#define LIVE2048_H
+
+/*
+ * Bố cục vùng nhớ chia sẻ POSIX mà game công bố khi chạy với --live-shm NAME.
+ * Overlay và bot ở tiến trình khác mở NAME bằng shm_open (chỉ đọc), mmap rồi gọi
+ * live2048_read để lấy một snapshot nhất quán. Đồng bộ bằng seqlock: game không bao giờ
+ * khoá hay chờ người đọc, người đọc không cần syscall nào sau khi mmap.
+ * Bàn cờ là uint64 nén giống env2048.h: ô (row, col) ở nibble row * 4 + col, giá trị 2^nibble.
+ * Cần GCC hoặc Clang (dùng builtin __atomic), dùng được từ cả C lẫn C++.
+ */
+
+#include <stdint.h>
+
+#define LIVE2048_MAGIC 0x4556494Cu  /* "LIVE" */
+#define LIVE2048_VERSION 1
+#define LIVE2048_DEFAULT_NAME "/2048-live"
+
+/* Bit của Live2048Snapshot.flags */
+#define LIVE2048_GAME_OVER 0x1u
+#define LIVE2048_GAME_OVER2 0x2u
+#define LIVE2048_MULTIPLAYER 0x4u
+#define LIVE2048_IN_MENU 0x8u
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Live2048Snapshot {
+    uint64_t board;      /* người chơi 1 (hoặc ván một người) */
+    uint64_t board2;     /* người chơi 2, 0 ở chế độ một người */
+    int32_t score;
+    int32_t score2;
+    uint32_t flags;
+    uint32_t writerPid;
+    uint64_t moves;      /* số nước đi hợp lệ của cả hai người chơi từ khi game mở */
+    uint64_t updateNs;   /* CLOCK_MONOTONIC lúc công bố */
+} Live2048Snapshot;
+
+/* Một cache line; sequence lẻ nghĩa là game đang ghi dở */
+typedef struct Live2048Segment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sequence;
+    uint32_t reserved;
+    Live2048Snapshot data;
+} Live2048Segment;
+
+/* Sao chép snapshot nhất quán; trả về 0 nếu game ghi liên tục suốt maxTries lần thử */
+static inline int live2048_read(const Live2048Segment* segment, Live2048Snapshot* out, int maxTries) {
+    int attempt;
+    for (attempt = 0; attempt < maxTries; attempt++) {
+        uint32_t before = __atomic_load_n(&segment->sequence, __ATOMIC_ACQUIRE);
+        uint32_t after;
+        if (before & 1u) continue;
+        out->board = __atomic_load_n(&segment->data.board, __ATOMIC_RELAXED);
+        out->board2 = __atomic_load_n(&segment->data.board2, __ATOMIC_RELAXED);
+        out->score = __atomic_load_n(&segment->data.score, __ATOMIC_RELAXED);
+        out->score2 = __atomic_load_n(&segment->data.score2, __ATOMIC_RELAXED);
+        out->flags = __atomic_load_n(&segment->data.flags, __ATOMIC_RELAXED);
+        out->writerPid = __atomic_load_n(&segment->data.writerPid, __ATOMIC_RELAXED);
+        out->moves = __atomic_load_n(&segment->data.moves, __ATOMIC_RELAXED);
+        out->updateNs = __atomic_load_n(&segment->data.updateNs, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+        if (before == after) return 1;
+    }
+    return 0;
+}
+
+/* Số lần game đã công bố; người đọc thăm dò so sánh giá trị này để biết có gì mới */
+static inline uint32_t live2048_version(const Live2048Segment* segment) {
+    return __atomic_load_n(&segment->sequence, __ATOMIC_ACQUIRE) >> 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,12 +1,30 @@
 #include "Game2048.h"
+#include "AllocTracker.h"
+#include "Options.h"
+#include "ReplayExport.h"
 
 int main(int argc, char* argv[]) {
+    GameOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    AllocTracker::setAssertMode(options.allocAssert);
+
+    // Xuất replay không mở cửa sổ, chạy xong là thoát
+    if (!options.exportReplay.empty()) {
+        return ReplayExport::run(options) ? 0 : 1;
+    }
+
     Game2048 game;
     
-    if (!game.init()) {
+    if (!game.init(options)) {
         return 1;
     }
     
-    game.run();
-    return 0;
-} 
\ No newline at end of file
+    // Headless có synthetic input hoặc phiên ghi sẵn chạy vòng lặp game thật, còn lại chỉ render ảnh
+    if (options.headless && options.syntheticInputHz == 0 && options.playSession.empty()) {
+        return game.runHeadless() ? 0 : 1;
+    }
+
+    return game.run() ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+// Kiểm tra hồi quy tối giản cho `make check`: CHECK in vị trí lỗi và đếm lại, mỗi
+// chương trình kiểm tra trả về Check::result() từ main.
+namespace Check {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline int result(const char* name) {
+        std::cout << name << ": " << (failures() == 0 ? "ok" : "FAILED") << std::endl;
+        return failures() == 0 ? 0 : 1;
+    }
+
+    // Thư mục tạm riêng cho mỗi lần chạy, xoá khi kết thúc
+    class TempDir {
+    public:
+        TempDir() {
+            char pattern[] = "/tmp/2048-check-XXXXXX";
+            const char* created = mkdtemp(pattern);
+            dir = created ? created : "/tmp";
+        }
+        ~TempDir() {
+            if (dir != "/tmp") {
+                std::string command = "rm -rf '" + dir + "'";
+                int status = std::system(command.c_str());
+                (void)status;
+            }
+        }
+        std::string path(const char* name) const { return dir + "/" + name; }
+
+    private:
+        std::string dir;
+    };
+}
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            Check::failures()++;                                                              \
+        }                                                                                     \
+    } while (0)
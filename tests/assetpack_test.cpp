@@ -0,0 +1,86 @@
+// Gói asset: ghi rồi mmap lại, mỗi asset khớp byte với file gốc; pack hỏng bị từ chối
+#include "Check.h"
+#include "AssetPack.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string makeFile(const Check::TempDir& temp, const char* name, size_t size) {
+        std::string path = temp.path(name);
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; i++) data[i] = (char)(i * 31 + size);
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+        return path;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    void roundTrip(const Check::TempDir& temp) {
+        std::vector<std::string> files;
+        files.push_back(makeFile(temp, "b.wav", 10000));
+        files.push_back(makeFile(temp, "a.ttf", 4096));
+        files.push_back(makeFile(temp, "empty", 0));
+        files.push_back(makeFile(temp, "c.wav", 1));
+        files.push_back(files[0]);  // trùng tên chỉ được gói một lần
+        std::string packPath = temp.path("assets.pack");
+        CHECK(AssetPack::write(packPath, files));
+
+        AssetPack pack;
+        CHECK(pack.map(packPath));
+        CHECK(pack.isReady());
+        CHECK(pack.size() == 4);
+        for (size_t i = 0; i < pack.size(); i++) {
+            CHECK(pack.at(i).offset % 4096 == 0);
+            if (i > 0) CHECK(std::strcmp(pack.at(i - 1).name, pack.at(i).name) < 0);
+        }
+        for (size_t i = 0; i < 4; i++) {
+            size_t bytes = 12345;
+            const void* data = pack.find(files[i], bytes);
+            std::string original = readFile(files[i]);
+            CHECK(data != nullptr);
+            CHECK(bytes == original.size());
+            CHECK(data && std::memcmp(data, original.data(), bytes) == 0);
+        }
+        size_t bytes = 0;
+        CHECK(pack.find(temp.path("missing.wav"), bytes) == nullptr);
+        CHECK(pack.find("", bytes) == nullptr);
+    }
+
+    void rejects(const Check::TempDir& temp) {
+        // Tên dài hơn bảng mục lục
+        std::vector<std::string> tooLong(1, makeFile(temp, "a-file-name-that-does-not-fit-in-the-table.ttf", 10));
+        CHECK(!AssetPack::write(temp.path("long.pack"), tooLong));
+        // File không tồn tại
+        CHECK(!AssetPack::write(temp.path("missing.pack"), std::vector<std::string>(1, temp.path("nope"))));
+
+        // Offset của mục đầu tiên trỏ ra ngoài file: header 24 byte, offset nằm sau tên 56 byte
+        std::string path = temp.path("corrupt.pack");
+        CHECK(AssetPack::write(path, std::vector<std::string>(1, makeFile(temp, "x.wav", 100))));
+        FILE* file = std::fopen(path.c_str(), "r+b");
+        CHECK(file != nullptr);
+        if (file) {
+            std::fseek(file, 24 + 56 + 7, SEEK_SET);
+            std::fputc(0x7F, file);
+            std::fclose(file);
+        }
+        AssetPack pack;
+        CHECK(!pack.map(path));
+        CHECK(!pack.isReady());
+        CHECK(!pack.map(temp.path("x.wav")));
+    }
+}
+
+int main() {
+    Check::TempDir temp;
+    roundTrip(temp);
+    rejects(temp);
+    return Check::result("assetpack");
+}
@@ -0,0 +1,99 @@
+// Engine: canMove đúng khi và chỉ khi có nước làm thay đổi bàn cờ, kể cả với cặp 32768
+// mà bảng hàng không gộp; BatchEngine kết thúc lane khi rơi vào bàn cờ như vậy và bỏ qua
+// nước ngoài khoảng
+#include "Check.h"
+#include "BatchEngine.h"
+#include "Engine.h"
+
+namespace {
+    Engine::Board fromRows(const int rows[4][4]) {
+        Engine::Board board = 0;
+        for (int row = 0; row < 4; row++) {
+            for (int col = 0; col < 4; col++) board = Engine::setCell(board, row * 4 + col, rows[row][col]);
+        }
+        return board;
+    }
+
+    bool anyMoveChanges(Engine::Board board) {
+        for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+            if (Engine::move(board, m) != board) return true;
+        }
+        return false;
+    }
+
+    void maxPair() {
+        // Bàn cờ đầy gồm cặp 15/15 và các số mũ 1..14 không kề nhau bằng nhau
+        const int horizontal[4][4] = {{15, 15, 1, 2}, {3, 4, 5, 6}, {7, 8, 9, 10}, {11, 12, 13, 14}};
+        const int vertical[4][4] = {{15, 1, 2, 3}, {15, 4, 5, 6}, {7, 8, 9, 10}, {11, 12, 13, 14}};
+        CHECK(!Engine::canMove(fromRows(horizontal)));
+        CHECK(!Engine::canMove(fromRows(vertical)));
+        CHECK(!anyMoveChanges(fromRows(horizontal)));
+        CHECK(!anyMoveChanges(fromRows(vertical)));
+        // Cặp 14/14 vẫn gộp được
+        const int mergeable[4][4] = {{14, 14, 1, 2}, {3, 4, 5, 6}, {7, 8, 9, 10}, {11, 12, 13, 15}};
+        CHECK(Engine::canMove(fromRows(mergeable)));
+    }
+
+    // Bàn cờ đầy ngẫu nhiên với ít số mũ khác nhau để có nhiều cặp kề nhau
+    void randomFull() {
+        Engine::Rng rng(2048);
+        const int exponents[4] = {1, 2, 14, 15};
+        int movable = 0;
+        int mismatches = 0;
+        for (int i = 0; i < 200000; i++) {
+            Engine::Board board = 0;
+            for (int cell = 0; cell < Engine::CELL_COUNT; cell++) {
+                board = Engine::setCell(board, cell, exponents[rng.below(4)]);
+            }
+            bool expected = anyMoveChanges(board);
+            if (Engine::canMove(board) != expected) mismatches++;
+            if (expected) movable++;
+        }
+        CHECK(mismatches == 0);
+        CHECK(movable > 0 && movable < 200000);
+    }
+
+    // Sang trái để lại đúng một ô trống ở góc phải trên; 2 hay 4 đều không gộp được với
+    // ô kề nên ván phải kết thúc dù còn cặp 15/15
+    void batchFinishes() {
+        const int rows[4][4] = {{0, 5, 6, 7}, {15, 15, 8, 9}, {10, 11, 12, 13}, {14, 3, 4, 5}};
+        for (uint64_t seed = 0; seed < 8; seed++) {
+            Engine::Board board = fromRows(rows);
+            int32_t score = 0;
+            int32_t reward = -1;
+            uint8_t done = 0;
+            uint64_t rngState = seed;
+            BatchEngine::Lanes lanes = {1, &board, &score, &reward, &done, &rngState};
+            BatchEngine engine(lanes);
+            int move = Engine::MOVE_LEFT;
+            engine.step(&move);
+            CHECK(reward == 0);
+            CHECK(done == 1);
+            CHECK(engine.gamesFinished() == 1);
+        }
+    }
+
+    // Nước ngoài [0, 3] không bị đổi thành nước khác: bàn cờ giữ nguyên, reward 0
+    void batchInvalidMoves() {
+        BatchEngine engine(4);
+        engine.reset(5);
+        Engine::Board before[4];
+        for (int i = 0; i < 4; i++) before[i] = engine.boards()[i];
+        const int moves[4] = {-1, 4, 5, Engine::MOVE_COUNT + Engine::MOVE_LEFT};
+        CHECK(engine.step(moves) == 4);
+        for (int i = 0; i < 4; i++) {
+            CHECK(engine.boards()[i] == before[i]);
+            CHECK(engine.rewards()[i] == 0 && engine.scores()[i] == 0 && engine.dones()[i] == 0);
+        }
+        const int valid[4] = {Engine::MOVE_LEFT, Engine::MOVE_RIGHT, Engine::MOVE_UP, Engine::MOVE_DOWN};
+        CHECK(engine.step(valid) == 0);
+    }
+}
+
+int main() {
+    maxPair();
+    randomFull();
+    batchFinishes();
+    batchInvalidMoves();
+    return Check::result("engine");
+}
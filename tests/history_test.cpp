@@ -0,0 +1,124 @@
+// Lịch sử ván: ghi rồi truy vấn, mở lại, dựng lại index, và hai process cùng ghi một file
+#include "Check.h"
+#include "GameHistory.h"
+#include "Engine.h"
+#include <cstdio>
+#include <cstring>
+#include <sys/wait.h>
+#include <vector>
+
+namespace {
+    GameHistory::Record makeRecord(Engine::Rng& rng) {
+        GameHistory::Record record;
+        std::memset(&record, 0, sizeof(record));
+        record.timestamp = 1700000000 + (int64_t)rng.below(1000000);
+        record.seed = rng.next();
+        record.score = (int32_t)rng.below(100000);
+        record.moves = (uint32_t)rng.below(3000);
+        record.durationMs = (uint32_t)rng.below(600000);
+        record.mode = (uint8_t)rng.below(GameHistory::MODE_COUNT);
+        record.player = 1;
+        record.maxTile = (uint8_t)(1 + rng.below(15));
+        return record;
+    }
+
+    // Tổng đúng tính thẳng từ danh sách record
+    GameHistory::Summary expected(const std::vector<GameHistory::Record>& records, uint32_t modeMask) {
+        GameHistory::Summary summary;
+        summary.clear();
+        for (size_t i = 0; i < records.size(); i++) {
+            if (modeMask & (1u << records[i].mode)) summary.add(records[i]);
+        }
+        return summary;
+    }
+
+    bool sameSummary(const GameHistory::Summary& a, const GameHistory::Summary& b) {
+        return a.count == b.count && (a.count == 0 || (a.bestScore == b.bestScore && a.scoreSum == b.scoreSum &&
+               a.moveSum == b.moveSum && a.durationSum == b.durationSum && a.firstTimestamp == b.firstTimestamp &&
+               a.lastTimestamp == b.lastTimestamp)) &&
+               std::memcmp(a.tileCounts, b.tileCounts, sizeof(a.tileCounts)) == 0 &&
+               std::memcmp(a.scoreBuckets, b.scoreBuckets, sizeof(a.scoreBuckets)) == 0;
+    }
+
+    void checkQueries(const GameHistory::Database& database, const std::vector<GameHistory::Record>& records) {
+        GameHistory::Stats stats;
+        CHECK(database.query(GameHistory::ALL_MODES, stats));
+        CHECK(stats.records == records.size());
+        CHECK(sameSummary(stats.total, expected(records, GameHistory::ALL_MODES)));
+        for (int m = 0; m < GameHistory::MODE_COUNT; m++) {
+            CHECK(database.query(1u << m, stats));
+            CHECK(sameSummary(stats.total, expected(records, 1u << m)));
+        }
+    }
+
+    void roundTrip(const Check::TempDir& temp) {
+        std::string path = temp.path("history.db");
+        Engine::Rng rng(1);
+        std::vector<GameHistory::Record> records;
+        {
+            GameHistory::Database database;
+            CHECK(database.open(path));
+            // Hơn hai block để có block đầy, block dở và trend theo từng ván
+            for (int i = 0; i < 600; i++) {
+                records.push_back(makeRecord(rng));
+                CHECK(database.append(records.back()));
+            }
+            CHECK(database.size() == records.size());
+            checkQueries(database, records);
+        }
+        {
+            GameHistory::Database database;
+            CHECK(database.open(path));
+            CHECK(database.size() == records.size());
+            checkQueries(database, records);
+        }
+        // Mất index: open() dựng lại từ record
+        std::remove((path + ".idx").c_str());
+        GameHistory::Database database;
+        CHECK(database.open(path));
+        checkQueries(database, records);
+    }
+
+    void concurrentWriters(const Check::TempDir& temp) {
+        std::string path = temp.path("shared.db");
+        const int GAMES = 700;
+        // Cả hai mở trước khi ghi, như hai game cùng thư mục trong một trận đấu mạng
+        GameHistory::Database first;
+        GameHistory::Database second;
+        CHECK(first.open(path) && second.open(path));
+
+        std::vector<GameHistory::Record> records;
+        for (int writer = 0; writer < 2; writer++) {
+            Engine::Rng rng(100 + writer);
+            for (int i = 0; i < GAMES; i++) records.push_back(makeRecord(rng));
+        }
+        pid_t children[2];
+        for (int writer = 0; writer < 2; writer++) {
+            children[writer] = fork();
+            if (children[writer] == 0) {
+                GameHistory::Database& database = writer == 0 ? first : second;
+                bool ok = true;
+                for (int i = 0; i < GAMES; i++) ok = database.append(records[writer * GAMES + i]) && ok;
+                _exit(ok ? 0 : 1);
+            }
+        }
+        for (int writer = 0; writer < 2; writer++) {
+            int status = 0;
+            waitpid(children[writer], &status, 0);
+            CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+        // Instance còn mở thấy cả ván của instance kia
+        checkQueries(first, records);
+        GameHistory::Database reopened;
+        CHECK(reopened.open(path));
+        CHECK(reopened.size() == records.size());
+        checkQueries(reopened, records);
+    }
+}
+
+int main() {
+    Check::TempDir temp;
+    roundTrip(temp);
+    concurrentWriters(temp);
+    return Check::result("history");
+}
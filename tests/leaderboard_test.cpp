@@ -0,0 +1,128 @@
+// Bảng điểm cao: đối chiếu với std::multiset, mở lại file, thu nhỏ N, và hai process
+// cùng ghi một bảng
+#include "Check.h"
+#include "Leaderboard.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <sys/wait.h>
+#include <vector>
+
+namespace {
+    typedef std::multiset<int32_t, std::greater<int32_t> > Reference;
+
+    Leaderboard::Entry makeEntry(int32_t score, int64_t timestamp) {
+        Leaderboard::Entry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.score = score;
+        entry.player = 1;
+        entry.maxTile = 11;
+        entry.timestamp = timestamp;
+        return entry;
+    }
+
+    void keepTop(Reference& reference, int32_t score, size_t capacity) {
+        reference.insert(score);
+        if (reference.size() > capacity) reference.erase(std::prev(reference.end()));
+    }
+
+    bool matches(const Leaderboard& board, const Reference& reference) {
+        if (board.size() != reference.size()) return false;
+        Reference::const_iterator it = reference.begin();
+        for (uint32_t i = 0; i < board.size(); i++, ++it) {
+            if (board.at(i).score != *it) return false;
+        }
+        return true;
+    }
+
+    void roundTrip(const Check::TempDir& temp) {
+        std::string path = temp.path("leaderboard.dat");
+        const uint32_t CAPACITY = 50;
+        Engine::Rng rng(7);
+        Reference reference;
+        Leaderboard board;
+        CHECK(board.open(path, CAPACITY));
+        for (int i = 0; i < 5000; i++) {
+            int32_t score = (int32_t)rng.below(20000);
+            bool enters = reference.size() < CAPACITY || score > *reference.rbegin();
+            uint32_t expectedRank = 1 + (uint32_t)std::distance(reference.begin(), reference.lower_bound(score));
+            // Điểm bằng nhau: mục mới đứng sau mọi mục cũ cùng điểm
+            expectedRank += (uint32_t)reference.count(score);
+            uint32_t rank = board.insert(makeEntry(score, i));
+            CHECK(enters ? rank == expectedRank : rank == 0);
+            if (enters) keepTop(reference, score, CAPACITY);
+        }
+        CHECK(matches(board, reference));
+        for (int i = 0; i < 200; i++) {
+            int32_t score = (int32_t)rng.below(20000);
+            CHECK(board.rankOf(score) == 1 + (uint32_t)std::distance(reference.begin(), reference.lower_bound(score)));
+        }
+
+        Leaderboard reopened;
+        CHECK(reopened.open(path, CAPACITY));
+        CHECK(reopened.size() == board.size());
+        for (uint32_t i = 0; i < board.size() && i < reopened.size(); i++) {
+            CHECK(std::memcmp(&reopened.at(i), &board.at(i), sizeof(Leaderboard::Entry)) == 0);
+        }
+        board.close();
+        reopened.close();
+
+        // N nhỏ đi: giữ các mục cao nhất
+        Leaderboard shrunk;
+        CHECK(shrunk.open(path, 10));
+        Reference top10(reference.begin(), std::next(reference.begin(), 10));
+        CHECK(matches(shrunk, top10));
+        shrunk.close();
+        CHECK(shrunk.open(path, 10));
+        CHECK(matches(shrunk, top10));
+    }
+
+    void concurrentWriters(const Check::TempDir& temp) {
+        std::string path = temp.path("shared.dat");
+        const uint32_t CAPACITY = 40;
+        const int GAMES = 2000;
+        Leaderboard first;
+        Leaderboard second;
+        CHECK(first.open(path, CAPACITY) && second.open(path, CAPACITY));
+
+        pid_t children[2];
+        for (int writer = 0; writer < 2; writer++) {
+            children[writer] = fork();
+            if (children[writer] == 0) {
+                Leaderboard& board = writer == 0 ? first : second;
+                Engine::Rng rng(200 + writer);
+                for (int i = 0; i < GAMES; i++) board.insert(makeEntry((int32_t)rng.below(1000000), i));
+                _exit(0);
+            }
+        }
+        for (int writer = 0; writer < 2; writer++) {
+            int status = 0;
+            waitpid(children[writer], &status, 0);
+            CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+
+        Reference reference;
+        for (int writer = 0; writer < 2; writer++) {
+            Engine::Rng rng(200 + writer);
+            for (int i = 0; i < GAMES; i++) keepTop(reference, (int32_t)rng.below(1000000), CAPACITY);
+        }
+        Leaderboard reopened;
+        CHECK(reopened.open(path, CAPACITY));
+        CHECK(matches(reopened, reference));
+        // Instance cũ nạp lại bảng trước lần ghi tiếp theo
+        CHECK(first.insert(makeEntry(2000000, GAMES)) == 1);
+        CHECK(reopened.open(path, CAPACITY));
+        CHECK(reopened.size() == CAPACITY && reopened.at(0).score == 2000000 &&
+              reopened.at(1).score == *reference.begin());
+    }
+}
+
+int main() {
+    Check::TempDir temp;
+    roundTrip(temp);
+    concurrentWriters(temp);
+    return Check::result("leaderboard");
+}
@@ -0,0 +1,81 @@
+// Đấu mạng: host và client trong cùng process qua loopback, và huỷ phiên đang kết nối
+#include "Check.h"
+#include "NetSession.h"
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    double millisSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool waitReady(const NetSession& a, const NetSession& b) {
+        Clock::time_point start = Clock::now();
+        while (millisSince(start) < 5000) {
+            if (a.state() == NetSession::STATE_READY && b.state() == NetSession::STATE_READY) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    }
+
+    // Nước đi và hash tới đủ và đúng thứ tự ở bên kia
+    void exchange(int port) {
+        const int MOVES = 5000;
+        NetSession host;
+        NetSession client;
+        CHECK(host.host(port, 0x1234567890ABCDEFULL));
+        CHECK(client.connect("127.0.0.1:" + std::to_string(port)));
+        CHECK(waitReady(host, client));
+        CHECK(client.seed() == 0x1234567890ABCDEFULL);
+
+        // Luồng game không bao giờ chờ socket: gửi cả loạt phải gần như tức thời
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < MOVES; i++) {
+            host.sendMove(i % Engine::MOVE_COUNT);
+            if (i % 100 == 99) host.sendHash((uint32_t)i);
+        }
+        CHECK(millisSince(start) < 100);
+
+        int moves = 0;
+        int hashes = 0;
+        NetSession::Message message;
+        start = Clock::now();
+        while ((moves < MOVES || hashes < MOVES / 100) && millisSince(start) < 5000) {
+            if (!client.nextMessage(message)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } else if (message.type == NetSession::MESSAGE_MOVE) {
+                CHECK(message.move == moves % Engine::MOVE_COUNT);
+                moves++;
+            } else {
+                CHECK(message.hash == (uint32_t)(moves - 1));
+                hashes++;
+            }
+        }
+        CHECK(moves == MOVES);
+        CHECK(hashes == MOVES / 100);
+        CHECK(host.state() == NetSession::STATE_READY && client.state() == NetSession::STATE_READY);
+    }
+
+    // ~NetSession không được chờ hết lượt kết nối lại hay connect của hệ điều hành
+    void cancelConnecting(int port) {
+        Clock::time_point start;
+        {
+            NetSession client;
+            CHECK(client.connect("127.0.0.1:" + std::to_string(port)));
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            CHECK(client.state() == NetSession::STATE_CONNECTING);
+            start = Clock::now();
+        }
+        CHECK(millisSince(start) < 200);
+    }
+}
+
+int main() {
+    int port = 40000 + (int)(getpid() % 20000);
+    exchange(port);
+    cancelConnecting(port + 1);
+    return Check::result("net");
+}
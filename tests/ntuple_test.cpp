@@ -0,0 +1,137 @@
+// Mạng n-tuple: greedyMove chọn đúng nước có điểm gộp + V(afterstate) lớn nhất, ghi/đọc
+// giữ nguyên trọng số, và file hỏng không làm mất mạng đang dùng
+#include "Check.h"
+#include "NTuple.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+    // Bàn cờ từ các ván ngẫu nhiên, đủ đa dạng để mọi nước đều có lúc thắng
+    std::vector<Engine::Board> randomBoards(uint64_t seed, int games) {
+        std::vector<Engine::Board> boards;
+        Engine::Rng rng(seed);
+        for (int g = 0; g < games; g++) {
+            Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+            while (Engine::canMove(board)) {
+                boards.push_back(board);
+                int delta = 0;
+                Engine::Board afterstate = Engine::move(board, rng.below(Engine::MOVE_COUNT), delta);
+                if (afterstate != board) board = Engine::spawnRandom(afterstate, rng);
+            }
+            boards.push_back(board);
+        }
+        return boards;
+    }
+
+    // Trọng số khác 0 và không đối xứng theo nước đi
+    void randomWeights(NTupleNetwork& network, const std::vector<Engine::Board>& boards) {
+        Engine::Rng rng(99);
+        for (size_t i = 0; i < boards.size(); i++) network.update(boards[i], (float)rng.below(2001) - 1000.0f);
+    }
+
+    void greedy(const NTupleNetwork& network, const std::vector<Engine::Board>& boards) {
+        int chosen[Engine::MOVE_COUNT] = {0, 0, 0, 0};
+        int finished = 0;
+        for (size_t i = 0; i < boards.size(); i++) {
+            // Duyệt thẳng: nước hợp lệ đầu tiên có tổng lớn nhất
+            int expected = -1;
+            float expectedTotal = 0.0f;
+            for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+                int delta = 0;
+                Engine::Board moved = Engine::move(boards[i], m, delta);
+                if (moved == boards[i]) continue;
+                float total = delta + network.evaluate(moved);
+                if (expected < 0 || total > expectedTotal) {
+                    expected = m;
+                    expectedTotal = total;
+                }
+            }
+
+            Engine::Board afterstate = 0;
+            int reward = -1;
+            float value = 0.0f;
+            int move = network.greedyMove(boards[i], afterstate, reward, value);
+            CHECK(move == expected);
+            if (move < 0) {
+                finished++;
+                continue;
+            }
+            chosen[move]++;
+            int delta = 0;
+            CHECK(afterstate == Engine::move(boards[i], move, delta));
+            CHECK(reward == delta);
+            CHECK(value == network.evaluate(afterstate));
+        }
+        CHECK(finished > 0);
+        for (int m = 0; m < Engine::MOVE_COUNT; m++) CHECK(chosen[m] > 0);
+    }
+
+    bool sameValues(const NTupleNetwork& a, const NTupleNetwork& b, const std::vector<Engine::Board>& boards) {
+        for (size_t i = 0; i < boards.size(); i++) {
+            if (a.evaluate(boards[i]) != b.evaluate(boards[i])) return false;
+        }
+        return true;
+    }
+
+    void writeBytes(const std::string& path, const std::string& data) {
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+    }
+
+    void saveAndLoad(const Check::TempDir& temp, const NTupleNetwork& network, const std::vector<Engine::Board>& boards) {
+        std::string path = temp.path("weights.bin");
+        CHECK(network.save(path));
+
+        NTupleNetwork loaded;
+        CHECK(loaded.load(path));
+        CHECK(loaded.preset() == NTupleNetwork::PRESET_4X4);
+        CHECK(sameValues(network, loaded, boards));
+        NTupleNetwork mapped;
+        CHECK(mapped.map(path));
+        CHECK(mapped.isMapped());
+        CHECK(sameValues(network, mapped, boards));
+
+        std::ifstream in(path.c_str(), std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::vector<std::string> broken;
+        broken.push_back(bytes.substr(0, bytes.size() - 4));  // thiếu trọng số cuối
+        broken.push_back(bytes.substr(0, 10));                // thiếu cả header
+        broken.push_back(bytes);
+        broken.back()[0] ^= 0x20;                             // sai magic
+        broken.push_back(bytes);
+        broken.back()[16] ^= 0x01;                            // weightCount không khớp preset
+        broken.push_back(bytes);
+        broken.back()[12] = 7;                                // preset không tồn tại
+
+        // Mạng đang dùng có trọng số khác: file hỏng không được đổi preset hay trọng số
+        NTupleNetwork current;
+        CHECK(current.init(NTupleNetwork::PRESET_4X4));
+        randomWeights(current, std::vector<Engine::Board>(boards.rbegin(), boards.rend()));
+        std::vector<float> before;
+        for (size_t i = 0; i < boards.size(); i++) before.push_back(current.evaluate(boards[i]));
+        std::string brokenPath = temp.path("broken.bin");
+        for (size_t b = 0; b < broken.size(); b++) {
+            writeBytes(brokenPath, broken[b]);
+            CHECK(!current.load(brokenPath));
+            CHECK(current.isReady() && !current.isMapped());
+            CHECK(current.preset() == NTupleNetwork::PRESET_4X4);
+            for (size_t i = 0; i < boards.size(); i++) CHECK(current.evaluate(boards[i]) == before[i]);
+        }
+        CHECK(!current.load(temp.path("missing.bin")));
+        CHECK(current.isReady());
+    }
+}
+
+int main() {
+    Check::TempDir temp;
+    std::vector<Engine::Board> boards = randomBoards(7, 20);
+    NTupleNetwork network;
+    CHECK(network.init(NTupleNetwork::PRESET_4X4));
+    randomWeights(network, boards);
+    greedy(network, boards);
+    saveAndLoad(temp, network, boards);
+    return Check::result("ntuple");
+}
@@ -0,0 +1,109 @@
+// Replay: ghi một ván (có cả override) rồi đọc lại từng nước, và từ chối file có override hỏng
+#include "Check.h"
+#include "Replay.h"
+#include "Engine.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+    struct Played {
+        std::vector<Engine::Board> boards;   // boards[i]: sau i nước đi
+        std::vector<int> scores;
+        std::vector<int> moves;
+        uint32_t overrides;
+    };
+
+    // Ván ngẫu nhiên; cứ 7 nước lại đặt ô mới ở ô trống cuối cùng thay vì theo RNG (như chế độ khó)
+    Played play(Replay::Writer& writer, uint64_t seed, uint32_t keyframeInterval) {
+        Played played;
+        played.overrides = 0;
+        Engine::Rng rng(seed);
+        Engine::Rng chooser(seed ^ 0x5555);
+        Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+        int score = 0;
+        writer.begin(seed, board, rng.state, score, keyframeInterval);
+        played.boards.push_back(board);
+        played.scores.push_back(score);
+        while (Engine::canMove(board)) {
+            int move = chooser.below(Engine::MOVE_COUNT);
+            int delta = 0;
+            Engine::Board afterstate = Engine::move(board, move, delta);
+            if (afterstate == board) continue;
+            Engine::Board spawned = Engine::spawnRandom(afterstate, rng);
+            if (played.moves.size() % 7 == 3) {
+                int last = Engine::emptyCount(afterstate) - 1;
+                Engine::Board forced = Engine::spawnAt(afterstate, last, 2);
+                if (forced != spawned) played.overrides++;
+                spawned = forced;
+            }
+            board = spawned;
+            score += delta;
+            CHECK(writer.addMove(move, board));
+            played.boards.push_back(board);
+            played.scores.push_back(score);
+            played.moves.push_back(move);
+        }
+        return played;
+    }
+
+    void roundTrip(const Check::TempDir& temp, uint32_t keyframeInterval) {
+        std::string path = temp.path("game.rpl");
+        Replay::Writer writer;
+        Played played = play(writer, 42 + keyframeInterval, keyframeInterval);
+        CHECK(played.overrides > 0);
+        CHECK(writer.save(path));
+
+        Replay::Reader reader;
+        CHECK(reader.load(path));
+        CHECK(reader.moveCount() == played.moves.size());
+        CHECK(reader.overrideCount() == played.overrides);
+        CHECK(reader.finalScore() == played.scores.back());
+        for (uint32_t i = 0; i < reader.moveCount(); i++) CHECK(reader.moveAt(i) == played.moves[i]);
+        // Tua ngược từ cuối để không dựa vào thứ tự đọc
+        for (uint32_t i = reader.moveCount() + 1; i-- > 0;) {
+            Engine::Board board = 0;
+            int score = -1;
+            CHECK(reader.stateAt(i, board, score));
+            CHECK(board == played.boards[i]);
+            CHECK(score == played.scores[i]);
+        }
+    }
+
+    // Ghi đè một byte của override đầu tiên rồi đọc lại
+    bool loadsWithOverrideByte(const Check::TempDir& temp, size_t field, uint8_t value) {
+        std::string path = temp.path("corrupt.rpl");
+        Replay::Writer writer;
+        play(writer, 7, Replay::DEFAULT_KEYFRAME_INTERVAL);
+        CHECK(writer.save(path));
+        Replay::Reader reader;
+        CHECK(reader.load(path));
+        if (reader.overrideCount() < 2) return false;
+
+        size_t moveBytes = (((size_t)reader.moveCount() + 3) / 4 + 7) & ~(size_t)7;
+        long at = (long)(sizeof(Replay::Header) + moveBytes + field);
+        FILE* file = std::fopen(path.c_str(), "r+b");
+        CHECK(file != nullptr);
+        if (!file) return false;
+        std::fseek(file, at, SEEK_SET);
+        std::fputc(value, file);
+        std::fclose(file);
+        return reader.load(path);
+    }
+}
+
+int main() {
+    Check::TempDir temp;
+    roundTrip(temp, Replay::DEFAULT_KEYFRAME_INTERVAL);
+    roundTrip(temp, 5);
+
+    // Byte 4: cell, byte 5: exponent, byte 0: move (override thứ hai lùi về trước override đầu)
+    const size_t CELL = 4;
+    const size_t EXPONENT = 5;
+    CHECK(loadsWithOverrideByte(temp, CELL, 3));
+    CHECK(!loadsWithOverrideByte(temp, CELL, 16));
+    CHECK(!loadsWithOverrideByte(temp, CELL, 200));
+    CHECK(!loadsWithOverrideByte(temp, EXPONENT, 0));
+    CHECK(!loadsWithOverrideByte(temp, EXPONENT, Engine::MAX_EXPONENT + 1));
+    CHECK(!loadsWithOverrideByte(temp, sizeof(Replay::Override), 0));
+    return Check::result("replay");
+}
@@ -0,0 +1,113 @@
+// 2048-server: chạy binary thật, gửi một ván mới và hàng nghìn nước đi trong một lần ghi
+// (pipeline) rồi kiểm tra mọi yêu cầu đều được trả lời và các bàn cờ khớp luật Engine
+#include "Check.h"
+#include "ServerProtocol.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+namespace {
+    const int MOVES = 2000;
+
+    int connectLocal(int port) {
+        // Server vừa được fork: thử lại tới khi cổng mở
+        for (int attempt = 0; attempt < 200; attempt++) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address;
+            std::memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons((uint16_t)port);
+            if (connect(fd, (sockaddr*)&address, sizeof(address)) == 0) return fd;
+            close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return -1;
+    }
+
+    void pipelined(int port) {
+        int fd = connectLocal(port);
+        CHECK(fd >= 0);
+        if (fd < 0) return;
+
+        // Nhiều nước hơn bộ đệm ra của một kết nối: server phải tiếp tục đọc sau khi xả đệm
+        std::vector<uint8_t> requests(ServerProtocol::NEW_GAME_SIZE + MOVES);
+        ServerProtocol::putNewGame(requests.data(), 42);
+        for (int i = 0; i < MOVES; i++) requests[ServerProtocol::NEW_GAME_SIZE + i] = (uint8_t)(i % Engine::MOVE_COUNT);
+        size_t sent = 0;
+        while (sent < requests.size()) {
+            ssize_t count = send(fd, requests.data() + sent, requests.size() - sent, MSG_NOSIGNAL);
+            if (count <= 0) break;
+            sent += (size_t)count;
+        }
+        CHECK(sent == requests.size());
+
+        std::vector<uint8_t> replies((MOVES + 1) * ServerProtocol::RESPONSE_SIZE);
+        size_t received = 0;
+        pollfd connection = {fd, POLLIN, 0};
+        while (received < replies.size() && poll(&connection, 1, 2000) > 0) {
+            ssize_t count = recv(fd, replies.data() + received, replies.size() - received, 0);
+            if (count <= 0) break;
+            received += (size_t)count;
+        }
+        close(fd);
+        CHECK(received == replies.size());
+
+        int status = 0;
+        Engine::Board board = 0;
+        uint32_t score = 0;
+        ServerProtocol::getResponse(replies.data(), status, board, score);
+        CHECK(status == ServerProtocol::STATUS_NEW_GAME);
+        CHECK(Engine::emptyCount(board) == 14 && score == 0);
+        for (int i = 0; i < MOVES && (size_t)(i + 2) * ServerProtocol::RESPONSE_SIZE <= received; i++) {
+            Engine::Board next = 0;
+            uint32_t nextScore = 0;
+            ServerProtocol::getResponse(replies.data() + (i + 1) * ServerProtocol::RESPONSE_SIZE, status, next, nextScore);
+            int delta = 0;
+            Engine::Board afterstate = Engine::move(board, i % Engine::MOVE_COUNT, delta);
+            if (status == ServerProtocol::STATUS_MOVED || (status == ServerProtocol::STATUS_GAME_OVER && afterstate != board)) {
+                // Đúng một ô mới 2 hoặc 4 trên afterstate
+                Engine::Board diff = next ^ afterstate;
+                int cell = diff ? __builtin_ctzll(diff) / 4 : 0;
+                int exponent = Engine::getCell(next, cell);
+                CHECK(afterstate != board && diff != 0 && (diff >> (4 * cell)) <= 0xF && Engine::getCell(afterstate, cell) == 0);
+                CHECK(exponent == 1 || exponent == 2);
+                CHECK(nextScore == score + (uint32_t)delta);
+            } else {
+                CHECK(next == board && nextScore == score);
+            }
+            board = next;
+            score = nextScore;
+        }
+    }
+}
+
+int main() {
+    int port = 30000 + (int)(getpid() % 20000);
+    std::string portText = std::to_string(port);
+    pid_t server = fork();
+    if (server == 0) {
+        execl("./2048-server", "2048-server", "--port", portText.c_str(), "--threads", "1", "--seconds", "30", "--no-pin",
+              (char*)nullptr);
+        std::perror("./2048-server");
+        _exit(127);
+    }
+    CHECK(server > 0);
+    if (server > 0) {
+        pipelined(port);
+        kill(server, SIGTERM);
+        int status = 0;
+        waitpid(server, &status, 0);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    return Check::result("server");
+}
@@ -0,0 +1,99 @@
+// Tablebase: giải bàn 3x3 nhỏ, mmap lại và tra được; header có kích thước, cap hay số vị trí
+// không hợp lệ bị từ chối trước khi tra
+#include "Check.h"
+#include "Tablebase.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace {
+    const int SIZE = 3;
+    const int CAP = 3;  // 8: giải trong chưa tới một giây
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& path, const std::string& data) {
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+    }
+
+    void solveAndQuery(const std::string& path) {
+        std::ostringstream progress;
+        CHECK(Tablebase::solve(SIZE, CAP, 2, path, progress));
+
+        Tablebase table;
+        CHECK(table.map(path));
+        CHECK(table.isReady());
+        CHECK(table.size() == SIZE && table.capExponent() == CAP);
+        CHECK(table.positions() > 0);
+        CHECK(table.startExpectation() > 0.0);
+
+        // Mọi bàn cờ khởi đầu đều có trong bảng, kể cả sau phép đối xứng
+        Engine::Board start = Engine::setCell(Engine::setCell(0, 0, 1), 4, 2);
+        Engine::Board mirrored = Engine::setCell(Engine::setCell(0, 2, 1), 4, 2);
+        float value = -1.0f;
+        float mirroredValue = -2.0f;
+        CHECK(table.value(start, value));
+        CHECK(table.value(mirrored, mirroredValue));
+        CHECK(value > 0.0f && value == mirroredValue);
+
+        // Giá trị là kỳ vọng của nước tốt nhất
+        double expectations[Engine::MOVE_COUNT];
+        int move = table.bestMove(start, expectations);
+        CHECK(move >= 0);
+        CHECK(move >= 0 && (float)expectations[move] == value);
+
+        // Ô vượt cap không đạt được
+        CHECK(!table.value(Engine::setCell(start, 8, CAP + 1), value));
+    }
+
+    // Ghi đè một trường 4 hoặc 8 byte của header rồi mmap lại
+    bool mapsWithField(const std::string& good, const std::string& path, size_t offset, uint64_t field, size_t bytes) {
+        std::string data = good;
+        std::memcpy(&data[offset], &field, bytes);
+        writeFile(path, data);
+        Tablebase table;
+        return table.map(path);
+    }
+
+    void rejects(const std::string& goodPath, const std::string& path) {
+        std::string good = readFile(goodPath);
+        // magic 8, version 4, boardSize 4, capExponent 4, reserved 4, slotCount 8, entryCount 8
+        const size_t BOARD_SIZE = 12;
+        const size_t CAP_EXPONENT = 16;
+        const size_t SLOT_COUNT = 24;
+        const size_t ENTRY_COUNT = 32;
+        uint64_t slotCount = 0;
+        std::memcpy(&slotCount, &good[SLOT_COUNT], sizeof(slotCount));
+
+        CHECK(mapsWithField(good, path, BOARD_SIZE, 4, 4));
+        CHECK(!mapsWithField(good, path, BOARD_SIZE, 0, 4));
+        CHECK(!mapsWithField(good, path, BOARD_SIZE, 5, 4));
+        CHECK(!mapsWithField(good, path, BOARD_SIZE, 1000, 4));
+        CHECK(!mapsWithField(good, path, CAP_EXPONENT, 1, 4));
+        CHECK(!mapsWithField(good, path, CAP_EXPONENT, Engine::MAX_EXPONENT + 1, 4));
+        CHECK(!mapsWithField(good, path, ENTRY_COUNT, 0, 8));
+        CHECK(!mapsWithField(good, path, ENTRY_COUNT, slotCount, 8));
+        CHECK(!mapsWithField(good, path, SLOT_COUNT, slotCount * 2, 8));
+        CHECK(!mapsWithField(good, path, SLOT_COUNT, (uint64_t)1 << 62, 8));
+
+        writeFile(path, good.substr(0, good.size() - 4));
+        Tablebase table;
+        CHECK(!table.map(path));
+        CHECK(!table.isReady());
+    }
+}
+
+int main() {
+    Check::TempDir temp;
+    std::string path = temp.path("small.tb");
+    solveAndQuery(path);
+    rejects(path, temp.path("corrupt.tb"));
+    return Check::result("tablebase");
+}
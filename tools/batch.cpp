@@ -0,0 +1,96 @@
+// 2048-batch: đo thông lượng BatchEngine, mỗi luồng chạy một lô lane với nước đi ngẫu nhiên.
+#include "BatchEngine.h"
+#include "EngineSimd.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Số bảng nước đi ngẫu nhiên sinh trước, dùng xoay vòng để không đo chi phí RNG của người gọi
+    const int MOVE_PATTERNS = 64;
+
+    struct WorkerResult {
+        uint64_t steps;
+        uint64_t games;
+    };
+
+    void runWorker(size_t laneCount, int stepCount, uint64_t seed, WorkerResult& result) {
+        BatchEngine batch(laneCount);
+        batch.reset(seed);
+
+        Engine::Rng rng(seed ^ 0x2048);
+        std::vector<int> moves(laneCount * MOVE_PATTERNS);
+        for (size_t i = 0; i < moves.size(); i++) {
+            moves[i] = rng.below(Engine::MOVE_COUNT);
+        }
+        for (int s = 0; s < stepCount; s++) {
+            batch.step(&moves[(s % MOVE_PATTERNS) * laneCount]);
+        }
+        result.steps = batch.stepCount();
+        result.games = batch.gamesFinished();
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--lanes N] [--steps S] [--threads T] [--seed X]\n"
+                  << "       [--kernel scalar|ssse3|avx2]\n"
+                  << "Each thread steps its own batch of N lanes S times with random moves.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t laneCount = 4096;
+    int stepCount = 2000;
+    uint64_t seed = 2048;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--lanes") == 0 && hasValue) {
+            laneCount = (size_t)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--steps") == 0 && hasValue) {
+            stepCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = std::strtoull(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--kernel") == 0 && hasValue) {
+            EngineSimd::Kernel kernel;
+            if (!EngineSimd::parseKernel(argv[++i], kernel) || !EngineSimd::setKernel(kernel)) {
+                std::cerr << "Kernel not available: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<WorkerResult> results(threadCount);
+    std::vector<std::thread> workers;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread(runWorker, laneCount, stepCount, seed + (uint64_t)t, std::ref(results[t])));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    uint64_t steps = 0;
+    uint64_t games = 0;
+    for (int t = 0; t < threadCount; t++) {
+        steps += results[t].steps;
+        games += results[t].games;
+    }
+    std::cout << threadCount << " threads x " << laneCount << " lanes x " << stepCount << " steps, "
+              << EngineSimd::kernelName(EngineSimd::activeKernel()) << " kernel" << std::endl;
+    std::cout << "board steps: " << steps << ", games finished: " << games << std::endl;
+    std::cout << "seconds: " << std::fixed << std::setprecision(3) << seconds
+              << ", Msteps/s: " << std::setprecision(2) << (seconds > 0 ? steps / seconds / 1e6 : 0.0) << std::endl;
+    return 0;
+}
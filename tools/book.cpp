@@ -0,0 +1,227 @@
+// 2048-book: dựng opening book. Liệt kê đầy đủ mọi vị trí tới độ sâu D từ mọi bàn cờ
+// khởi đầu (2 ô ngẫu nhiên như initializeBoard), thêm các vị trí đầu ván lặp lại trong
+// các ván mẫu, rồi tìm nước đi tốt nhất cho từng vị trí song song trên mọi nhân.
+#include "OpeningBook.h"
+#include "PositionTable.h"
+#include "Strategies.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct BuildConfig {
+        std::string search;
+        const NTupleNetwork* network;
+    };
+
+    void addCanonical(PositionTable& table, Engine::Board board, uint64_t count) {
+        int symmetry;
+        table.add(OpeningBook::canonical(board, symmetry), count);
+    }
+
+    // Tầng 0: mọi cặp ô khởi đầu với giá trị 2/4
+    void startPositions(PositionTable& positions) {
+        for (int a = 0; a < Engine::CELL_COUNT; a++) {
+            for (int b = a + 1; b < Engine::CELL_COUNT; b++) {
+                for (int ea = 1; ea <= 2; ea++) {
+                    for (int eb = 1; eb <= 2; eb++) {
+                        addCanonical(positions, Engine::setCell(Engine::setCell(0, a, ea), b, eb), 1);
+                    }
+                }
+            }
+        }
+    }
+
+    void enumerate(PositionTable& all, int depth) {
+        PositionTable layer;
+        startPositions(layer);
+        std::vector<PositionTable::Entry> current;
+        for (int d = 0; d <= depth; d++) {
+            current.clear();
+            layer.appendTo(current);
+            layer.clear();
+            for (size_t p = 0; p < current.size(); p++) {
+                all.add(current[p].board, 1);
+                if (d == depth) continue;
+                for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+                    Engine::Board moved = Engine::move(current[p].board, m);
+                    if (moved == current[p].board) continue;
+                    uint64_t empties = Engine::zeroNibbles(moved);
+                    while (empties) {
+                        uint64_t cell = empties & (~empties + 1);
+                        empties &= empties - 1;
+                        addCanonical(layer, moved | cell, 1);
+                        addCanonical(layer, moved | (cell * 2), 1);
+                    }
+                }
+            }
+            std::cout << "depth " << d << ": " << current.size() << " positions, " << all.size() << " total" << std::endl;
+        }
+    }
+
+    // Các ván mẫu do chính chiến lược tìm kiếm chơi; vị trí trong plies nước đầu được đếm
+    void sample(PositionTable& counts, const BuildConfig& config, uint64_t games, int plies) {
+        std::string error;
+        for (uint64_t g = 0; g < games; g++) {
+            Advisor* advisor = Strategies::create(config.search, config.network, g, error);
+            Engine::Rng rng(g + 1);
+            Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+            for (int ply = 0; ply < plies; ply++) {
+                addCanonical(counts, board, 1);
+                int move = advisor->chooseMove(board);
+                if (move < 0) break;
+                board = Engine::spawnRandom(Engine::move(board, move), rng);
+            }
+            delete advisor;
+        }
+    }
+
+    void solveWorker(const BuildConfig& config, const std::vector<PositionTable::Entry>& positions,
+                     std::atomic<size_t>& next, std::vector<OpeningBook::Entry>& entries) {
+        std::string error;
+        Advisor* advisor = Strategies::create(config.search, config.network, 0, error);
+        size_t index;
+        while ((index = next.fetch_add(1)) < positions.size()) {
+            Engine::Board board = positions[index].board;
+            OpeningBook::Entry& entry = entries[index];
+            std::memset(&entry, 0, sizeof(entry));
+            int move = advisor->chooseMove(board);
+            if (move < 0) continue;  // hết nước: không đưa vào book
+            entry.board = board;
+            entry.move = (uint8_t)move;
+            entry.value = (float)advisor->lastValue();
+        }
+        delete advisor;
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--depth D] [--sample-games N] [--sample-plies P] [--min-count K]\n"
+                  << "       [--search S] [--threads T] [--weights FILE] [--out FILE]\n"
+                  << "       " << program << " --lookup v0,v1,...,v15 [--out FILE]\n"
+                  << "Builds an opening book (default opening.book) solved with strategy S (default expectimax:3).\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BuildConfig config;
+    config.search = "expectimax:3";
+    config.network = nullptr;
+    int depth = 3;
+    uint64_t sampleGames = 0;
+    int samplePlies = 40;
+    uint64_t minCount = 2;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    std::string weightsPath;
+    std::string outPath = "opening.book";
+    const char* lookupText = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--depth") == 0 && hasValue) {
+            depth = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--sample-games") == 0 && hasValue) {
+            sampleGames = std::strtoull(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--sample-plies") == 0 && hasValue) {
+            samplePlies = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--min-count") == 0 && hasValue) {
+            minCount = std::max<uint64_t>(1, std::strtoull(argv[++i], NULL, 10));
+        } else if (std::strcmp(argv[i], "--search") == 0 && hasValue) {
+            config.search = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--weights") == 0 && hasValue) {
+            weightsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--lookup") == 0 && hasValue) {
+            lookupText = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (lookupText) {
+        std::vector<std::vector<int> > grid(4, std::vector<int>(4, 0));
+        int index = 0;
+        for (const char* p = lookupText; *p && index < Engine::CELL_COUNT; index++) {
+            grid[index / 4][index % 4] = std::atoi(p);
+            p = std::strchr(p, ',');
+            if (!p) break;
+            p++;
+        }
+        OpeningBook book;
+        if (!book.map(outPath)) {
+            std::cerr << "Cannot map " << outPath << std::endl;
+            return 1;
+        }
+        int move;
+        float value;
+        if (!book.lookup(Engine::fromGrid(grid), move, value)) {
+            std::cout << "not in book" << std::endl;
+            return 1;
+        }
+        std::cout << Engine::moveName(move) << " (value " << value << ")" << std::endl;
+        return 0;
+    }
+
+    NTupleNetwork network;
+    if (!weightsPath.empty()) {
+        if (!network.map(weightsPath)) {
+            std::cerr << "Cannot load n-tuple weights from " << weightsPath << std::endl;
+            return 1;
+        }
+        config.network = &network;
+    }
+    std::string error;
+    Advisor* probe = Strategies::create(config.search, config.network, 0, error);
+    if (!probe) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    delete probe;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    PositionTable positions;
+    enumerate(positions, depth);
+    if (sampleGames > 0) {
+        PositionTable counts;
+        sample(counts, config, sampleGames, samplePlies);
+        std::vector<PositionTable::Entry> sampled;
+        counts.appendTo(sampled);
+        size_t added = 0;
+        for (size_t i = 0; i < sampled.size(); i++) {
+            if (sampled[i].value >= minCount && positions.add(sampled[i].board, 1)) added++;
+        }
+        std::cout << "sampled " << sampled.size() << " positions from " << sampleGames << " games, added " << added
+                  << " seen at least " << minCount << " times" << std::endl;
+    }
+
+    std::vector<PositionTable::Entry> list;
+    positions.appendTo(list);
+    std::vector<OpeningBook::Entry> entries(list.size());
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread(solveWorker, std::cref(config), std::cref(list), std::ref(next), std::ref(entries)));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+
+    std::vector<OpeningBook::Entry> solved;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].board != 0) solved.push_back(entries[i]);
+    }
+    if (!OpeningBook::write(outPath, solved)) return 1;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Wrote " << solved.size() << " positions to " << outPath << " in " << std::fixed << std::setprecision(1)
+              << seconds << " s" << std::endl;
+    return 0;
+}
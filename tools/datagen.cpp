@@ -0,0 +1,184 @@
+// 2048-datagen: sinh dữ liệu huấn luyện (bàn cờ, nước đi, điểm gộp, điểm cuối ván) từ các
+// ván do một chiến lược chơi. Mỗi luồng ghi chuỗi shard riêng, không có khoá chung.
+#include "Strategies.h"
+#include "TrainingData.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct GenerateConfig {
+        std::string strategy;
+        std::string prefix;
+        uint64_t games;
+        uint64_t firstSeed;
+        uint64_t shardRecords;
+        const NTupleNetwork* network;
+    };
+
+    struct WorkerResult {
+        bool ok;
+        uint64_t records;
+        int shards;
+    };
+
+    void generateWorker(const GenerateConfig& config, int worker, std::atomic<uint64_t>& nextGame, WorkerResult& result) {
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), "-t%02d", worker);
+        TrainingData::ShardWriter writer;
+        result.ok = writer.open(config.prefix + suffix, config.strategy, config.shardRecords);
+
+        std::vector<TrainingData::Record> records;
+        uint64_t index;
+        while (result.ok && (index = nextGame.fetch_add(1)) < config.games) {
+            uint64_t seed = config.firstSeed + index;
+            std::string error;
+            Advisor* advisor = Strategies::create(config.strategy, config.network, seed, error);
+            Engine::Rng rng(seed);
+            Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+            uint32_t score = 0;
+            records.clear();
+            while (true) {
+                int move = advisor->chooseMove(board);
+                if (move < 0) break;
+                int delta = 0;
+                Engine::Board moved = Engine::move(board, move, delta);
+                if (moved == board) break;
+                TrainingData::Record record;
+                std::memset(&record, 0, sizeof(record));
+                record.board = board;
+                record.scoreDelta = (uint32_t)delta;
+                record.moveNumber = (uint16_t)std::min<size_t>(records.size(), 0xFFFF);
+                record.move = (uint8_t)move;
+                records.push_back(record);
+                score += delta;
+                board = Engine::spawnRandom(moved, rng);
+            }
+            delete advisor;
+            // Điểm cuối chỉ biết khi ván kết thúc
+            for (size_t i = 0; i < records.size(); i++) {
+                records[i].finalScore = score;
+            }
+            result.ok = writer.appendGame(records.data(), records.size());
+        }
+        result.ok = writer.close() && result.ok;
+        result.records = writer.totalRecords();
+        result.shards = writer.shardCount();
+    }
+
+    int inspect(const char* path, int samples) {
+        TrainingData::Shard shard;
+        if (!shard.map(path)) return 1;
+        const TrainingData::ShardHeader& header = shard.header();
+        std::cout << path << ": " << header.recordCount << " records, " << header.gameCount << " games, strategy "
+                  << header.strategy << std::endl;
+        // Lấy mẫu ngẫu nhiên trực tiếp trên vùng mmap
+        Engine::Rng rng(std::chrono::steady_clock::now().time_since_epoch().count());
+        for (int i = 0; i < samples && shard.size() > 0; i++) {
+            uint64_t index = rng.next() % shard.size();
+            const TrainingData::Record& record = shard[index];
+            std::cout << "#" << index << " board " << std::hex << std::setw(16) << std::setfill('0') << record.board
+                      << std::dec << std::setfill(' ') << " move " << Engine::moveName(record.move) << " delta "
+                      << record.scoreDelta << " final " << record.finalScore << " game " << record.game << " ply "
+                      << record.moveNumber << std::endl;
+        }
+        return 0;
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--strategy S] [--games N] [--first-seed X] [--threads T]\n"
+                  << "       [--out PREFIX] [--shard-records N] [--weights FILE]\n"
+                  << "       " << program << " --inspect SHARD [--samples K]\n"
+                  << "Writes PREFIX-tNN-NNNNN.bin shards of fixed 24-byte records, one shard series per thread.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    GenerateConfig config;
+    config.strategy = "expectimax:1";
+    config.prefix = "train";
+    config.games = 1000;
+    config.firstSeed = 1;
+    config.shardRecords = 1 << 22;
+    config.network = nullptr;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    std::string weightsPath;
+    const char* inspectPath = nullptr;
+    int samples = 5;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--strategy") == 0 && hasValue) {
+            config.strategy = argv[++i];
+        } else if (std::strcmp(argv[i], "--games") == 0 && hasValue) {
+            config.games = std::strtoull(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--first-seed") == 0 && hasValue) {
+            config.firstSeed = std::strtoull(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            config.prefix = argv[++i];
+        } else if (std::strcmp(argv[i], "--shard-records") == 0 && hasValue) {
+            config.shardRecords = std::max<uint64_t>(1, std::strtoull(argv[++i], NULL, 10));
+        } else if (std::strcmp(argv[i], "--weights") == 0 && hasValue) {
+            weightsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--inspect") == 0 && hasValue) {
+            inspectPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--samples") == 0 && hasValue) {
+            samples = std::atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (inspectPath) return inspect(inspectPath, samples);
+
+    NTupleNetwork network;
+    if (!weightsPath.empty()) {
+        if (!network.map(weightsPath)) {
+            std::cerr << "Cannot load n-tuple weights from " << weightsPath << std::endl;
+            return 1;
+        }
+        config.network = &network;
+    }
+    std::string error;
+    Advisor* probe = Strategies::create(config.strategy, config.network, 0, error);
+    if (!probe) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    delete probe;
+
+    std::atomic<uint64_t> nextGame(0);
+    std::vector<WorkerResult> results(threadCount);
+    std::vector<std::thread> workers;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread(generateWorker, std::cref(config), t, std::ref(nextGame), std::ref(results[t])));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    bool ok = true;
+    uint64_t records = 0;
+    int shards = 0;
+    for (int t = 0; t < threadCount; t++) {
+        ok = ok && results[t].ok;
+        records += results[t].records;
+        shards += results[t].shards;
+    }
+    double megabytes = records * sizeof(TrainingData::Record) / (1024.0 * 1024.0);
+    std::cout << config.games << " games (" << config.strategy << ") -> " << records << " records in " << shards
+              << " shards, " << std::fixed << std::setprecision(2) << seconds << " s, "
+              << std::setprecision(0) << (seconds > 0 ? records / seconds : 0.0) << " records/s, "
+              << std::setprecision(1) << (seconds > 0 ? megabytes / seconds : 0.0) << " MB/s" << std::endl;
+    return ok ? 0 : 1;
+}
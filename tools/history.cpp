@@ -0,0 +1,161 @@
+// 2048-history: in thống kê của history.db giống màn Statistics trong game, và đo thời gian
+// truy vấn. --fill N cho một chiến lược chơi N ván rồi ghi vào lịch sử, để thử với
+// hàng trăm nghìn ván.
+#include "GameHistory.h"
+#include "Strategies.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--file FILE] [--mode all|single|hard|local|cpu|net]\n"
+                  << "       [--fill N] [--strategy S] [--seed N]\n"
+                  << "Prints the game history statistics (default history.db). --fill plays N games with\n"
+                  << "strategy S (default corner) and appends them as --mode before querying.\n";
+    }
+
+    bool parseMode(const char* text, int& mode) {
+        const char* names[] = {"single", "hard", "local", "cpu", "net"};
+        for (int m = 0; m < GameHistory::MODE_COUNT; m++) {
+            if (std::strcmp(text, names[m]) == 0) {
+                mode = m;
+                return true;
+            }
+        }
+        if (std::strcmp(text, "all") == 0) {
+            mode = -1;
+            return true;
+        }
+        return false;
+    }
+
+    GameHistory::Record playGame(Advisor& advisor, uint64_t seed, int mode) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        Engine::Rng rng(seed);
+        Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+        GameHistory::Record record;
+        std::memset(&record, 0, sizeof(record));
+        while (true) {
+            int move = advisor.chooseMove(board);
+            if (move < 0) break;
+            int delta = 0;
+            Engine::Board moved = Engine::move(board, move, delta);
+            if (moved == board) break;
+            record.score += delta;
+            record.moves++;
+            board = Engine::spawnRandom(moved, rng);
+        }
+        record.timestamp = (int64_t)std::time(nullptr);
+        record.seed = seed;
+        record.durationMs = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        record.mode = (uint8_t)(mode < 0 ? GameHistory::MODE_SINGLE : mode);
+        record.player = 1;
+        record.maxTile = (uint8_t)Engine::maxExponent(board);
+        return record;
+    }
+
+    void printStats(const GameHistory::Stats& stats) {
+        const GameHistory::Summary& total = stats.total;
+        std::cout << total.count << " games (" << stats.records << " in file, " << stats.blocksRead << " index blocks)\n";
+        if (total.count == 0) return;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "best " << total.bestScore << "  average " << total.averageScore()
+                  << "  last " << stats.recentCount << " average " << stats.recentAverage
+                  << "  moves/game " << (double)total.moveSum / total.count
+                  << "  seconds/game " << total.durationSum / 1000.0 / total.count << "\n";
+
+        std::cout << "score histogram:\n";
+        uint32_t peak = *std::max_element(total.scoreBuckets, total.scoreBuckets + GameHistory::SCORE_BUCKETS);
+        for (int b = 0; b < GameHistory::SCORE_BUCKETS; b++) {
+            if (total.scoreBuckets[b] == 0) continue;
+            std::cout << "  " << std::setw(8) << (b == 0 ? 0 : 1 << b) << "+ " << std::setw(9) << total.scoreBuckets[b]
+                      << " " << std::string(peak ? 50 * (size_t)total.scoreBuckets[b] / peak : 0, '#') << "\n";
+        }
+        std::cout << "max tile reached:";
+        for (int e = 7; e < GameHistory::TILE_BUCKETS; e++) {
+            double rate = total.reachRate(e);
+            if (rate == 0.0) break;
+            std::cout << "  " << (1 << e) << " " << rate * 100.0 << "%";
+        }
+        std::cout << "\ntrend (average score, oldest first):";
+        for (int p = 0; p < stats.trendPoints; p++) std::cout << " " << (int)stats.trend[p];
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = "history.db";
+    int mode = -1;
+    long fill = 0;
+    std::string strategy = "corner";
+    uint64_t seed = (uint64_t)std::time(nullptr);
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--file") == 0 && hasValue) {
+            path = argv[++i];
+        } else if (std::strcmp(argv[i], "--mode") == 0 && hasValue) {
+            if (!parseMode(argv[++i], mode)) {
+                std::cerr << "Unknown mode: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--fill") == 0 && hasValue) {
+            fill = std::max(0L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--strategy") == 0 && hasValue) {
+            strategy = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    GameHistory::Database database;
+    if (!database.open(path)) return 1;
+
+    if (fill > 0) {
+        std::string error;
+        Advisor* advisor = Strategies::create(strategy, nullptr, seed, error);
+        if (!advisor) {
+            std::cerr << "Cannot create strategy: " << error << std::endl;
+            return 1;
+        }
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        double appendSeconds = 0.0;
+        for (long g = 0; g < fill; g++) {
+            GameHistory::Record record = playGame(*advisor, seed + (uint64_t)g, mode);
+            std::chrono::steady_clock::time_point appendBegin = std::chrono::steady_clock::now();
+            if (!database.append(record)) return 1;
+            appendSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - appendBegin).count();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "Appended " << fill << " " << strategy << " games in " << std::fixed << std::setprecision(2) << seconds
+                  << " s (" << std::setprecision(2) << appendSeconds * 1e6 / fill << " us per append)" << std::endl;
+        delete advisor;
+    }
+
+    uint32_t mask = mode < 0 ? GameHistory::ALL_MODES : 1u << mode;
+    GameHistory::Stats stats;
+    // Lần đầu có thể phải đọc trang từ đĩa; lấy lần nhanh nhất trong vài lần
+    double bestMs = 1e9;
+    for (int run = 0; run < 5; run++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        if (!database.query(mask, stats)) {
+            std::cerr << "Cannot query " << path << std::endl;
+            return 1;
+        }
+        bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    }
+    std::cout << "History " << path << " (" << (mode < 0 ? "all modes" : GameHistory::modeName(mode)) << "), query "
+              << std::fixed << std::setprecision(3) << bestMs << " ms" << std::endl;
+    printStats(stats);
+    return 0;
+}
@@ -0,0 +1,133 @@
+// 2048-leaderboard: in bảng điểm cao (leaderboard.dat của game) và đo tốc độ treap.
+// --bench M thêm M điểm ngẫu nhiên, đối chiếu hạng với std::multiset rồi mở lại file
+// để kiểm tra mọi lần ghi tại chỗ khớp với bộ nhớ.
+#include "GameHistory.h"
+#include "Leaderboard.h"
+#include "Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--file FILE] [--size N] [--top K] [--bench M] [--seed N]\n"
+                  << "Prints the top K entries of a leaderboard (default leaderboard.dat, N = 10). --bench inserts\n"
+                  << "M random scores, checks every rank against a reference and reports ns per operation.\n";
+    }
+
+    double nanosSince(std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    bool bench(Leaderboard& board, const std::string& path, uint32_t capacity, long count, uint64_t seed) {
+        Engine::Rng rng(seed);
+        std::multiset<int32_t, std::greater<int32_t> > reference;
+        for (uint32_t i = 0; i < board.size(); i++) reference.insert(board.at(i).score);
+
+        Leaderboard::Entry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.mode = GameHistory::MODE_SINGLE;
+        entry.player = 1;
+        entry.timestamp = (int64_t)std::time(nullptr);
+        long accepted = 0;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (long i = 0; i < count; i++) {
+            entry.score = (int32_t)rng.below(200000);
+            entry.maxTile = (uint8_t)Engine::maxExponent(rng.next());
+            if (board.insert(entry) > 0) accepted++;
+            if (reference.size() < capacity || entry.score > *reference.rbegin()) {
+                reference.insert(entry.score);
+                if (reference.size() > capacity) reference.erase(std::prev(reference.end()));
+            }
+        }
+        double insertNs = nanosSince(begin) / count;
+
+        const int PROBES = 1000000;
+        uint64_t checksum = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < PROBES; i++) checksum += board.rankOf((int32_t)rng.below(200000));
+        double rankNs = nanosSince(begin) / PROBES;
+
+        std::cout << "inserted " << count << " scores (" << accepted << " entered), " << std::fixed << std::setprecision(1)
+                  << insertNs << " ns per insert, " << rankNs << " ns per rank lookup (checksum " << checksum << ")\n";
+
+        bool ok = reference.size() == board.size();
+        std::multiset<int32_t, std::greater<int32_t> >::const_iterator it = reference.begin();
+        for (uint32_t i = 0; ok && i < board.size(); i++, ++it) ok = board.at(i).score == *it;
+        for (int i = 0; ok && i < 200; i++) {
+            int32_t score = (int32_t)rng.below(200000);
+            ok = board.rankOf(score) == 1 + (uint32_t)std::distance(reference.begin(), reference.lower_bound(score));
+        }
+        if (!ok) {
+            std::cerr << "Leaderboard differs from the reference" << std::endl;
+            return false;
+        }
+
+        // Mở lại: nội dung file phải cho đúng bảng đang có trong bộ nhớ
+        Leaderboard reopened;
+        if (!reopened.open(path, capacity)) return false;
+        ok = reopened.size() == board.size();
+        for (uint32_t i = 0; ok && i < board.size(); i++) {
+            ok = std::memcmp(&reopened.at(i), &board.at(i), sizeof(Leaderboard::Entry)) == 0;
+        }
+        struct stat info;
+        stat(path.c_str(), &info);
+        std::cout << "reference and reopened file match (" << board.size() << " entries, "
+                  << (long long)info.st_size << " bytes on disk)\n";
+        if (!ok) std::cerr << "Reopened leaderboard differs" << std::endl;
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = "leaderboard.dat";
+    long size = 10;
+    long top = 10;
+    long benchCount = 0;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--file") == 0 && hasValue) {
+            path = argv[++i];
+        } else if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+            size = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--top") == 0 && hasValue) {
+            top = std::max(0L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--bench") == 0 && hasValue) {
+            benchCount = std::max(0L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Leaderboard board;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    if (!board.open(path, (uint32_t)size)) return 1;
+    std::cout << "Loaded " << board.size() << " / " << board.capacity() << " entries from " << path << " in "
+              << std::fixed << std::setprecision(2) << nanosSince(begin) / 1e6 << " ms\n";
+    if (benchCount > 0 && !bench(board, path, (uint32_t)size, benchCount, seed)) return 1;
+
+    for (uint32_t i = 0; i < board.size() && i < (uint32_t)top; i++) {
+        const Leaderboard::Entry& entry = board.at(i);
+        char when[32];
+        time_t timestamp = (time_t)entry.timestamp;
+        std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M", std::localtime(&timestamp));
+        std::cout << std::setw(6) << i + 1 << ". " << std::setw(8) << entry.score << "  " << std::setw(6)
+                  << Engine::valueOf(entry.maxTile) << "  " << std::setw(8) << GameHistory::modeName(entry.mode)
+                  << "  P" << (int)entry.player << "  " << when << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,283 @@
+// 2048-loadgen: tạo tải cho 2048-server qua TCP. Mỗi luồng một epoll với nhiều kết nối,
+// mỗi kết nối chơi một ván (tự chọn nước hợp lệ từ bàn cờ server trả về) và giữ tối đa
+// P yêu cầu đang bay (pipeline). Đo thông lượng và độ trễ từ lúc gửi tới lúc nhận trả lời.
+#include "Engine.h"
+#include "ServerProtocol.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    const int MAX_EVENTS = 256;
+    const size_t MAX_PIPELINE = 256;
+    const size_t IN_BUFFER = 4096;
+    const uint32_t HISTOGRAM_US = 100000;  // bucket 1 µs tới 100 ms, sau đó gộp một bucket
+
+    struct Config {
+        std::string host;
+        std::string port;
+        int connections;
+        int threads;
+        double seconds;
+        int pipeline;
+    };
+
+    struct Client {
+        int fd;
+        Engine::Board board;
+        bool gameOver;
+        Engine::Rng rng;
+        uint32_t inLength;
+        uint32_t inflight;
+        uint32_t sentHead;   // hàng đợi vòng thời điểm gửi, khớp thứ tự trả lời
+        uint64_t sentAt[MAX_PIPELINE];
+        uint8_t in[IN_BUFFER];
+    };
+
+    struct Result {
+        uint64_t moves;
+        uint64_t requests;
+        uint64_t games;
+        uint64_t errors;
+        std::vector<uint64_t> histogram;
+
+        Result() : moves(0), requests(0), games(0), errors(0), histogram(HISTOGRAM_US + 1, 0) {}
+    };
+
+    uint64_t nowNanos() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int connectTo(const Config& config) {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* results = nullptr;
+        if (getaddrinfo(config.host.c_str(), config.port.c_str(), &hints, &results) != 0) return -1;
+        int fd = -1;
+        for (addrinfo* it = results; it && fd < 0; it = it->ai_next) {
+            fd = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+            if (fd >= 0 && connect(fd, it->ai_addr, it->ai_addrlen) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(results);
+        if (fd >= 0) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        return fd;
+    }
+
+    // Nước hợp lệ ngẫu nhiên trên bàn cờ đã biết; với pipeline > 1 bàn cờ có thể đã cũ
+    // nên nước có thể bị server trả về "illegal", vẫn tính là một yêu cầu được phục vụ
+    int chooseMove(Client& client) {
+        int start = client.rng.below(Engine::MOVE_COUNT);
+        for (int i = 0; i < Engine::MOVE_COUNT; i++) {
+            int move = (start + i) % Engine::MOVE_COUNT;
+            if (Engine::move(client.board, move) != client.board) return move;
+        }
+        return start;
+    }
+
+    // Nạp yêu cầu cho tới khi đủ pipeline, gửi một lần
+    bool refill(Client& client, int pipeline) {
+        uint8_t out[MAX_PIPELINE * ServerProtocol::NEW_GAME_SIZE];
+        size_t length = 0;
+        uint64_t now = nowNanos();
+        while (client.inflight < (uint32_t)pipeline) {
+            if (client.gameOver) {
+                ServerProtocol::putNewGame(out + length, client.rng.next() | 1);
+                length += ServerProtocol::NEW_GAME_SIZE;
+                client.gameOver = false;
+                client.board = 0;
+            } else {
+                out[length++] = (uint8_t)chooseMove(client);
+            }
+            client.sentAt[(client.sentHead + client.inflight) % MAX_PIPELINE] = now;
+            client.inflight++;
+        }
+        size_t done = 0;
+        while (done < length) {
+            ssize_t sent = send(client.fd, out + done, length - done, MSG_NOSIGNAL);
+            if (sent <= 0) return false;
+            done += (size_t)sent;
+        }
+        return true;
+    }
+
+    void runThread(const Config& config, int connectionCount, uint64_t seed, Result& result, std::atomic<bool>& failed) {
+        int epollFd = epoll_create1(0);
+        std::vector<Client> clients(connectionCount);
+        for (int c = 0; c < connectionCount; c++) {
+            Client& client = clients[c];
+            client.fd = connectTo(config);
+            if (client.fd < 0) {
+                std::cerr << "Cannot connect to " << config.host << ":" << config.port << std::endl;
+                failed = true;
+                break;
+            }
+            client.rng = Engine::Rng(seed + (uint64_t)c * 0x9E3779B97F4A7C15ULL);
+            client.board = 0;
+            client.gameOver = true;  // yêu cầu đầu tiên là ván mới
+            client.inLength = 0;
+            client.inflight = 0;
+            client.sentHead = 0;
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.u32 = (uint32_t)c;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+        }
+
+        uint64_t deadline = nowNanos() + (uint64_t)(config.seconds * 1e9);
+        if (!failed) {
+            for (int c = 0; c < connectionCount; c++) {
+                if (!refill(clients[c], config.pipeline)) failed = true;
+            }
+        }
+
+        epoll_event events[MAX_EVENTS];
+        while (!failed && nowNanos() < deadline) {
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, 100);
+            for (int i = 0; i < count; i++) {
+                Client& client = clients[events[i].data.u32];
+                ssize_t received = recv(client.fd, client.in + client.inLength, IN_BUFFER - client.inLength, 0);
+                if (received <= 0) {
+                    std::cerr << "Server closed the connection" << std::endl;
+                    failed = true;
+                    break;
+                }
+                client.inLength += (uint32_t)received;
+                uint64_t now = nowNanos();
+                uint32_t position = 0;
+                while (client.inLength - position >= ServerProtocol::RESPONSE_SIZE) {
+                    int status;
+                    uint32_t score;
+                    ServerProtocol::getResponse(client.in + position, status, client.board, score);
+                    position += ServerProtocol::RESPONSE_SIZE;
+
+                    uint64_t micros = (now - client.sentAt[client.sentHead]) / 1000;
+                    result.histogram[std::min<uint64_t>(micros, HISTOGRAM_US)]++;
+                    client.sentHead = (client.sentHead + 1) % MAX_PIPELINE;
+                    client.inflight--;
+                    result.requests++;
+                    if (status == ServerProtocol::STATUS_NEW_GAME) {
+                        result.games++;
+                    } else {
+                        result.moves++;
+                        if (status == ServerProtocol::STATUS_GAME_OVER) client.gameOver = true;
+                        if (status == ServerProtocol::STATUS_NO_GAME) result.errors++;
+                    }
+                }
+                std::memmove(client.in, client.in + position, client.inLength - position);
+                client.inLength -= position;
+                // Ván hết nước: chỉ mở ván mới sau khi mọi nước đang bay đã về
+                if (client.gameOver && client.inflight > 0) continue;
+                if (!refill(client, config.pipeline)) failed = true;
+            }
+        }
+        for (int c = 0; c < connectionCount; c++) {
+            if (clients[c].fd >= 0) close(clients[c].fd);
+        }
+        close(epollFd);
+    }
+
+    uint64_t percentile(const std::vector<uint64_t>& histogram, uint64_t total, double fraction) {
+        uint64_t target = std::min(total - 1, (uint64_t)(total * fraction));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < histogram.size(); i++) {
+            seen += histogram[i];
+            if (seen > target) return i;
+        }
+        return histogram.size() - 1;
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--host H] [--port P] [--connections C] [--threads T]\n"
+                  << "       [--seconds S] [--pipeline N]\n"
+                  << "Plays C concurrent games against 2048-server and reports moves/s and latency percentiles.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Config config;
+    config.host = "127.0.0.1";
+    config.port = std::to_string(ServerProtocol::DEFAULT_PORT);
+    config.connections = 64;
+    config.threads = 1;
+    config.seconds = 5.0;
+    config.pipeline = 1;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--host") == 0 && hasValue) {
+            config.host = argv[++i];
+        } else if (std::strcmp(argv[i], "--port") == 0 && hasValue) {
+            config.port = argv[++i];
+        } else if (std::strcmp(argv[i], "--connections") == 0 && hasValue) {
+            config.connections = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            config.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && hasValue) {
+            config.seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--pipeline") == 0 && hasValue) {
+            config.pipeline = std::max(1, std::min((int)MAX_PIPELINE, std::atoi(argv[++i])));
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    config.threads = std::min(config.threads, config.connections);
+
+    std::atomic<bool> failed(false);
+    std::vector<Result> results(config.threads);
+    std::vector<std::thread> workers;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int t = 0; t < config.threads; t++) {
+        int count = config.connections / config.threads + (t < config.connections % config.threads ? 1 : 0);
+        workers.push_back(std::thread(runThread, std::cref(config), count, (uint64_t)(t + 1) << 32,
+                                      std::ref(results[t]), std::ref(failed)));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (failed) return 1;
+
+    Result total;
+    for (int t = 0; t < config.threads; t++) {
+        total.moves += results[t].moves;
+        total.requests += results[t].requests;
+        total.games += results[t].games;
+        total.errors += results[t].errors;
+        for (size_t i = 0; i < total.histogram.size(); i++) total.histogram[i] += results[t].histogram[i];
+    }
+
+    std::cout << config.connections << " connections, " << config.threads << " threads, pipeline " << config.pipeline
+              << ", " << std::fixed << std::setprecision(2) << elapsed << " s" << std::endl;
+    std::cout << "moves " << total.moves << " (" << (uint64_t)(total.moves / elapsed) << "/s), games " << total.games
+              << ", errors " << total.errors << std::endl;
+    std::cout << "latency us: p50 " << percentile(total.histogram, total.requests, 0.50)
+              << "  p90 " << percentile(total.histogram, total.requests, 0.90)
+              << "  p99 " << percentile(total.histogram, total.requests, 0.99)
+              << "  p99.9 " << percentile(total.histogram, total.requests, 0.999)
+              << "  max " << percentile(total.histogram, total.requests, 1.0) << std::endl;
+    return total.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// 2048-pack: dựng assets.pack. --scan PATH tìm mọi chuỗi "assets/..." trong file mã
+// nguồn PATH (hoặc mọi .cpp/.h dưới thư mục PATH). Makefile truyền đúng các file được
+// biên dịch vào game, nên file nguồn không được build (Sound.cpp...) không kéo asset
+// vào pack; file còn lại trong assets/ được liệt kê là không dùng. Có thể thêm file
+// bằng tay sau các tuỳ chọn.
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--out FILE] [--scan PATH]... [--check] [ASSET...]\n"
+                  << "Bundles every assets/... path referenced by the source file PATH (or the .cpp/.h files\n"
+                  << "under directory PATH), plus ASSET files, into FILE (default assets.pack) and lists the\n"
+                  << "assets/ files left out. --check only verifies FILE.\n";
+    }
+
+    bool hasSuffix(const std::string& text, const char* suffix) {
+        size_t length = std::strlen(suffix);
+        return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+    }
+
+    // Gọi visit cho mọi file thường dưới dir (đệ quy)
+    template <typename Visit>
+    void walk(const std::string& dir, Visit visit) {
+        DIR* handle = opendir(dir.c_str());
+        if (!handle) return;
+        while (dirent* item = readdir(handle)) {
+            std::string name = item->d_name;
+            if (name == "." || name == "..") continue;
+            std::string path = dir + "/" + name;
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0) continue;
+            if (S_ISDIR(info.st_mode)) {
+                walk(path, visit);
+            } else if (S_ISREG(info.st_mode)) {
+                visit(path, (uint64_t)info.st_size);
+            }
+        }
+        closedir(handle);
+    }
+
+    bool scanFile(const std::string& path, std::set<std::string>& assets) {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot read " << path << std::endl;
+            return false;
+        }
+        std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        for (size_t at = text.find("\"assets/"); at != std::string::npos; at = text.find("\"assets/", at + 1)) {
+            size_t end = text.find_first_of("\"\n", at + 1);
+            if (end != std::string::npos && text[end] == '"') assets.insert(text.substr(at + 1, end - at - 1));
+        }
+        return true;
+    }
+
+    bool scanSources(const std::string& path, std::set<std::string>& assets) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            std::cerr << "Cannot read " << path << std::endl;
+            return false;
+        }
+        if (!S_ISDIR(info.st_mode)) return scanFile(path, assets);
+        bool ok = true;
+        walk(path, [&](const std::string& file, uint64_t) {
+            if (hasSuffix(file, ".cpp") || hasSuffix(file, ".h")) ok = scanFile(file, assets) && ok;
+        });
+        return ok;
+    }
+
+    bool check(const std::string& path) {
+        AssetPack pack;
+        if (!pack.map(path)) {
+            std::cerr << "Cannot read asset pack " << path << std::endl;
+            return false;
+        }
+        bool ok = true;
+        for (size_t i = 0; i < pack.size(); i++) {
+            const AssetPack::Entry& entry = pack.at(i);
+            size_t bytes = 0;
+            const void* data = pack.find(entry.name, bytes);
+            std::ifstream in(entry.name, std::ios::binary);
+            std::string original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            bool same = data && in && bytes == original.size() && std::memcmp(data, original.data(), bytes) == 0;
+            std::cout << "  " << entry.name << "  " << entry.size << " bytes" << (same ? "" : "  (differs from file)") << "\n";
+            ok = ok && same;
+        }
+        if (!ok) std::cerr << path << " does not match the asset files" << std::endl;
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string out = "assets.pack";
+    std::set<std::string> assets;
+    bool scanned = false;
+    bool checkOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            out = argv[++i];
+        } else if (std::strcmp(argv[i], "--scan") == 0 && hasValue) {
+            if (!scanSources(argv[++i], assets)) return 1;
+            scanned = true;
+        } else if (std::strcmp(argv[i], "--check") == 0) {
+            checkOnly = true;
+        } else if (argv[i][0] != '-') {
+            assets.insert(argv[i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!checkOnly) {
+        if (assets.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!AssetPack::write(out, std::vector<std::string>(assets.begin(), assets.end()))) return 1;
+
+        uint64_t unusedBytes = 0;
+        int unusedCount = 0;
+        if (scanned) {
+            std::vector<std::string> unused;
+            walk("assets", [&](const std::string& path, uint64_t bytes) {
+                if (assets.count(path) == 0) {
+                    unused.push_back(path);
+                    unusedBytes += bytes;
+                }
+            });
+            std::sort(unused.begin(), unused.end());
+            for (size_t i = 0; i < unused.size(); i++) std::cout << "  unused " << unused[i] << "\n";
+            unusedCount = (int)unused.size();
+        }
+        struct stat info;
+        stat(out.c_str(), &info);
+        std::cout << "Packed " << assets.size() << " assets into " << out << " (" << (long long)info.st_size << " bytes), "
+                  << unusedCount << " unused files (" << unusedBytes << " bytes) left out" << std::endl;
+    }
+    return check(out) ? 0 : 1;
+}
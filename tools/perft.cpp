@@ -0,0 +1,195 @@
+// 2048-perft: liệt kê mọi vị trí đạt được tới độ sâu D (4 nước đi x mọi ô mới 2/4),
+// đếm số node (số đường đi) và số vị trí khác nhau, dùng để kiểm tra và đo tốc độ Engine.
+#include "Engine.h"
+#include "EngineSimd.h"
+#include "PositionTable.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Shard {
+        std::mutex mutex;
+        PositionTable table;
+    };
+
+    const size_t FLUSH_SIZE = 1024;
+
+    struct LayerResult {
+        uint64_t nodes;
+        uint64_t generated;
+    };
+
+    void flush(Shard& shard, std::vector<PositionTable::Entry>& buffer) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t i = 0; i < buffer.size(); i++) {
+            shard.table.add(buffer[i].board, buffer[i].value);
+        }
+        buffer.clear();
+    }
+
+    // Mở rộng parents[begin, end) và gom con vào các shard theo hash
+    void expand(const std::vector<PositionTable::Entry>& parents, size_t begin, size_t end,
+                std::vector<Shard>& shards, uint64_t& generated) {
+        size_t shardMask = shards.size() - 1;
+        std::vector<std::vector<PositionTable::Entry> > buffers(shards.size());
+        uint64_t localGenerated = 0;
+
+        const int moves[Engine::MOVE_COUNT] = {Engine::MOVE_LEFT, Engine::MOVE_RIGHT, Engine::MOVE_UP, Engine::MOVE_DOWN};
+        for (size_t p = begin; p < end; p++) {
+            Engine::Board parent = parents[p].board;
+            uint64_t paths = parents[p].value;
+            // Cả 4 nước đi một lượt qua kernel đang chọn (AVX2 xử lý 2 bàn cờ mỗi lần)
+            Engine::Board sources[Engine::MOVE_COUNT] = {parent, parent, parent, parent};
+            Engine::Board results[Engine::MOVE_COUNT];
+            int scores[Engine::MOVE_COUNT];
+            EngineSimd::moveMany(sources, moves, results, scores, Engine::MOVE_COUNT);
+            for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+                Engine::Board moved = results[m];
+                if (moved == parent) continue;
+                for (int i = 0; i < Engine::CELL_COUNT; i++) {
+                    if (Engine::getCell(moved, i) != 0) continue;
+                    for (int exponent = 1; exponent <= 2; exponent++) {
+                        Engine::Board child = Engine::setCell(moved, i, exponent);
+                        size_t s = PositionTable::hash(child) >> 40 & shardMask;
+                        PositionTable::Entry entry = {child, paths};
+                        buffers[s].push_back(entry);
+                        if (buffers[s].size() >= FLUSH_SIZE) flush(shards[s], buffers[s]);
+                        localGenerated++;
+                    }
+                }
+            }
+        }
+        for (size_t s = 0; s < shards.size(); s++) {
+            if (!buffers[s].empty()) flush(shards[s], buffers[s]);
+        }
+        generated = localGenerated;
+    }
+
+    LayerResult nextLayer(std::vector<PositionTable::Entry>& layer, int threadCount) {
+        size_t shardCount = 1;
+        while (shardCount < (size_t)threadCount * 16) shardCount <<= 1;
+        std::vector<Shard> shards(shardCount);
+
+        std::vector<uint64_t> generated(threadCount, 0);
+        std::vector<std::thread> workers;
+        size_t chunk = (layer.size() + threadCount - 1) / threadCount;
+        for (int t = 0; t < threadCount; t++) {
+            size_t begin = std::min(layer.size(), t * chunk);
+            size_t end = std::min(layer.size(), begin + chunk);
+            workers.push_back(std::thread(expand, std::cref(layer), begin, end, std::ref(shards), std::ref(generated[t])));
+        }
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+
+        LayerResult result = {0, 0};
+        for (int t = 0; t < threadCount; t++) {
+            result.generated += generated[t];
+        }
+        std::vector<PositionTable::Entry> next;
+        for (size_t s = 0; s < shards.size(); s++) {
+            shards[s].table.appendTo(next);
+            shards[s].table.clear();
+        }
+        for (size_t i = 0; i < next.size(); i++) {
+            result.nodes += next[i].value;
+        }
+        layer.swap(next);
+        return result;
+    }
+
+    bool parseBoard(const char* text, Engine::Board& board) {
+        std::stringstream stream(text);
+        std::string item;
+        std::vector<std::vector<int> > grid(4, std::vector<int>(4, 0));
+        int index = 0;
+        while (std::getline(stream, item, ',')) {
+            if (index >= Engine::CELL_COUNT) return false;
+            int value = std::atoi(item.c_str());
+            if (value != 0 && (value < 2 || (value & (value - 1)) != 0)) return false;
+            grid[index / 4][index % 4] = value;
+            index++;
+        }
+        if (index != Engine::CELL_COUNT) return false;
+        board = Engine::fromGrid(grid);
+        return board != 0;
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--position start|mid | --board v0,v1,...,v15] [--depth D] [--threads N]\n"
+                  << "       [--kernel scalar|ssse3|avx2]\n"
+                  << "Board values are tile values in row-major order (0 = empty).\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // Vị trí cố định để công bố số node làm chuẩn so sánh
+    const char* startPosition = "0,0,0,0,0,2,0,0,0,0,0,0,0,0,2,0";
+    const char* midPosition = "2,4,8,16,0,2,4,8,0,0,2,4,0,0,0,2";
+    const char* boardText = startPosition;
+    int depth = 4;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--position") == 0 && hasValue) {
+            const char* name = argv[++i];
+            if (std::strcmp(name, "start") == 0) {
+                boardText = startPosition;
+            } else if (std::strcmp(name, "mid") == 0) {
+                boardText = midPosition;
+            } else {
+                std::cerr << "Unknown position: " << name << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--board") == 0 && hasValue) {
+            boardText = argv[++i];
+        } else if (std::strcmp(argv[i], "--depth") == 0 && hasValue) {
+            depth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--kernel") == 0 && hasValue) {
+            EngineSimd::Kernel kernel;
+            if (!EngineSimd::parseKernel(argv[++i], kernel) || !EngineSimd::setKernel(kernel)) {
+                std::cerr << "Kernel not available: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Engine::Board start;
+    if (!parseBoard(boardText, start)) {
+        std::cerr << "Invalid board: " << boardText << std::endl;
+        return 1;
+    }
+
+    std::cout << "perft from " << boardText << " with " << threadCount << " threads, "
+              << EngineSimd::kernelName(EngineSimd::activeKernel()) << " kernel" << std::endl;
+    std::cout << std::setw(5) << "depth" << std::setw(20) << "nodes" << std::setw(14) << "distinct"
+              << std::setw(16) << "generated" << std::setw(10) << "seconds" << std::setw(12) << "Mnodes/s" << std::endl;
+
+    std::vector<PositionTable::Entry> layer;
+    PositionTable::Entry root = {start, 1};
+    layer.push_back(root);
+    for (int d = 1; d <= depth && !layer.empty(); d++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        LayerResult result = nextLayer(layer, threadCount);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << std::setw(5) << d << std::setw(20) << result.nodes << std::setw(14) << layer.size()
+                  << std::setw(16) << result.generated << std::setw(10) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(12) << std::setprecision(2) << (seconds > 0 ? result.generated / seconds / 1e6 : 0.0)
+                  << std::endl;
+    }
+    return 0;
+}
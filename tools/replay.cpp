@@ -0,0 +1,84 @@
+// 2048-replay: xem thông tin replay, in bàn cờ tại một nước và đo tốc độ nhảy tới nước bất kỳ.
+#include "Replay.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+    void printBoard(Engine::Board board) {
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) {
+                std::cout << std::setw(6) << Engine::valueOf(Engine::getCell(board, r * 4 + c));
+            }
+            std::cout << '\n';
+        }
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " FILE [--at MOVE] [--bench SEEKS]\n"
+                  << "Prints the replay header, the board after MOVE moves, or the average random seek time.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = nullptr;
+    long at = -1;
+    int seeks = 0;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--at") == 0 && hasValue) {
+            at = std::atol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--bench") == 0 && hasValue) {
+            seeks = std::atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!path) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Replay::Reader replay;
+    if (!replay.load(path)) return 1;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    long bytes = (long)file.tellg();
+    std::cout << path << ": " << replay.moveCount() << " moves, " << replay.overrideCount() << " spawn overrides, score "
+              << replay.finalScore() << ", seed " << replay.seed() << ", " << bytes << " bytes ("
+              << std::fixed << std::setprecision(2) << (replay.moveCount() ? bytes * 8.0 / replay.moveCount() : 0.0)
+              << " bits/move), keyframe every " << replay.keyframeInterval() << " moves" << std::endl;
+
+    if (at >= 0) {
+        Engine::Board board;
+        int score;
+        if (!replay.stateAt((uint32_t)at, board, score)) {
+            std::cerr << "Move " << at << " is out of range" << std::endl;
+            return 1;
+        }
+        std::cout << "after " << at << " moves (score " << score << ", next move "
+                  << Engine::moveName(replay.moveAt((uint32_t)at)) << "):\n";
+        printBoard(board);
+    }
+
+    if (seeks > 0) {
+        Engine::Rng rng(1);
+        uint64_t checksum = 0;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < seeks; i++) {
+            Engine::Board board;
+            int score;
+            replay.stateAt((uint32_t)rng.below((int)replay.moveCount() + 1), board, score);
+            checksum += board;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << seeks << " random seeks: " << std::setprecision(2) << seconds * 1e6 / seeks << " us each (checksum "
+                  << std::hex << checksum << std::dec << ")" << std::endl;
+    }
+    return 0;
+}
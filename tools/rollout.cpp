@@ -0,0 +1,67 @@
+// 2048-rollout: đo khả năng mở rộng của RolloutAdvisor theo số luồng trên một bàn cờ cố định.
+#include "RolloutAdvisor.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--threads N] [--playouts P] [--budget-ms MS] [--policy random|greedy]\n"
+                  << "Runs one advisor decision with 1, 2, 4, ... N threads and reports playouts/s.\n"
+                  << "With --budget-ms the decision is time-boxed instead of a fixed playout count.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads <= 0) maxThreads = 1;
+    RolloutAdvisor::Config config;
+    config.playoutsPerMove = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            maxThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--playouts") == 0 && hasValue) {
+            config.playoutsPerMove = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--budget-ms") == 0 && hasValue) {
+            config.budgetMs = std::atof(argv[++i]);
+            config.playoutsPerMove = 0;
+        } else if (std::strcmp(argv[i], "--policy") == 0 && hasValue) {
+            if (!RolloutAdvisor::parsePolicy(argv[++i], config.policy)) {
+                std::cerr << "Unknown policy: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Bàn cờ giữa ván để playout có độ dài điển hình
+    Engine::Board board = 0;
+    const int cells[16] = {1, 2, 3, 4, 0, 1, 2, 3, 0, 0, 1, 2, 0, 0, 0, 1};
+    for (int i = 0; i < Engine::CELL_COUNT; i++) board = Engine::setCell(board, i, cells[i]);
+
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "move" << std::setw(12) << "playouts"
+              << std::setw(10) << "ms" << std::setw(14) << "playouts/s" << std::setw(10) << "speedup" << std::endl;
+    double baseRate = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        config.threads = threads;
+        RolloutAdvisor advisor(config);
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        int move = advisor.chooseMove(board);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        double rate = seconds > 0 ? advisor.lastPlayouts() / seconds : 0.0;
+        if (threads == 1) baseRate = rate;
+        std::cout << std::setw(8) << threads << std::setw(8) << Engine::moveName(move) << std::setw(12) << advisor.lastPlayouts()
+                  << std::setw(10) << std::fixed << std::setprecision(1) << seconds * 1000.0
+                  << std::setw(14) << std::setprecision(0) << rate
+                  << std::setw(10) << std::setprecision(2) << (baseRate > 0 ? rate / baseRate : 0.0) << std::endl;
+        if (threads == maxThreads) break;
+    }
+    return 0;
+}
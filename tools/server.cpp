@@ -0,0 +1,407 @@
+// 2048-server: phục vụ hàng nghìn ván 2048 cùng lúc qua TCP cho các cuộc thi bot
+// (giao thức nhị phân trong ServerProtocol.h, luật của Engine giống moveTiles/addNewTile/canMove).
+// Mỗi nhân một luồng với epoll và socket lắng nghe riêng (SO_REUSEPORT: kernel chia kết nối
+// cho các luồng), nên ván của một kết nối chỉ sống trên luồng đã nhận nó và không cần khoá.
+// Trạng thái ván (bàn cờ nén, RNG, điểm) cùng bộ đệm vào/ra cố định nằm trong pool của luồng;
+// trả lời được ghi thẳng vào bộ đệm ra của kết nối và send từ đó, không cấp phát mỗi yêu cầu.
+#include "Engine.h"
+#include "ServerProtocol.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    const int MAX_EVENTS = 256;
+    const int EPOLL_TIMEOUT_MS = 100;
+    const uint32_t LISTEN_INDEX = 0xFFFFFFFF;
+    const uint32_t NO_SLOT = 0xFFFFFFFF;
+    const size_t IN_BUFFER = 512;
+    const size_t OUT_BUFFER = 4096;   // ~315 trả lời đang chờ gửi mỗi kết nối
+
+    std::atomic<bool> stopRequested(false);
+
+    void onSignal(int) {
+        stopRequested = true;
+    }
+
+    struct Connection {
+        int fd;
+        uint32_t nextFree;
+        bool hasGame;
+        bool gameOver;
+        bool writing;         // đang chờ EPOLLOUT, tạm ngừng đọc
+        Engine::Board board;
+        Engine::Rng rng;
+        uint32_t score;
+        uint32_t inLength;
+        uint32_t outStart;
+        uint32_t outEnd;
+        uint8_t in[IN_BUFFER];
+        uint8_t out[OUT_BUFFER];
+    };
+
+    struct ShardStats {
+        std::atomic<uint64_t> moves;
+        std::atomic<uint64_t> games;
+        std::atomic<uint32_t> sessions;
+        std::atomic<uint32_t> peakSessions;
+
+        ShardStats() : moves(0), games(0), sessions(0), peakSessions(0) {}
+    };
+
+    // Một luồng, một epoll, một pool kết nối
+    class Shard {
+    public:
+        Shard(int shardIndex, int listenFd, size_t maxSessions, ShardStats& shardStats)
+            : index(shardIndex), listener(listenFd), epollFd(-1), limit(maxSessions), freeHead(NO_SLOT), stats(shardStats),
+              seeds((uint64_t)std::chrono::steady_clock::now().time_since_epoch().count() ^ ((uint64_t)shardIndex << 48)) {}
+
+        void run() {
+            epollFd = epoll_create1(0);
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.u32 = LISTEN_INDEX;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, listener, &event);
+
+            epoll_event events[MAX_EVENTS];
+            while (!stopRequested) {
+                int count = epoll_wait(epollFd, events, MAX_EVENTS, EPOLL_TIMEOUT_MS);
+                for (int i = 0; i < count; i++) {
+                    uint32_t slot = events[i].data.u32;
+                    if (slot == LISTEN_INDEX) {
+                        acceptAll();
+                    } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                        closeConnection(slot);
+                    } else if (events[i].events & EPOLLOUT) {
+                        onWritable(slot);
+                    } else {
+                        onReadable(slot);
+                    }
+                }
+            }
+            for (uint32_t slot = 0; slot < pool.size(); slot++) {
+                if (pool[slot].fd >= 0) closeConnection(slot);
+            }
+            ::close(epollFd);
+            ::close(listener);
+        }
+
+    private:
+        int index;
+        int listener;
+        int epollFd;
+        size_t limit;
+        uint32_t freeHead;
+        ShardStats& stats;
+        Engine::Rng seeds;
+        std::vector<Connection> pool;
+
+        void acceptAll() {
+            for (;;) {
+                int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK);
+                if (fd < 0) return;  // EAGAIN: đã nhận hết
+                uint32_t slot = freeHead;
+                if (slot != NO_SLOT) {
+                    freeHead = pool[slot].nextFree;
+                } else if (pool.size() < limit) {
+                    // Pool chỉ lớn lên lúc nhận kết nối, không bao giờ trong lúc phục vụ
+                    slot = (uint32_t)pool.size();
+                    pool.push_back(Connection());
+                } else {
+                    ::close(fd);
+                    continue;
+                }
+                int noDelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                Connection& connection = pool[slot];
+                connection.fd = fd;
+                connection.hasGame = false;
+                connection.gameOver = false;
+                connection.writing = false;
+                connection.board = 0;
+                connection.score = 0;
+                connection.inLength = 0;
+                connection.outStart = 0;
+                connection.outEnd = 0;
+
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.u32 = slot;
+                epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+                uint32_t sessions = ++stats.sessions;
+                if (sessions > stats.peakSessions) stats.peakSessions = sessions;
+            }
+        }
+
+        void closeConnection(uint32_t slot) {
+            Connection& connection = pool[slot];
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, NULL);
+            ::close(connection.fd);
+            connection.fd = -1;
+            connection.nextFree = freeHead;
+            freeHead = slot;
+            stats.sessions--;
+        }
+
+        void setWriting(Connection& connection, uint32_t slot, bool writing) {
+            if (connection.writing == writing) return;
+            connection.writing = writing;
+            epoll_event event;
+            event.events = writing ? EPOLLOUT : EPOLLIN;
+            event.data.u32 = slot;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        }
+
+        void newGame(Connection& connection, uint64_t seed) {
+            connection.rng = Engine::Rng(seed != 0 ? seed : seeds.next());
+            Engine::Board board = Engine::spawnRandom(0, connection.rng);
+            connection.board = Engine::spawnRandom(board, connection.rng);
+            connection.score = 0;
+            connection.hasGame = true;
+            connection.gameOver = false;
+            stats.games.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        int applyMove(Connection& connection, int move) {
+            if (!connection.hasGame) return ServerProtocol::STATUS_NO_GAME;
+            if (connection.gameOver) return ServerProtocol::STATUS_GAME_OVER;
+            int scoreDelta = 0;
+            Engine::Board moved = Engine::move(connection.board, move, scoreDelta);
+            if (moved == connection.board) return ServerProtocol::STATUS_ILLEGAL;
+            connection.board = Engine::spawnRandom(moved, connection.rng);
+            connection.score += (uint32_t)scoreDelta;
+            if (!Engine::canMove(connection.board)) {
+                connection.gameOver = true;
+                return ServerProtocol::STATUS_GAME_OVER;
+            }
+            return ServerProtocol::STATUS_MOVED;
+        }
+
+        // Xử lý mọi yêu cầu hoàn chỉnh trong bộ đệm vào, trả lời ghi thẳng vào bộ đệm ra.
+        // Dừng khi bộ đệm ra đầy (phần còn lại chờ tới khi gửi bớt). false = lỗi giao thức
+        bool process(Connection& connection) {
+            uint32_t position = 0;
+            uint64_t moves = 0;
+            while (position < connection.inLength) {
+                if (connection.outEnd + ServerProtocol::RESPONSE_SIZE > OUT_BUFFER) {
+                    if (connection.outStart == 0) break;
+                    std::memmove(connection.out, connection.out + connection.outStart, connection.outEnd - connection.outStart);
+                    connection.outEnd -= connection.outStart;
+                    connection.outStart = 0;
+                    continue;
+                }
+                uint8_t tag = connection.in[position];
+                int status;
+                if (tag <= ServerProtocol::REQUEST_MOVE_LAST) {
+                    status = applyMove(connection, tag);
+                    position++;
+                    moves++;
+                } else if (tag == ServerProtocol::REQUEST_NEW_GAME) {
+                    if (connection.inLength - position < ServerProtocol::NEW_GAME_SIZE) break;
+                    newGame(connection, ServerProtocol::getSeed(connection.in + position));
+                    status = ServerProtocol::STATUS_NEW_GAME;
+                    position += ServerProtocol::NEW_GAME_SIZE;
+                } else {
+                    return false;
+                }
+                ServerProtocol::putResponse(connection.out + connection.outEnd, status, connection.board, connection.score);
+                connection.outEnd += ServerProtocol::RESPONSE_SIZE;
+            }
+            if (position > 0) {
+                std::memmove(connection.in, connection.in + position, connection.inLength - position);
+                connection.inLength -= position;
+            }
+            stats.moves.fetch_add(moves, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Gửi phần đang chờ; false khi kết nối hỏng
+        bool flush(Connection& connection, uint32_t slot) {
+            while (connection.outStart < connection.outEnd) {
+                ssize_t sent = send(connection.fd, connection.out + connection.outStart,
+                                    connection.outEnd - connection.outStart, MSG_NOSIGNAL);
+                if (sent < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        setWriting(connection, slot, true);
+                        return true;
+                    }
+                    return false;
+                }
+                connection.outStart += (uint32_t)sent;
+            }
+            connection.outStart = 0;
+            connection.outEnd = 0;
+            setWriting(connection, slot, false);
+            return true;
+        }
+
+        // Xử lý và gửi cho tới khi hết yêu cầu hoàn chỉnh hoặc phải chờ socket gửi bớt:
+        // process() dừng khi bộ đệm ra đầy, nên sau mỗi lần flush hết phải xử lý tiếp
+        bool serve(Connection& connection, uint32_t slot) {
+            while (connection.inLength > 0 && !connection.writing) {
+                uint32_t before = connection.inLength;
+                if (!process(connection) || !flush(connection, slot)) return false;
+                if (connection.inLength == before) break;  // chỉ còn yêu cầu chưa nhận đủ
+            }
+            return true;
+        }
+
+        void onReadable(uint32_t slot) {
+            Connection& connection = pool[slot];
+            if (connection.inLength < IN_BUFFER) {
+                ssize_t received = recv(connection.fd, connection.in + connection.inLength, IN_BUFFER - connection.inLength, 0);
+                if (received <= 0) {
+                    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+                    closeConnection(slot);
+                    return;
+                }
+                connection.inLength += (uint32_t)received;
+            }
+            if (!serve(connection, slot)) closeConnection(slot);
+        }
+
+        void onWritable(uint32_t slot) {
+            Connection& connection = pool[slot];
+            // Gửi hết rồi thì xử lý tiếp các yêu cầu bị dừng vì bộ đệm ra đầy
+            if (!flush(connection, slot) || !serve(connection, slot)) closeConnection(slot);
+        }
+    };
+
+    int openListener(int port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0) return -1;
+        int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons((uint16_t)port);
+        if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void runShard(Shard* shard, int core, bool pin) {
+        if (pin) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(core, &cpus);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+        shard->run();
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--port P] [--threads N] [--max-sessions N] [--seconds S] [--report S]\n"
+                  << "       [--no-pin]\n"
+                  << "Serves 2048 games over TCP, one epoll loop per thread (default: one per core).\n"
+                  << "Protocol: see src/ServerProtocol.h. Stop with Ctrl+C or --seconds.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int port = ServerProtocol::DEFAULT_PORT;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    size_t maxSessions = 65536;
+    int seconds = 0;
+    int reportSeconds = 0;
+    bool pin = true;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--port") == 0 && hasValue) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-sessions") == 0 && hasValue) {
+            maxSessions = (size_t)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && hasValue) {
+            seconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--report") == 0 && hasValue) {
+            reportSeconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-pin") == 0) {
+            pin = false;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Mỗi luồng một socket lắng nghe cùng cổng, giới hạn phiên chia đều cho các luồng
+    int cores = (int)std::thread::hardware_concurrency();
+    size_t perShard = (maxSessions + threadCount - 1) / threadCount;
+    std::vector<ShardStats> stats(threadCount);
+    std::vector<Shard*> shards;
+    for (int t = 0; t < threadCount; t++) {
+        int listener = openListener(port);
+        if (listener < 0) {
+            std::cerr << "Cannot listen on port " << port << ": " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        shards.push_back(new Shard(t, listener, perShard, stats[t]));
+    }
+    std::cout << "2048-server on port " << port << " with " << threadCount << " epoll threads" << std::endl;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread(runShard, shards[t], cores > 0 ? t % cores : 0, pin && threadCount <= cores));
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point nextReport = start + std::chrono::seconds(reportSeconds);
+    uint64_t lastMoves = 0;
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (seconds > 0 && now - start >= std::chrono::seconds(seconds)) stopRequested = true;
+        if (reportSeconds > 0 && now >= nextReport) {
+            uint64_t moves = 0;
+            uint32_t sessions = 0;
+            for (int t = 0; t < threadCount; t++) {
+                moves += stats[t].moves;
+                sessions += stats[t].sessions;
+            }
+            std::cout << "moves/s " << (moves - lastMoves) / reportSeconds << "  sessions " << sessions << std::endl;
+            lastMoves = moves;
+            nextReport += std::chrono::seconds(reportSeconds);
+        }
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+        delete shards[t];
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(6) << "thread" << std::setw(14) << "moves" << std::setw(12) << "moves/s"
+              << std::setw(10) << "games" << std::setw(10) << "peak" << std::endl;
+    for (int t = 0; t < threadCount; t++) {
+        std::cout << std::setw(6) << t << std::setw(14) << stats[t].moves.load()
+                  << std::setw(12) << (uint64_t)(stats[t].moves.load() / elapsed)
+                  << std::setw(10) << stats[t].games.load() << std::setw(10) << stats[t].peakSessions.load() << std::endl;
+    }
+    return 0;
+}
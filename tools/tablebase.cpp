@@ -0,0 +1,99 @@
+// 2048-tablebase: giải chính xác bàn cờ nhỏ và tra cứu tablebase đã giải.
+#include "Tablebase.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " --solve [--size 3|4] [--cap TILE] [--threads N] [--out FILE]\n"
+                  << "       " << program << " --query v0,v1,... [--out FILE]\n"
+                  << "Solves every reachable position of a size x size board where tiles stop merging at TILE,\n"
+                  << "storing the exact expected remaining score under optimal play (default 3x3, cap 256).\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool solve = false;
+    const char* queryText = nullptr;
+    int size = 3;
+    int capTile = 256;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    std::string path;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--solve") == 0) {
+            solve = true;
+        } else if (std::strcmp(argv[i], "--query") == 0 && hasValue) {
+            queryText = argv[++i];
+        } else if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+            size = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--cap") == 0 && hasValue) {
+            capTile = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            path = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (capTile < 4 || (capTile & (capTile - 1)) != 0) {
+        std::cerr << "Cap must be a power of two >= 4" << std::endl;
+        return 1;
+    }
+    if (path.empty()) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "tablebase-%dx%d-%d.tb", size, size, capTile);
+        path = name;
+    }
+
+    if (solve) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        if (!Tablebase::solve(size, Engine::exponentOf(capTile), threadCount, path, std::cout)) return 1;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "Wrote " << path << " in " << std::fixed << std::setprecision(1) << seconds << " s" << std::endl;
+        return 0;
+    }
+    if (!queryText) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Tablebase tablebase;
+    if (!tablebase.map(path)) {
+        std::cerr << "Cannot map " << path << std::endl;
+        return 1;
+    }
+    Engine::Board board = 0;
+    int index = 0;
+    for (const char* p = queryText; p && *p; index++) {
+        if (index >= tablebase.size() * tablebase.size()) {
+            std::cerr << "Too many cells for a " << tablebase.size() << "x" << tablebase.size() << " board" << std::endl;
+            return 1;
+        }
+        board = Engine::setCell(board, index, Engine::exponentOf(std::atoi(p)));
+        p = std::strchr(p, ',');
+        if (p) p++;
+    }
+    float value;
+    if (!tablebase.value(board, value)) {
+        std::cout << "position is not reachable" << std::endl;
+        return 1;
+    }
+    double expectations[Engine::MOVE_COUNT];
+    int best = tablebase.bestMove(board, expectations);
+    std::cout << "value " << value << ", best move " << Engine::moveName(best) << std::endl;
+    for (int m = 0; m < Engine::MOVE_COUNT; m++) {
+        if (expectations[m] >= 0) std::cout << "  " << Engine::moveName(m) << ": " << expectations[m] << std::endl;
+    }
+    std::cout << "(" << tablebase.positions() << " positions, expected score from the start "
+              << tablebase.startExpectation() << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,333 @@
+// 2048-tournament: mỗi chiến lược chơi mọi seed trong khoảng cho trước, song song trên
+// mọi nhân, theo luật của Engine (giống moveTiles/addNewTile). Ván với cùng seed luôn
+// nhận cùng chuỗi ô mới nên kết quả tất định với mọi số luồng.
+#include "OpeningBook.h"
+#include "Replay.h"
+#include "Strategies.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    struct GameResult {
+        int score;
+        int maxTile;
+        int moves;
+        double milliseconds;
+    };
+
+    struct Job {
+        size_t strategy;
+        uint64_t seed;
+    };
+
+    GameResult playGame(Advisor& advisor, uint64_t seed, Replay::Writer* replay) {
+        GameResult result = {0, 0, 0, 0.0};
+        // RNG ô mới chỉ phụ thuộc seed, tách biệt với RNG của advisor
+        Engine::Rng rng(seed);
+        Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+        if (replay) replay->begin(seed, board, rng.state, 0);
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        while (true) {
+            int move = advisor.chooseMove(board);
+            if (move < 0) break;
+            int delta = 0;
+            Engine::Board moved = Engine::move(board, move, delta);
+            if (moved == board) break;  // Advisor lỗi: tránh lặp vô hạn
+            result.score += delta;
+            result.moves++;
+            board = Engine::spawnRandom(moved, rng);
+            if (replay) replay->addMove(move, board);
+        }
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        result.maxTile = Engine::valueOf(Engine::maxExponent(board));
+        return result;
+    }
+
+    void runWorker(const std::vector<std::string>& strategies, const std::vector<Job>& jobs, const NTupleNetwork* network,
+                   const OpeningBook* book, const std::string& replayDir, std::atomic<size_t>& nextJob,
+                   std::vector<GameResult>& results, std::atomic<size_t>& replayFailures) {
+        Replay::Writer writer;
+        size_t index;
+        while ((index = nextJob.fetch_add(1)) < jobs.size()) {
+            const Job& job = jobs[index];
+            std::string error;
+            // Advisor mới cho mỗi ván (advisor giữ trạng thái như cache) để kết quả
+            // không phụ thuộc ván nào đã chạy trước trên cùng luồng
+            Advisor* advisor = Strategies::create(strategies[job.strategy], network, job.seed, error);
+            if (book->isReady()) advisor = new BookAdvisor(*book, advisor);
+            results[index] = playGame(*advisor, job.seed, replayDir.empty() ? nullptr : &writer);
+            delete advisor;
+            if (!replayDir.empty()) {
+                // Tên file: chiến lược (':' đổi thành '_') và seed
+                std::string name = strategies[job.strategy];
+                std::replace(name.begin(), name.end(), ':', '_');
+                if (!writer.save(replayDir + "/" + name + "-" + std::to_string(job.seed) + ".rpl")) replayFailures++;
+            }
+        }
+    }
+
+    double percentile(std::vector<int> values, double fraction) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        size_t rank = (size_t)(fraction * (values.size() - 1) + 0.5);
+        return values[rank];
+    }
+
+    struct Summary {
+        std::string strategy;
+        size_t games;
+        double meanScore;
+        double p10;
+        double p50;
+        double p90;
+        double p99;
+        int maxScore;
+        double meanMoves;
+        double msPerMove;
+        int tileCounts[Engine::MAX_EXPONENT + 1];
+    };
+
+    Summary summarize(const std::string& strategy, const std::vector<GameResult>& games) {
+        Summary summary;
+        summary.strategy = strategy;
+        summary.games = games.size();
+        std::vector<int> scores;
+        double scoreSum = 0.0;
+        double moveSum = 0.0;
+        double msSum = 0.0;
+        summary.maxScore = 0;
+        for (int i = 0; i <= Engine::MAX_EXPONENT; i++) summary.tileCounts[i] = 0;
+        for (size_t i = 0; i < games.size(); i++) {
+            scores.push_back(games[i].score);
+            scoreSum += games[i].score;
+            moveSum += games[i].moves;
+            msSum += games[i].milliseconds;
+            summary.maxScore = std::max(summary.maxScore, games[i].score);
+            summary.tileCounts[Engine::exponentOf(games[i].maxTile)]++;
+        }
+        size_t count = std::max<size_t>(1, games.size());
+        summary.meanScore = scoreSum / count;
+        summary.p10 = percentile(scores, 0.10);
+        summary.p50 = percentile(scores, 0.50);
+        summary.p90 = percentile(scores, 0.90);
+        summary.p99 = percentile(scores, 0.99);
+        summary.meanMoves = moveSum / count;
+        summary.msPerMove = moveSum > 0 ? msSum / moveSum : 0.0;
+        return summary;
+    }
+
+    bool parseSeeds(const char* text, uint64_t& first, uint64_t& last) {
+        char* end = nullptr;
+        first = std::strtoull(text, &end, 10);
+        if (end == text) return false;
+        if (*end == '\0') {
+            last = first;
+            return true;
+        }
+        if (*end != '-') return false;
+        const char* rest = end + 1;
+        last = std::strtoull(rest, &end, 10);
+        return end != rest && *end == '\0' && last >= first;
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " --strategies S1,S2,... [--seeds FIRST-LAST] [--threads N]\n"
+                  << "       [--weights FILE] [--book FILE] [--csv FILE] [--json FILE] [--replays DIR]\n"
+                  << "Strategies: greedy, corner, ntuple, expectimax:D, expectimax-ntuple:D, rollout:P, rollout-greedy:P\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> strategies;
+    uint64_t firstSeed = 1;
+    uint64_t lastSeed = 100;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    std::string weightsPath;
+    std::string bookPath;
+    std::string csvPath;
+    std::string jsonPath;
+    std::string replayDir;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--strategies") == 0 && hasValue) {
+            std::stringstream stream(argv[++i]);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                if (!item.empty()) strategies.push_back(item);
+            }
+        } else if (std::strcmp(argv[i], "--seeds") == 0 && hasValue) {
+            if (!parseSeeds(argv[++i], firstSeed, lastSeed)) {
+                std::cerr << "Invalid seed range: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--weights") == 0 && hasValue) {
+            weightsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--book") == 0 && hasValue) {
+            bookPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--csv") == 0 && hasValue) {
+            csvPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replays") == 0 && hasValue) {
+            replayDir = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (strategies.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    NTupleNetwork network;
+    if (!weightsPath.empty() && !network.map(weightsPath)) {
+        std::cerr << "Cannot load n-tuple weights from " << weightsPath << std::endl;
+        return 1;
+    }
+    OpeningBook book;
+    if (!bookPath.empty() && !book.map(bookPath)) {
+        std::cerr << "Cannot load opening book from " << bookPath << std::endl;
+        return 1;
+    }
+    for (size_t s = 0; s < strategies.size(); s++) {
+        std::string error;
+        Advisor* probe = Strategies::create(strategies[s], &network, 0, error);
+        if (!probe) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        delete probe;
+    }
+
+    if (!replayDir.empty()) {
+        // Thư mục đã có thì dùng luôn; báo lỗi trước khi chơi thay vì hỏng từng file sau đó
+        if (mkdir(replayDir.c_str(), 0755) != 0 && errno != EEXIST) {
+            std::cerr << "Cannot create replay directory " << replayDir << ": " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        struct stat info;
+        if (stat(replayDir.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+            std::cerr << replayDir << " is not a directory" << std::endl;
+            return 1;
+        }
+        if (access(replayDir.c_str(), W_OK) != 0) {
+            std::cerr << "Replay directory " << replayDir << " is not writable" << std::endl;
+            return 1;
+        }
+    }
+
+    // Xếp job xen kẽ chiến lược để mọi chiến lược tiến triển đều
+    std::vector<Job> jobs;
+    for (uint64_t seed = firstSeed; seed <= lastSeed; seed++) {
+        for (size_t s = 0; s < strategies.size(); s++) {
+            Job job = {s, seed};
+            jobs.push_back(job);
+        }
+    }
+    std::vector<GameResult> results(jobs.size());
+    std::atomic<size_t> nextJob(0);
+    std::atomic<size_t> replayFailures(0);
+
+    std::cout << "Playing " << jobs.size() << " games (" << strategies.size() << " strategies x "
+              << (lastSeed - firstSeed + 1) << " seeds) on " << threadCount << " threads" << std::endl;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread(runWorker, std::cref(strategies), std::cref(jobs), &network, &book,
+                                      std::cref(replayDir), std::ref(nextJob), std::ref(results),
+                                      std::ref(replayFailures)));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<Summary> summaries;
+    for (size_t s = 0; s < strategies.size(); s++) {
+        std::vector<GameResult> games;
+        for (size_t j = 0; j < jobs.size(); j++) {
+            if (jobs[j].strategy == s) games.push_back(results[j]);
+        }
+        summaries.push_back(summarize(strategies[s], games));
+    }
+
+    std::cout << std::left << std::setw(22) << "strategy" << std::right << std::setw(10) << "mean" << std::setw(9) << "p10"
+              << std::setw(9) << "p50" << std::setw(9) << "p90" << std::setw(8) << "moves" << std::setw(10) << "ms/move"
+              << std::setw(8) << ">=2048" << std::endl;
+    for (size_t s = 0; s < summaries.size(); s++) {
+        const Summary& summary = summaries[s];
+        int reached = 0;
+        for (int e = 11; e <= Engine::MAX_EXPONENT; e++) reached += summary.tileCounts[e];
+        std::cout << std::left << std::setw(22) << summary.strategy << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << summary.meanScore << std::setw(9) << summary.p10 << std::setw(9) << summary.p50
+                  << std::setw(9) << summary.p90 << std::setw(8) << summary.meanMoves << std::setw(10) << std::setprecision(3)
+                  << summary.msPerMove << std::setw(7) << std::setprecision(1) << 100.0 * reached / std::max<size_t>(1, summary.games)
+                  << "%" << std::endl;
+    }
+    std::cout << "Total " << std::setprecision(2) << seconds << " s" << std::endl;
+
+    if (!csvPath.empty()) {
+        std::ofstream csv(csvPath.c_str());
+        if (!csv) {
+            std::cerr << "Cannot write " << csvPath << std::endl;
+            return 1;
+        }
+        csv << "strategy,seed,score,max_tile,moves,ms_per_move\n";
+        for (size_t j = 0; j < jobs.size(); j++) {
+            const GameResult& game = results[j];
+            csv << strategies[jobs[j].strategy] << ',' << jobs[j].seed << ',' << game.score << ',' << game.maxTile << ','
+                << game.moves << ',' << std::setprecision(4) << (game.moves > 0 ? game.milliseconds / game.moves : 0.0) << '\n';
+        }
+        std::cout << "Per-game results written to " << csvPath << std::endl;
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream json(jsonPath.c_str());
+        if (!json) {
+            std::cerr << "Cannot write " << jsonPath << std::endl;
+            return 1;
+        }
+        // Tên chiến lược đã qua Strategies::isKnown (tên cố định, có thể thêm :N) nên không cần escape
+        json << std::fixed << "{\n  \"seeds\": [" << firstSeed << ", " << lastSeed << "],\n  \"strategies\": [\n";
+        for (size_t s = 0; s < summaries.size(); s++) {
+            const Summary& summary = summaries[s];
+            json << std::setprecision(1) << "    {\"name\": \"" << summary.strategy << "\", \"games\": " << summary.games
+                 << ", \"mean_score\": " << summary.meanScore << ", \"p10\": " << summary.p10 << ", \"p50\": " << summary.p50
+                 << ", \"p90\": " << summary.p90 << ", \"p99\": " << summary.p99 << ", \"max_score\": " << summary.maxScore
+                 << ", \"mean_moves\": " << summary.meanMoves << std::setprecision(4) << ", \"ms_per_move\": " << summary.msPerMove
+                 << ", \"max_tile\": {";
+            bool first = true;
+            for (int e = 0; e <= Engine::MAX_EXPONENT; e++) {
+                if (summary.tileCounts[e] == 0) continue;
+                json << (first ? "" : ", ") << '"' << Engine::valueOf(e) << "\": " << summary.tileCounts[e];
+                first = false;
+            }
+            json << "}}" << (s + 1 < summaries.size() ? "," : "") << "\n";
+        }
+        json << "  ]\n}\n";
+        std::cout << "Summary written to " << jsonPath << std::endl;
+    }
+    if (replayFailures > 0) {
+        std::cerr << replayFailures << " of " << jobs.size() << " replays could not be written to " << replayDir
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+// 2048-train: huấn luyện mạng n-tuple bằng TD(0) trên afterstate qua self-play.
+// Các luồng cập nhật chung một bảng trọng số không khoá (Hogwild); luồng chính
+// in tiến độ và định kỳ ghi checkpoint mà game mmap khi khởi động.
+#include "NTuple.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Progress {
+        std::atomic<uint64_t> gamesStarted;
+        std::atomic<uint64_t> gamesFinished;
+        std::atomic<uint64_t> scoreSum;
+        std::atomic<uint64_t> reached2048;
+        std::atomic<uint64_t> moves;
+    };
+
+    struct TrainConfig {
+        uint64_t games;
+        float alpha;
+        uint64_t seed;
+    };
+
+    void trainWorker(NTupleNetwork& network, const TrainConfig& config, int worker, Progress& progress) {
+        Engine::Rng rng(config.seed + (uint64_t)worker * 0x9E3779B97F4A7C15ULL);
+        // Chia learning rate cho số feature để bước cập nhật không phụ thuộc kích thước mạng
+        float step = config.alpha / network.featureCount();
+        while (progress.gamesStarted.fetch_add(1) < config.games) {
+            Engine::Board board = Engine::spawnRandom(Engine::spawnRandom(0, rng), rng);
+            Engine::Board previous = 0;
+            float previousValue = 0.0f;
+            uint64_t score = 0;
+            uint64_t moves = 0;
+            while (true) {
+                Engine::Board afterstate = 0;
+                int reward = 0;
+                float value = 0.0f;
+                if (network.greedyMove(board, afterstate, reward, value) < 0) {
+                    // Trạng thái cuối có giá trị 0
+                    if (previous) network.update(previous, step * (0.0f - previousValue));
+                    break;
+                }
+                if (previous) network.update(previous, step * (reward + value - previousValue));
+                previous = afterstate;
+                previousValue = value;
+                score += reward;
+                moves++;
+                board = Engine::spawnRandom(afterstate, rng);
+            }
+            progress.scoreSum += score;
+            progress.moves += moves;
+            if (Engine::maxExponent(board) >= 11) progress.reached2048++;
+            progress.gamesFinished++;
+        }
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [--games N] [--threads T] [--alpha A] [--preset 4x4|4x6]\n"
+                  << "       [--out FILE] [--resume] [--checkpoint-seconds S] [--seed X]\n"
+                  << "Trains n-tuple weights by afterstate TD(0) self-play and writes FILE (default ntuple.weights).\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TrainConfig config;
+    config.games = 100000;
+    config.alpha = 0.1f;
+    config.seed = 2048;
+    int threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    NTupleNetwork::Preset preset = NTupleNetwork::PRESET_4X4;
+    std::string outPath = "ntuple.weights";
+    bool resume = false;
+    int checkpointSeconds = 60;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) {
+            config.games = std::strtoull(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--alpha") == 0 && hasValue) {
+            config.alpha = (float)std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--preset") == 0 && hasValue) {
+            if (!NTupleNetwork::parsePreset(argv[++i], preset)) {
+                std::cerr << "Unknown preset: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--resume") == 0) {
+            resume = true;
+        } else if (std::strcmp(argv[i], "--checkpoint-seconds") == 0 && hasValue) {
+            checkpointSeconds = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            config.seed = std::strtoull(argv[++i], NULL, 10);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    NTupleNetwork network;
+    if (resume) {
+        if (!network.load(outPath)) return 1;
+        std::cout << "Resuming " << NTupleNetwork::presetName(network.preset()) << " weights from " << outPath << std::endl;
+    } else {
+        network.init(preset);
+    }
+
+    Progress progress;
+    progress.gamesStarted = 0;
+    progress.gamesFinished = 0;
+    progress.scoreSum = 0;
+    progress.reached2048 = 0;
+    progress.moves = 0;
+
+    std::cout << "Training " << NTupleNetwork::presetName(network.preset()) << " network ("
+              << network.weightCount() * sizeof(float) / (1024 * 1024) << " MB) on " << threadCount << " threads" << std::endl;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread(trainWorker, std::ref(network), std::cref(config), t, std::ref(progress)));
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point lastCheckpoint = begin;
+    uint64_t reportedGames = 0;
+    uint64_t reportedScore = 0;
+    uint64_t reported2048 = 0;
+    while (progress.gamesFinished < config.games) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        uint64_t games = progress.gamesFinished;
+        uint64_t scoreSum = progress.scoreSum;
+        uint64_t wins = progress.reached2048;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - begin).count();
+        if (games > reportedGames) {
+            // Số liệu của các ván xong từ lần in trước
+            uint64_t window = games - reportedGames;
+            std::cout << std::setw(10) << games << " games  mean score " << std::setw(8) << std::fixed << std::setprecision(0)
+                      << (double)(scoreSum - reportedScore) / window << "  2048 rate " << std::setprecision(3)
+                      << (double)(wins - reported2048) / window << "  " << std::setprecision(0)
+                      << progress.moves / seconds << " moves/s" << std::endl;
+            reportedGames = games;
+            reportedScore = scoreSum;
+            reported2048 = wins;
+        }
+        if (std::chrono::duration<double>(now - lastCheckpoint).count() >= checkpointSeconds) {
+            if (network.save(outPath)) std::cout << "Checkpoint written to " << outPath << std::endl;
+            lastCheckpoint = now;
+        }
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    if (!network.save(outPath)) return 1;
+    std::cout << "Weights written to " << outPath << std::endl;
+    return 0;
+}